@@ -41,5 +41,6 @@ using ::std::underflow_error;
 }  // namespace thunder
 
 #include "thunder/exception/contiguity_error.hpp"
+#include "thunder/exception/io_error.hpp"
 
 #endif  // THUNDER_EXCEPTION_EXCEPTION_HPP_
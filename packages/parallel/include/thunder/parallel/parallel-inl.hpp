@@ -0,0 +1,52 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_PARALLEL_PARALLEL_INL_HPP_
+#define THUNDER_PARALLEL_PARALLEL_INL_HPP_
+
+#include "thunder/parallel/parallel.hpp"
+
+#include <cstddef>
+
+namespace thunder {
+namespace parallel {
+
+template < typename F >
+void forEachBlock(::std::size_t n, ::std::size_t k, const F &f) {
+  if (k <= 1) {
+    f(0, 0, n);
+    return;
+  }
+  run(k, [n, k, &f](::std::size_t b) {
+      f(b, blockBegin(n, k, b), blockBegin(n, k, b + 1));
+    });
+}
+
+template < typename F >
+void forRange(::std::size_t n, ::std::size_t grain, const F &f) {
+  forEachBlock(n, blocks(n, grain),
+               [&f](::std::size_t, ::std::size_t begin, ::std::size_t end) {
+                 f(begin, end);
+               });
+}
+
+}  // namespace parallel
+}  // namespace thunder
+
+#endif  // THUNDER_PARALLEL_PARALLEL_INL_HPP_
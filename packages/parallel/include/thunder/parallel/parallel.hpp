@@ -0,0 +1,56 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_PARALLEL_PARALLEL_HPP_
+#define THUNDER_PARALLEL_PARALLEL_HPP_
+
+#include <cstddef>
+#include <functional>
+
+namespace thunder {
+namespace parallel {
+
+// Get the number of threads used by parallel routines
+::std::size_t threads();
+// Set the number of threads. Zero resets to hardware concurrency.
+void setThreads(::std::size_t n);
+
+// Number of blocks to split n items into, each having at least grain items
+::std::size_t blocks(::std::size_t n, ::std::size_t grain);
+// Starting item of block b when n items are split into k blocks
+::std::size_t blockBegin(::std::size_t n, ::std::size_t k, ::std::size_t b);
+
+// Run f(0), ..., f(k - 1) concurrently and wait for all of them. Blocks run on
+// the calling thread and on a pool of threads() - 1 workers that persist
+// across calls. The first exception thrown is rethrown. Calls from inside a
+// worker run serially.
+void run(::std::size_t k, const ::std::function< void(::std::size_t) > &f);
+
+// Split n items into k blocks and call f(b, begin, end) for each block b
+template < typename F >
+void forEachBlock(::std::size_t n, ::std::size_t k, const F &f);
+
+// Split n items into blocks of at least grain items and call f(begin, end)
+template < typename F >
+void forRange(::std::size_t n, ::std::size_t grain, const F &f);
+
+}  // namespace parallel
+}  // namespace thunder
+
+#endif  // THUNDER_PARALLEL_PARALLEL_HPP_
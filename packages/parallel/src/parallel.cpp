@@ -0,0 +1,176 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/parallel/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace thunder {
+namespace parallel {
+
+namespace {
+
+::std::atomic< ::std::size_t > threads_(0);
+thread_local bool in_worker_ = false;
+
+// Workers persist across calls and take blocks of the queued jobs in order.
+// The calling thread takes blocks of its own job too, so that a job finishes
+// even if every worker is busy with others.
+class Pool {
+ public:
+  // Never destroyed, so that workers blocked at exit are not joined
+  static Pool& instance() {
+    static Pool *pool = new Pool();
+    return *pool;
+  }
+
+  void run(::std::size_t k, const ::std::function< void(::std::size_t) > &f) {
+    Job job(k, f);
+    ::std::unique_lock< ::std::mutex > lock(mutex_);
+    for (::std::size_t n = ::std::min(k, threads()); workers_ + 1 < n;
+         ++workers_) {
+      ::std::thread(&Pool::work, this).detach();
+    }
+    jobs_.push_back(&job);
+    wake_.notify_all();
+    while (job.next < job.k) {
+      ::std::size_t b = take(&job);
+      execute(&job, b, &lock);
+    }
+    finished_.wait(lock, [&job]() { return job.done == job.k; });
+    if (job.error != nullptr) {
+      ::std::rethrow_exception(job.error);
+    }
+  }
+
+ private:
+  struct Job {
+    Job(::std::size_t blocks, const ::std::function< void(::std::size_t) > &f)
+        : k(blocks), f(f), next(0), done(0) {}
+
+    ::std::size_t k;
+    const ::std::function< void(::std::size_t) > &f;
+    ::std::size_t next;
+    ::std::size_t done;
+    ::std::exception_ptr error;
+  };
+
+  Pool() : workers_(0) {}
+
+  void work() {
+    in_worker_ = true;
+    ::std::unique_lock< ::std::mutex > lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [this]() { return !jobs_.empty(); });
+      Job *job = jobs_.front();
+      ::std::size_t b = take(job);
+      execute(job, b, &lock);
+    }
+  }
+
+  // Claim the next block of job, dequeuing it once all blocks are claimed
+  ::std::size_t take(Job *job) {
+    ::std::size_t b = job->next++;
+    if (job->next == job->k) {
+      jobs_.erase(::std::find(jobs_.begin(), jobs_.end(), job));
+    }
+    return b;
+  }
+
+  // Run block b of job with the lock released
+  void execute(Job *job, ::std::size_t b,
+               ::std::unique_lock< ::std::mutex > *lock) {
+    lock->unlock();
+    bool in_worker = in_worker_;
+    in_worker_ = true;
+    ::std::exception_ptr error;
+    try {
+      job->f(b);
+    } catch (...) {
+      error = ::std::current_exception();
+    }
+    in_worker_ = in_worker;
+    lock->lock();
+    if (error != nullptr && job->error == nullptr) {
+      job->error = error;
+    }
+    if (++job->done == job->k) {
+      finished_.notify_all();
+    }
+  }
+
+  ::std::mutex mutex_;
+  ::std::condition_variable wake_;
+  ::std::condition_variable finished_;
+  ::std::deque< Job* > jobs_;
+  ::std::size_t workers_;
+};
+
+}  // namespace
+
+::std::size_t threads() {
+  ::std::size_t n = threads_.load();
+  if (n == 0) {
+    n = ::std::thread::hardware_concurrency();
+  }
+  return n == 0 ? 1 : n;
+}
+
+void setThreads(::std::size_t n) {
+  threads_.store(n);
+}
+
+::std::size_t blocks(::std::size_t n, ::std::size_t grain) {
+  if (in_worker_) {
+    return 1;
+  }
+  ::std::size_t k = grain == 0 ? n : n / grain;
+  ::std::size_t t = threads();
+  k = k < t ? k : t;
+  return k == 0 ? 1 : k;
+}
+
+::std::size_t blockBegin(::std::size_t n, ::std::size_t k, ::std::size_t b) {
+  // Split as evenly as possible. Written to avoid overflowing n * b.
+  return (n / k) * b + (n % k) * b / k;
+}
+
+void run(::std::size_t k, const ::std::function< void(::std::size_t) > &f) {
+  if (k == 0) {
+    return;
+  }
+  if (k == 1 || in_worker_) {
+    for (::std::size_t b = 0; b < k; ++b) {
+      f(b);
+    }
+    return;
+  }
+  Pool::instance().run(k, f);
+}
+
+}  // namespace parallel
+}  // namespace thunder
@@ -0,0 +1,120 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/parallel.hpp"
+#include "thunder/parallel/parallel.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "thunder/parallel/parallel-inl.hpp"
+
+namespace thunder {
+namespace parallel {
+namespace {
+
+TEST(ParallelTest, blocksTest) {
+  setThreads(4);
+  EXPECT_EQ(4, threads());
+  EXPECT_EQ(1, blocks(0, 16));
+  EXPECT_EQ(1, blocks(10, 16));
+  EXPECT_EQ(2, blocks(40, 16));
+  EXPECT_EQ(4, blocks(1000, 16));
+
+  // Blocks cover the range without gaps
+  for (::std::size_t n = 0; n < 50; ++n) {
+    for (::std::size_t k = 1; k < 8; ++k) {
+      EXPECT_EQ(0, blockBegin(n, k, 0));
+      EXPECT_EQ(n, blockBegin(n, k, k));
+      for (::std::size_t b = 0; b < k; ++b) {
+        EXPECT_LE(blockBegin(n, k, b), blockBegin(n, k, b + 1));
+      }
+    }
+  }
+  setThreads(0);
+  EXPECT_LE(1, threads());
+}
+
+TEST(ParallelTest, forEachBlockTest) {
+  setThreads(4);
+  ::std::vector< int > visited(1000, 0);
+  ::std::vector< ::std::size_t > sizes(4, 0);
+  forEachBlock(visited.size(), 4, [&](::std::size_t b, ::std::size_t begin,
+                                      ::std::size_t end) {
+      sizes[b] = end - begin;
+      for (::std::size_t i = begin; i < end; ++i) {
+        ++visited[i];
+      }
+    });
+  for (::std::size_t i = 0; i < visited.size(); ++i) {
+    EXPECT_EQ(1, visited[i]);
+  }
+  for (::std::size_t b = 0; b < sizes.size(); ++b) {
+    EXPECT_EQ(250, sizes[b]);
+  }
+
+  // Nested calls run serially inside workers
+  ::std::atomic< ::std::size_t > sum(0);
+  forRange(100, 10, [&](::std::size_t begin, ::std::size_t end) {
+      forRange(end - begin, 1, [&](::std::size_t b, ::std::size_t e) {
+          sum += e - b;
+        });
+    });
+  EXPECT_EQ(100, sum.load());
+  setThreads(0);
+}
+
+TEST(ParallelTest, exceptionTest) {
+  setThreads(4);
+  EXPECT_THROW(run(4, [](::std::size_t b) {
+        if (b == 2) {
+          throw ::std::runtime_error("block 2");
+        }
+      }), ::std::runtime_error);
+  setThreads(0);
+}
+
+TEST(ParallelTest, concurrentTest) {
+  // Callers on several threads share the pool and each waits only for its
+  // own blocks
+  setThreads(4);
+  ::std::atomic< ::std::size_t > sum(0);
+  ::std::vector< ::std::thread > callers;
+  for (int c = 0; c < 4; ++c) {
+    callers.emplace_back([&sum]() {
+        for (int i = 0; i < 100; ++i) {
+          run(4, [&sum](::std::size_t b) { sum += b + 1; });
+        }
+      });
+  }
+  for (::std::thread &caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(4 * 100 * 10, sum.load());
+  setThreads(0);
+}
+
+}  // namespace
+}  // namespace parallel
+}  // namespace thunder
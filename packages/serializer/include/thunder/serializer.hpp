@@ -24,6 +24,8 @@
 #include <sstream>
 
 #include "thunder/serializer/binary_protocol.hpp"
+#include "thunder/serializer/codec.hpp"
+#include "thunder/serializer/raw_stream.hpp"
 #include "thunder/serializer/serializer.hpp"
 #include "thunder/serializer/static.hpp"
 #include "thunder/serializer/text_protocol.hpp"
@@ -37,12 +39,16 @@ template < typename M = ::std::stringstream >
 using BinarySerializer = Serializer< serializer::BinaryProtocol< M > >;
 typedef BinarySerializer< ::std::stringstream > StringBinarySerializer;
 typedef BinarySerializer< ::std::fstream > FileBinarySerializer;
+typedef BinarySerializer< serializer::FdStream > FdBinarySerializer;
+typedef BinarySerializer< serializer::BufferStream > BufferBinarySerializer;
 
 template < typename M = ::std::stringstream >
 using TextSerializer = Serializer< serializer::TextProtocol< M > >;
 typedef TextSerializer< ::std::stringstream > StringTextSerializer;
 typedef TextSerializer< ::std::fstream > FileTextSerializer;
 
+using serializer::Codec;
+
 }  // namespace thunder
 
 namespace thunder {
@@ -50,11 +56,15 @@ namespace serializer {
 
 extern template class BinaryProtocol< ::std::stringstream >;
 extern template class BinaryProtocol< ::std::fstream >;
+extern template class BinaryProtocol< FdStream >;
+extern template class BinaryProtocol< BufferStream >;
 extern template class TextProtocol< ::std::stringstream >;
 extern template class TextProtocol< ::std::fstream >;
 
 extern template class Serializer< BinaryProtocol< ::std::stringstream > >;
 extern template class Serializer< BinaryProtocol< ::std::fstream > >;
+extern template class Serializer< BinaryProtocol< FdStream > >;
+extern template class Serializer< BinaryProtocol< BufferStream > >;
 extern template class Serializer< TextProtocol< ::std::stringstream > >;
 extern template class Serializer< TextProtocol< ::std::fstream > >;
 
@@ -88,6 +98,31 @@ THUNDER_SERIALIZER_INSTANTIATE_FSTREAM_CONSTRUCTOR(
 
 #undef THUNDER_SERIALIZER_INSTANTIATE_FSTREAM_CONSTRUCTOR
 
+#define THUNDER_SERIALIZER_INSTANTIATE_FDSTREAM_CONSTRUCTOR(P)          \
+  extern template Serializer< P >::Serializer();                        \
+  extern template Serializer< P >::Serializer(int fd);                  \
+  extern template Serializer< P >::Serializer(::std::string path);      \
+  extern template Serializer< P >::Serializer(                          \
+      ::std::string path, ::std::ios_base::openmode mode);              \
+  extern template Serializer< P >::Serializer(                          \
+      ::std::string path, ::std::ios_base::openmode mode, bool direct);
+
+THUNDER_SERIALIZER_INSTANTIATE_FDSTREAM_CONSTRUCTOR(BinaryProtocol< FdStream >);
+
+#undef THUNDER_SERIALIZER_INSTANTIATE_FDSTREAM_CONSTRUCTOR
+
+#define THUNDER_SERIALIZER_INSTANTIATE_BUFFERSTREAM_CONSTRUCTOR(P)      \
+  extern template Serializer< P >::Serializer();                        \
+  extern template Serializer< P >::Serializer(                          \
+      char *data, ::std::size_t capacity);                              \
+  extern template Serializer< P >::Serializer(                          \
+      const char *data, ::std::size_t size);
+
+THUNDER_SERIALIZER_INSTANTIATE_BUFFERSTREAM_CONSTRUCTOR(
+    BinaryProtocol< BufferStream >);
+
+#undef THUNDER_SERIALIZER_INSTANTIATE_BUFFERSTREAM_CONSTRUCTOR
+
 }  // namespace serializer
 }  // namespace thunder
 
@@ -22,11 +22,16 @@
 
 #include "thunder/serializer/binary_protocol.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <iomanip>
 #include <ios>
 #include <limits>
+#include <type_traits>
 
+#include "thunder/exception.hpp"
+#include "thunder/serializer/codec.hpp"
 #include "thunder/serializer/serializer.hpp"
 #include "thunder/serializer/static.hpp"
 
@@ -35,7 +40,8 @@ namespace serializer {
 
 template < typename M >
 template < typename... G >
-BinaryProtocol< M >::BinaryProtocol(G... g) : stream_(g...) {}
+BinaryProtocol< M >::BinaryProtocol(G... g)
+    : stream_(g...), codec_(Codec::kNone) {}
 
 template < typename M >
 const typename BinaryProtocol< M >::stream_type&
@@ -111,6 +117,188 @@ THUNDER_SERIALIZER_BINARY_PROTOCOL_DEFINE(long double);
 
 #undef THUNDER_SERIALIZER_BINARY_PROTOCOL_DEFINE
 
+// First byte of an array header, for plain and compressed arrays
+const unsigned char binary_array_magic = 0xA7;
+const unsigned char binary_compressed_magic = 0xA8;
+// Byte order flags in array headers
+const unsigned char binary_little_endian = 1;
+const unsigned char binary_big_endian = 2;
+// Bytes per stream call for bulk arrays
+const ::std::size_t binary_array_chunk = static_cast< ::std::size_t >(1) << 24;
+
+inline unsigned char binaryByteOrder() {
+  const unsigned short probe = 1;
+  return *reinterpret_cast< const unsigned char* >(&probe) == 1 ?
+      binary_little_endian : binary_big_endian;
+}
+
+// Whether four bytes starting with a magic byte can be an array header, that
+// is they hold a component size, a byte order and a component count
+template < typename C >
+bool isBinaryArrayHeader(const C *header) {
+  unsigned char size = static_cast< unsigned char >(header[1]);
+  unsigned char order = static_cast< unsigned char >(header[2]);
+  unsigned char components = static_cast< unsigned char >(header[3]);
+  return (size == 1 || size == 2 || size == 4 || size == 8 || size == 10 ||
+          size == 12 || size == 16) &&
+      (order == binary_little_endian || order == binary_big_endian) &&
+      (components == 1 || components == 2);
+}
+
+template < typename M >
+Codec BinaryProtocol< M >::codec() const {
+  return codec_;
+}
+
+template < typename M >
+void BinaryProtocol< M >::setCodec(Codec codec) {
+  codec_ = codec;
+}
+
+template < typename M >
+template < typename S, typename T >
+void BinaryProtocol< M >::saveArray(S *s, const T *t, ::std::size_t n) {
+  saveArray(s, t, n, ::std::integral_constant< bool, BulkTraits< T >::value &&
+            sizeof(char_type) == 1 >());
+}
+
+template < typename M >
+template < typename S, typename T >
+void BinaryProtocol< M >::loadArray(S *s, T *t, ::std::size_t n) {
+  loadArray(s, t, n, ::std::integral_constant< bool, BulkTraits< T >::value &&
+            sizeof(char_type) == 1 >());
+}
+
+template < typename M >
+template < typename S, typename T >
+void BinaryProtocol< M >::saveArray(
+    S *, const T *t, ::std::size_t n, ::std::true_type) {
+  typedef typename BulkTraits< T >::component_type component_type;
+  // Empty arrays are written as nothing, as they were before the header
+  if (n == 0) {
+    return;
+  }
+  const char_type *data = reinterpret_cast< const char_type* >(t);
+  ::std::size_t bytes = n * sizeof(T);
+  bool compressed = codec_ != Codec::kNone && bytes >= kCodecMinimumSize;
+  const char_type header[4] = {
+    static_cast< char_type >(
+        compressed ? binary_compressed_magic : binary_array_magic),
+    static_cast< char_type >(sizeof(component_type)),
+    static_cast< char_type >(binaryByteOrder()),
+    static_cast< char_type >(BulkTraits< T >::components)};
+  stream_.write(header, 4);
+
+  if (compressed) {
+    const char_type codec = static_cast< char_type >(codec_);
+    stream_.write(&codec, 1);
+    compressBlocks(
+        codec_, data, bytes, sizeof(component_type),
+        [this](const char *block, ::std::size_t m) {
+          stream_.write(block, static_cast< ::std::streamsize >(m));
+        });
+    return;
+  }
+  for (::std::size_t i = 0; i < bytes; i += binary_array_chunk) {
+    stream_.write(data + i, static_cast< ::std::streamsize >(
+        ::std::min(binary_array_chunk, bytes - i)));
+  }
+}
+
+template < typename M >
+template < typename S, typename T >
+void BinaryProtocol< M >::saveArray(
+    S *s, const T *t, ::std::size_t n, ::std::false_type) {
+  for (::std::size_t i = 0; i < n; ++i) {
+    s->save(t[i]);
+  }
+}
+
+template < typename M >
+template < typename S, typename T >
+void BinaryProtocol< M >::loadArray(
+    S *, T *t, ::std::size_t n, ::std::true_type) {
+  typedef typename BulkTraits< T >::component_type component_type;
+  if (n == 0) {
+    return;
+  }
+  char_type *data = reinterpret_cast< char_type* >(t);
+  ::std::size_t bytes = n * sizeof(T);
+
+  // Archives written before the array header hold the elements one after
+  // another in native byte order. They are told apart by bytes that cannot
+  // form a header, which are then the start of the data.
+  char_type header[4];
+  ::std::size_t consumed = 1;
+  stream_.read(header, 1);
+  unsigned char magic = static_cast< unsigned char >(header[0]);
+  bool legacy = magic != binary_array_magic &&
+      magic != binary_compressed_magic;
+  if (!legacy && bytes >= 4) {
+    stream_.read(header + 1, 3);
+    consumed = 4;
+    legacy = !isBinaryArrayHeader(header);
+  }
+  if (!stream_) {
+    throw io_error("Array is truncated.");
+  }
+  if (legacy) {
+    ::std::memcpy(data, header, consumed);
+    for (::std::size_t i = consumed; i < bytes; i += binary_array_chunk) {
+      stream_.read(data + i, static_cast< ::std::streamsize >(
+          ::std::min(binary_array_chunk, bytes - i)));
+    }
+    return;
+  }
+  if (consumed == 1) {
+    stream_.read(header + 1, 3);
+  }
+  if (!stream_ ||
+      static_cast< unsigned char >(header[1]) != sizeof(component_type) ||
+      static_cast< unsigned char >(header[3]) != BulkTraits< T >::components) {
+    throw io_error("Array header does not match the element type.");
+  }
+  unsigned char order = static_cast< unsigned char >(header[2]);
+  if (order != binary_little_endian && order != binary_big_endian) {
+    throw io_error("Array header has an unknown byte order.");
+  }
+
+  if (magic == binary_compressed_magic) {
+    char_type codec = 0;
+    stream_.read(&codec, 1);
+    if (!stream_) {
+      throw io_error("Compressed array is truncated.");
+    }
+    decompressBlocks(
+        static_cast< Codec >(codec), data, bytes, sizeof(component_type),
+        [this](char *block, ::std::size_t m) {
+          stream_.read(block, static_cast< ::std::streamsize >(m));
+          return static_cast< bool >(stream_);
+        });
+  } else {
+    for (::std::size_t i = 0; i < bytes; i += binary_array_chunk) {
+      stream_.read(data + i, static_cast< ::std::streamsize >(
+          ::std::min(binary_array_chunk, bytes - i)));
+    }
+  }
+
+  if (order != binaryByteOrder()) {
+    unsigned char *component = reinterpret_cast< unsigned char* >(t);
+    for (::std::size_t i = 0; i < bytes; i += sizeof(component_type)) {
+      ::std::reverse(component + i, component + i + sizeof(component_type));
+    }
+  }
+}
+
+template < typename M >
+template < typename S, typename T >
+void BinaryProtocol< M >::loadArray(
+    S *s, T *t, ::std::size_t n, ::std::false_type) {
+  for (::std::size_t i = 0; i < n; ++i) {
+    s->load(&t[i]);
+  }
+}
+
 }  // namespace serializer
 }  // namespace thunder
 
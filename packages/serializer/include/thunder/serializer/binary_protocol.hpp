@@ -20,11 +20,31 @@
 #ifndef THUNDER_SERIALIZER_BINARY_PROTOCOL_HPP_
 #define THUNDER_SERIALIZER_BINARY_PROTOCOL_HPP_
 
+#include <complex>
+#include <cstddef>
 #include <sstream>
+#include <type_traits>
+
+#include "thunder/serializer/codec.hpp"
 
 namespace thunder {
 namespace serializer {
 
+// Arrays of arithmetic or complex elements are written as raw bytes
+template < typename T >
+struct BulkTraits {
+  static const bool value = ::std::is_arithmetic< T >::value;
+  typedef T component_type;
+  static const unsigned char components = 1;
+};
+
+template < typename T >
+struct BulkTraits< ::std::complex< T > > {
+  static const bool value = ::std::is_arithmetic< T >::value;
+  typedef T component_type;
+  static const unsigned char components = 2;
+};
+
 template < typename M = ::std::stringstream >
 class BinaryProtocol {
  public:
@@ -121,8 +141,34 @@ class BinaryProtocol {
   template < typename S >
   void load(S *s, long double *t);
 
+  // Array serialization. Arithmetic and complex elements are written in bulk
+  // after a header of element size and byte order, and loading swaps bytes
+  // written on a machine of the other byte order. Empty arrays and other
+  // elements are saved one by one with no header. Loading also accepts bulk
+  // arrays written before the header existed, as raw native-order elements.
+  //
+  // Bulk arrays of at least kCodecMinimumSize bytes are compressed with the
+  // codec set here. The header marks compressed arrays and their codec, so
+  // loading needs no setting and each array may use a different codec.
+  Codec codec() const;
+  void setCodec(Codec codec);
+  template < typename S, typename T >
+  void saveArray(S *s, const T *t, ::std::size_t n);
+  template < typename S, typename T >
+  void loadArray(S *s, T *t, ::std::size_t n);
+
  private:
+  template < typename S, typename T >
+  void saveArray(S *s, const T *t, ::std::size_t n, ::std::true_type);
+  template < typename S, typename T >
+  void saveArray(S *s, const T *t, ::std::size_t n, ::std::false_type);
+  template < typename S, typename T >
+  void loadArray(S *s, T *t, ::std::size_t n, ::std::true_type);
+  template < typename S, typename T >
+  void loadArray(S *s, T *t, ::std::size_t n, ::std::false_type);
+
   stream_type stream_;
+  Codec codec_;
 };
 
 }  // namespace serializer
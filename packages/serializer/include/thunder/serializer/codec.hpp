@@ -0,0 +1,79 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_SERIALIZER_CODEC_HPP_
+#define THUNDER_SERIALIZER_CODEC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace thunder {
+namespace serializer {
+
+// Compression of bulk arrays. Arrays are cut into blocks that are compressed
+// and decompressed in parallel, each stored with a checksum of its bytes.
+// Shuffling groups the bytes of the elements by significance before
+// compression, which makes runs out of the exponents and high bytes of
+// floating point data.
+enum class Codec : unsigned char {
+  kNone = 0,
+  kLz = 1,
+  kShuffleLz = 2
+};
+
+// Bytes of array data per block
+const ::std::size_t kCodecBlockSize = static_cast< ::std::size_t >(1) << 20;
+// Arrays smaller than this are not worth compressing
+const ::std::size_t kCodecMinimumSize = 4096;
+
+// Write the blocks of bytes of data, made of elements width bytes wide,
+// through write. A block is a 4-byte little endian length, whose top bit
+// marks blocks stored uncompressed, a 4-byte checksum and the payload.
+void compressBlocks(
+    Codec codec, const char *data, ::std::size_t bytes, ::std::size_t width,
+    const ::std::function< void(const char*, ::std::size_t) > &write);
+// Read blocks written by compressBlocks through read, which returns false if
+// fewer bytes are available. Throws io_error on corrupt data.
+void decompressBlocks(
+    Codec codec, char *data, ::std::size_t bytes, ::std::size_t width,
+    const ::std::function< bool(char*, ::std::size_t) > &read);
+
+// Byte shuffle of n elements width bytes wide. Byte j of element i moves to
+// position j * n + i.
+void shuffleBytes(const char *in, ::std::size_t n, ::std::size_t width,
+                  char *out);
+void unshuffleBytes(const char *in, ::std::size_t n, ::std::size_t width,
+                    char *out);
+
+// LZ block compression. The output of compressBlock needs
+// compressBound(n) bytes, and its size is returned. decompressBlock returns
+// false unless the input decodes to exactly n bytes.
+::std::size_t compressBound(::std::size_t n);
+::std::size_t compressBlock(const char *in, ::std::size_t n, char *out);
+bool decompressBlock(const char *in, ::std::size_t m, char *out,
+                     ::std::size_t n);
+
+// CRC-32C of n bytes
+::std::uint32_t checksum(const char *data, ::std::size_t n);
+
+}  // namespace serializer
+}  // namespace thunder
+
+#endif  // THUNDER_SERIALIZER_CODEC_HPP_
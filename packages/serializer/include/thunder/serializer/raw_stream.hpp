@@ -0,0 +1,197 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_SERIALIZER_RAW_STREAM_HPP_
+#define THUNDER_SERIALIZER_RAW_STREAM_HPP_
+
+#include <cstddef>
+#include <ios>
+#include <string>
+#include <vector>
+
+#include "thunder/serializer/binary_protocol.hpp"
+
+namespace thunder {
+namespace serializer {
+
+// Streams for BinaryProtocol that bypass iostreams. They provide the subset
+// of the iostream interface that protocols and serializers use: unformatted
+// read and write, positioning and state.
+
+// File descriptor stream with a user-space buffer. Regular files are
+// accessed with pread and pwrite at a tracked offset and share one position
+// for reading and writing, as file streams do. Pipes and sockets are read
+// and written sequentially, and cannot seek.
+class FdStream {
+ public:
+  typedef char char_type;
+  typedef ::std::char_traits< char > traits_type;
+  typedef traits_type::int_type int_type;
+  typedef traits_type::pos_type pos_type;
+  typedef traits_type::off_type off_type;
+
+  static const ::std::size_t default_buffer_size = 1048576;
+
+  FdStream();
+  // Open a file. Output modes create it, and trunc or out without in or app
+  // empties it. Direct mode opens with O_DIRECT where the file system allows
+  // it, and writes whole aligned buffers while the stream writes
+  // sequentially. Any other access drops O_DIRECT for the rest of the stream.
+  explicit FdStream(const ::std::string &path,
+                    ::std::ios_base::openmode mode = ::std::ios_base::in |
+                    ::std::ios_base::out, bool direct = false,
+                    ::std::size_t buffer_size = default_buffer_size);
+  // Use an open descriptor, which stays open after the stream. For regular
+  // files the stream starts at the descriptor offset and moves the offset to
+  // its own position when it is destroyed. Bytes read ahead from pipes and
+  // sockets are lost with the stream.
+  explicit FdStream(int fd, ::std::size_t buffer_size = default_buffer_size);
+  ~FdStream();
+
+  // Disable copy constructor and assignment operator
+  FdStream(const FdStream &s) = delete;
+  FdStream& operator=(const FdStream &s) = delete;
+
+  int fd() const;
+  bool direct() const;
+
+  FdStream& write(const char_type *s, ::std::streamsize n);
+  FdStream& read(char_type *s, ::std::streamsize n);
+  ::std::streamsize gcount() const;
+  FdStream& flush();
+
+  pos_type tellp();
+  pos_type tellg();
+  FdStream& seekp(pos_type pos);
+  FdStream& seekp(off_type off, ::std::ios_base::seekdir dir);
+  FdStream& seekg(pos_type pos);
+  FdStream& seekg(off_type off, ::std::ios_base::seekdir dir);
+
+  ::std::ios_base::iostate rdstate() const;
+  void clear(::std::ios_base::iostate state = ::std::ios_base::goodbit);
+  void setstate(::std::ios_base::iostate state);
+  bool good() const;
+  bool eof() const;
+  bool fail() const;
+  bool bad() const;
+  explicit operator bool() const;
+  bool operator!() const;
+
+ private:
+  void initialize(::std::size_t buffer_size);
+  bool flushWrite();
+  void undirect();
+  ::std::size_t readSome(char_type *s, ::std::size_t n);
+  bool writeAll(const char_type *s, ::std::size_t n);
+  pos_type tell() const;
+  void seek(off_type off, ::std::ios_base::seekdir dir);
+
+  int fd_;
+  bool owned_;
+  bool seekable_;
+  bool direct_;
+  ::std::size_t capacity_;
+  char_type *read_buffer_;
+  char_type *write_buffer_;
+  ::std::size_t read_begin_;
+  ::std::size_t read_end_;
+  ::std::size_t write_size_;
+  // File offset of the next pread or pwrite
+  off_type offset_;
+  ::std::ios_base::iostate state_;
+  ::std::streamsize gcount_;
+};
+
+// Stream over one contiguous byte buffer. The buffer is either owned by the
+// stream and grows as needed, or owned by the caller: a writable buffer of
+// fixed capacity, or read-only bytes that are read without copying them into
+// the stream first. Reading and writing have their own positions, as string
+// streams do.
+class BufferStream {
+ public:
+  typedef char char_type;
+  typedef ::std::char_traits< char > traits_type;
+  typedef traits_type::int_type int_type;
+  typedef traits_type::pos_type pos_type;
+  typedef traits_type::off_type off_type;
+
+  BufferStream();
+  // Write into capacity bytes at data. Writing past them fails the stream.
+  BufferStream(char_type *data, ::std::size_t capacity);
+  // Read size bytes at data
+  BufferStream(const char_type *data, ::std::size_t size);
+
+  // Disable copy constructor and assignment operator
+  BufferStream(const BufferStream &s) = delete;
+  BufferStream& operator=(const BufferStream &s) = delete;
+
+  // Bytes written so far. An owned buffer may move on the next write.
+  const char_type* data() const;
+  ::std::size_t size() const;
+  ::std::string str() const;
+  // View the next n bytes in place and move past them, or return null and
+  // fail the stream if fewer remain. Protocols copy data out with read(), so
+  // this is for callers that parse raw bytes of the buffer themselves.
+  const char_type* next(::std::size_t n);
+
+  BufferStream& write(const char_type *s, ::std::streamsize n);
+  BufferStream& read(char_type *s, ::std::streamsize n);
+  ::std::streamsize gcount() const;
+  BufferStream& flush();
+
+  pos_type tellp() const;
+  pos_type tellg() const;
+  BufferStream& seekp(pos_type pos);
+  BufferStream& seekp(off_type off, ::std::ios_base::seekdir dir);
+  BufferStream& seekg(pos_type pos);
+  BufferStream& seekg(off_type off, ::std::ios_base::seekdir dir);
+
+  ::std::ios_base::iostate rdstate() const;
+  void clear(::std::ios_base::iostate state = ::std::ios_base::goodbit);
+  void setstate(::std::ios_base::iostate state);
+  bool good() const;
+  bool eof() const;
+  bool fail() const;
+  bool bad() const;
+  explicit operator bool() const;
+  bool operator!() const;
+
+ private:
+  bool seek(::std::size_t *position, off_type off,
+            ::std::ios_base::seekdir dir);
+
+  ::std::vector< char_type > owned_;
+  char_type *data_;
+  const char_type *view_;
+  ::std::size_t capacity_;
+  ::std::size_t size_;
+  ::std::size_t get_;
+  ::std::size_t put_;
+  bool growable_;
+  ::std::ios_base::iostate state_;
+  ::std::streamsize gcount_;
+};
+
+typedef BinaryProtocol< FdStream > FdBinaryProtocol;
+typedef BinaryProtocol< BufferStream > BufferBinaryProtocol;
+
+}  // namespace serializer
+}  // namespace thunder
+
+#endif  // THUNDER_SERIALIZER_RAW_STREAM_HPP_
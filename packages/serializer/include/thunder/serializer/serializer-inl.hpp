@@ -22,7 +22,17 @@
 
 #include "thunder/serializer/serializer.hpp"
 
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ios>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thunder/exception.hpp"
 
 namespace thunder {
 namespace serializer {
@@ -30,7 +40,7 @@ namespace serializer {
 template < typename P >
 template < typename... G >
 Serializer< P >::Serializer(G ...g) :
-    protocol_(g...), saved_count_(0) {}
+    protocol_(g...), saved_count_(0), writing_(false), indexed_(false) {}
 
 template < typename P >
 const typename Serializer< P >::protocol_type&
@@ -47,6 +57,7 @@ typename Serializer< P >::protocol_type& Serializer< P >::protocol() {
 template < typename P >
 template < typename T >
 void Serializer< P >::save(const T &t) {
+  writing_ = true;
   protocol_.save(this, t);
 }
 
@@ -59,6 +70,7 @@ void Serializer< P >::load(T *t) {
 template < typename P >
 template < typename T >
 void Serializer< P >::save(T* const &t) {
+  writing_ = true;
   if (saved_pointers_.find(static_cast< void* >(t)) == saved_pointers_.end()) {
     // Special key 0 mark new serializer record to support appending
     if (saved_count_ == 0) {
@@ -93,8 +105,7 @@ void Serializer< P >::load(T* *t) {
     protocol_.load(this, *t);
     loaded_pointers_[key] = static_cast< void* >(*t);
   } else if (loaded_pointers_.find(key) == loaded_pointers_.end()) {
-    *t = static_cast< T* >(static_cast< ::std::shared_ptr< T >* >(
-        loaded_shared_[key])->get());
+    *t = static_cast< T* >(loaded_shared_[key].get());
     loaded_pointers_[key] = static_cast< void* >(*t);
   } else {
     *t = static_cast< T* >(loaded_pointers_[key]);
@@ -104,6 +115,7 @@ void Serializer< P >::load(T* *t) {
 template < typename P >
 template < typename T >
 void Serializer< P >::save(const ::std::shared_ptr< T > &t) {
+  writing_ = true;
   if (saved_pointers_.find(static_cast< void* >(t.get())) ==
       saved_pointers_.end()) {
     // Special key 0 appended if this archive is a new record
@@ -137,15 +149,150 @@ void Serializer< P >::load(::std::shared_ptr< T > *t) {
       loaded_pointers_.find(key) == loaded_pointers_.end()) {
     *t = ::std::make_shared< T >();
     protocol_.load(this, t->get());
-    loaded_shared_[key] = static_cast< void* >(t);
+    loaded_shared_[key] = *t;
   } else if (loaded_shared_.find(key) == loaded_shared_.end()) {
     *t = ::std::shared_ptr< T >(static_cast< T* >(loaded_pointers_[key]));
-    loaded_shared_[key] = static_cast< void* >(t);
+    loaded_shared_[key] = *t;
   } else {
-    *t = *(static_cast< ::std::shared_ptr< T >* >(loaded_shared_[key]));
+    *t = ::std::static_pointer_cast< T >(loaded_shared_[key]);
   }
 }
 
+template < typename P >
+template < typename T >
+void Serializer< P >::saveArray(const T *t, ::std::size_t n) {
+  writing_ = true;
+  protocol_.saveArray(this, t, n);
+}
+
+template < typename P >
+template < typename T >
+void Serializer< P >::loadArray(T *t, ::std::size_t n) {
+  protocol_.loadArray(this, t, n);
+}
+
+template < typename P >
+void Serializer< P >::newRecord() {
+  saved_count_ = 0;
+  saved_pointers_.clear();
+  loaded_pointers_.clear();
+  loaded_shared_.clear();
+}
+
+template < typename P >
+template < typename T >
+void Serializer< P >::saveNamed(const ::std::string &name, const T &t) {
+  if (index_.find(name) != index_.end()) {
+    throw invalid_argument("Record " + name + " is already in the index.");
+  }
+  newRecord();
+  index_[name] = static_cast< ::std::streamoff >(protocol_.stream().tellp());
+  names_.push_back(name);
+  save(t);
+}
+
+template < typename P >
+template < typename T >
+void Serializer< P >::loadNamed(const ::std::string &name, T *t) {
+  readIndex();
+  typename ::std::unordered_map< ::std::string, ::std::streamoff >::iterator
+      found = index_.find(name);
+  if (found == index_.end()) {
+    throw out_of_range("Record " + name + " is not in the index.");
+  }
+  newRecord();
+  protocol_.stream().clear();
+  protocol_.stream().seekg(found->second);
+  load(t);
+}
+
+template < typename P >
+template < typename T >
+T Serializer< P >::loadNamed(const ::std::string &name) {
+  T t;
+  loadNamed(name, &t);
+  return t;
+}
+
+template < typename P >
+void Serializer< P >::saveIndex() {
+  writing_ = true;
+  ::std::streamoff position =
+      static_cast< ::std::streamoff >(protocol_.stream().tellp());
+  protocol_.save(this, static_cast< unsigned long long >(names_.size()));
+  for (const ::std::string &name : names_) {
+    protocol_.save(this, static_cast< unsigned long long >(name.size()));
+    saveArray(name.data(), name.size());
+    protocol_.save(this, static_cast< long long >(index_[name]));
+  }
+
+  // The trailer is the magic THUNDIDX and the index position in 16 hex
+  // digits. It is raw so that it has the same size under every protocol.
+  char trailer[25];
+  ::std::snprintf(trailer, sizeof(trailer), "THUNDIDX%016llx",
+                  static_cast< unsigned long long >(position));
+  protocol_.stream().write(trailer, 24);
+  protocol_.stream().flush();
+  indexed_ = true;
+}
+
+template < typename P >
+void Serializer< P >::loadIndex() {
+  stream_type &stream = protocol_.stream();
+  stream.clear();
+  stream.seekg(-24, ::std::ios_base::end);
+  char trailer[25] = {};
+  stream.read(trailer, 24);
+  if (!stream || ::std::memcmp(trailer, "THUNDIDX", 8) != 0) {
+    throw io_error("Serialized stream has no index.");
+  }
+  ::std::streamoff position = static_cast< ::std::streamoff >(
+      ::std::strtoull(trailer + 8, nullptr, 16));
+
+  stream.seekg(position);
+  unsigned long long count = 0;
+  protocol_.load(this, &count);
+  ::std::vector< ::std::string > names;
+  ::std::unordered_map< ::std::string, ::std::streamoff > index;
+  for (unsigned long long i = 0; i < count; ++i) {
+    unsigned long long size = 0;
+    protocol_.load(this, &size);
+    ::std::string name(size, '\0');
+    if (size > 0) {
+      loadArray(&name[0], size);
+    }
+    long long offset = 0;
+    protocol_.load(this, &offset);
+    if (!stream) {
+      throw io_error("Serialized index is truncated.");
+    }
+    index[name] = static_cast< ::std::streamoff >(offset);
+    names.push_back(::std::move(name));
+  }
+  names_ = ::std::move(names);
+  index_ = ::std::move(index);
+  indexed_ = true;
+}
+
+template < typename P >
+void Serializer< P >::readIndex() {
+  if (!indexed_ && !writing_) {
+    loadIndex();
+  }
+}
+
+template < typename P >
+const ::std::vector< ::std::string >& Serializer< P >::names() {
+  readIndex();
+  return names_;
+}
+
+template < typename P >
+bool Serializer< P >::containsNamed(const ::std::string &name) {
+  readIndex();
+  return index_.find(name) != index_.end();
+}
+
 }  // namespace serializer
 }  // namespace thunder
 
@@ -20,10 +20,13 @@
 #ifndef THUNDER_SERIALIZER_SERIALIZER_HPP_
 #define THUNDER_SERIALIZER_SERIALIZER_HPP_
 
+#include <cstddef>
+#include <ios>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "thunder/serializer/text_protocol.hpp"
 
@@ -65,12 +68,45 @@ class Serializer {
   template < typename T >
   void load(::std::shared_ptr< T > *t);
 
+  // Array save and load, in bulk if the protocol supports it
+  template < typename T >
+  void saveArray(const T *t, ::std::size_t n);
+  template < typename T >
+  void loadArray(T *t, ::std::size_t n);
+
+  // Indexed archives. A named save starts a new record at a position kept in
+  // the index, and saveIndex() appends the index with a fixed-size trailer
+  // pointing to it. A named load reads the index once, then seeks straight to
+  // the record without loading anything before it. Pointers are not shared
+  // across named records.
+  template < typename T >
+  void saveNamed(const ::std::string &name, const T &t);
+  template < typename T >
+  void loadNamed(const ::std::string &name, T *t);
+  template < typename T >
+  T loadNamed(const ::std::string &name);
+  void saveIndex();
+  void loadIndex();
+  // Names in the order they were saved. A serializer that has saved
+  // anything uses the index it keeps in memory, and one that has not reads
+  // the index from the stream.
+  const ::std::vector< ::std::string >& names();
+  bool containsNamed(const ::std::string &name);
+
  private:
+  void newRecord();
+  void readIndex();
+
   P protocol_;
   unsigned int saved_count_;
   ::std::unordered_map< void*, unsigned int > saved_pointers_;
   ::std::unordered_map< unsigned int, void* > loaded_pointers_;
-  ::std::unordered_map< unsigned int, void* > loaded_shared_;
+  ::std::unordered_map< unsigned int, ::std::shared_ptr< void > >
+  loaded_shared_;
+  bool writing_;
+  bool indexed_;
+  ::std::vector< ::std::string > names_;
+  ::std::unordered_map< ::std::string, ::std::streamoff > index_;
 };
 
 }  // namespace serializer
@@ -0,0 +1,52 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_SERIALIZER_TEXT_FORMAT_HPP_
+#define THUNDER_SERIALIZER_TEXT_FORMAT_HPP_
+
+#include <cstddef>
+
+namespace thunder {
+namespace serializer {
+
+// Buffer size large enough for any number formatted below
+const ::std::size_t kTextNumberSize = 64;
+
+// Format a number into buffer without a terminating null and return its
+// length. Floating point numbers use the fewest significant digits that read
+// back to the same value, independent of the global locale.
+::std::size_t formatNumber(long long t, char *buffer);
+::std::size_t formatNumber(unsigned long long t, char *buffer);
+::std::size_t formatNumber(float t, char *buffer);
+::std::size_t formatNumber(double t, char *buffer);
+::std::size_t formatNumber(long double t, char *buffer);
+
+// Parse a whole token of n characters. Returns false if the token is not a
+// number or does not fit in the type, storing zero in the first case and the
+// nearest value of the type in the second, as the stream extractors do.
+bool parseNumber(const char *token, ::std::size_t n, long long *t);
+bool parseNumber(const char *token, ::std::size_t n, unsigned long long *t);
+bool parseNumber(const char *token, ::std::size_t n, float *t);
+bool parseNumber(const char *token, ::std::size_t n, double *t);
+bool parseNumber(const char *token, ::std::size_t n, long double *t);
+
+}  // namespace serializer
+}  // namespace thunder
+
+#endif  // THUNDER_SERIALIZER_TEXT_FORMAT_HPP_
@@ -22,12 +22,15 @@
 
 #include "thunder/serializer/text_protocol.hpp"
 
-#include <iomanip>
+#include <cstddef>
 #include <ios>
 #include <limits>
+#include <streambuf>
+#include <type_traits>
 
 #include "thunder/serializer/serializer.hpp"
 #include "thunder/serializer/static.hpp"
+#include "thunder/serializer/text_format.hpp"
 
 namespace thunder {
 namespace serializer {
@@ -87,12 +90,12 @@ THUNDER_SERIALIZER_TEXT_PROTOCOL_DEFINE_CHAR(char32_t, long);
   template < typename M >                                               \
   template < typename S >                                               \
   void TextProtocol< M >::save(S *s, const TYPE &t) {                   \
-    stream_ << t << ' ';                                                \
+    saveNumber(t);                                                      \
   }                                                                     \
   template < typename M >                                               \
   template < typename S >                                               \
   void TextProtocol< M >::load(S *s, TYPE *t) {                         \
-    stream_ >> (*t);                                                    \
+    loadNumber(t);                                                      \
   }
 
 THUNDER_SERIALIZER_TEXT_PROTOCOL_DEFINE_INTEGER(short);
@@ -110,14 +113,12 @@ THUNDER_SERIALIZER_TEXT_PROTOCOL_DEFINE_INTEGER(unsigned long long);
   template < typename M >                                               \
   template < typename S >                                               \
   void TextProtocol< M >::save(S *s, const TYPE &t) {                   \
-    stream_.unsetf(::std::ios_base::floatfield);                        \
-    stream_ << ::std::setprecision(                                     \
-        ::std::numeric_limits< TYPE >::max_digits10) << t << ' ';       \
+    saveNumber(t);                                                      \
   }                                                                     \
   template < typename M >                                               \
   template < typename S >                                               \
   void TextProtocol< M >::load(S *s, TYPE *t) {                         \
-    stream_ >> (*t);                                                    \
+    loadNumber(t);                                                      \
   }
 
 THUNDER_SERIALIZER_TEXT_PROTOCOL_DEFINE_FLOAT(float);
@@ -126,6 +127,102 @@ THUNDER_SERIALIZER_TEXT_PROTOCOL_DEFINE_FLOAT(long double);
 
 #undef THUNDER_SERIALIZATION_TEXT_PROTOCOL_DEFINE_FLOAT
 
+template < typename M >
+template < typename S, typename T >
+void TextProtocol< M >::saveArray(S *s, const T *t, ::std::size_t n) {
+  for (::std::size_t i = 0; i < n; ++i) {
+    s->save(t[i]);
+  }
+}
+
+template < typename M >
+template < typename S, typename T >
+void TextProtocol< M >::loadArray(S *s, T *t, ::std::size_t n) {
+  for (::std::size_t i = 0; i < n; ++i) {
+    s->load(&t[i]);
+  }
+}
+
+template < typename M >
+template < typename T >
+void TextProtocol< M >::saveNumber(const T &t) {
+  typedef typename ::std::conditional<
+    ::std::is_floating_point< T >::value, T, typename ::std::conditional<
+      ::std::is_signed< T >::value, long long,
+      unsigned long long >::type >::type number_type;
+  char buffer[kTextNumberSize + 1];
+  ::std::size_t n = formatNumber(static_cast< number_type >(t), buffer);
+  buffer[n++] = ' ';
+  ::std::streamsize written = stream_.rdbuf()->sputn(buffer, n);
+  if (written != static_cast< ::std::streamsize >(n)) {
+    stream_.setstate(::std::ios_base::badbit);
+  }
+}
+
+template < typename M >
+template < typename T >
+void TextProtocol< M >::loadNumber(T *t) {
+  typedef typename ::std::conditional<
+    ::std::is_floating_point< T >::value, T, typename ::std::conditional<
+      ::std::is_signed< T >::value, long long,
+      unsigned long long >::type >::type number_type;
+  // As with operator>>, failures store zero, or the nearest value of the
+  // type if the number is out of range
+  char token[kTextNumberSize];
+  ::std::size_t n = readToken(token);
+  number_type value = 0;
+  bool parsed = n > 0 && parseNumber(token, n, &value);
+  const bool integral = ::std::is_integral< T >::value;
+  if (integral && value > static_cast< number_type >(
+      ::std::numeric_limits< T >::max())) {
+    value = static_cast< number_type >(::std::numeric_limits< T >::max());
+    parsed = false;
+  } else if (integral && value < static_cast< number_type >(
+      ::std::numeric_limits< T >::lowest())) {
+    value = static_cast< number_type >(::std::numeric_limits< T >::lowest());
+    parsed = false;
+  }
+  *t = static_cast< T >(value);
+  if (!parsed) {
+    stream_.setstate(::std::ios_base::failbit);
+  }
+}
+
+template < typename M >
+::std::size_t TextProtocol< M >::readToken(char *token) {
+  typedef typename stream_type::traits_type traits_type;
+  typedef typename traits_type::int_type int_type;
+  if (!stream_) {
+    return 0;
+  }
+  auto space = [](int_type c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+        c == '\f';
+  };
+
+  // Skip leading white space, then take characters up to the next one
+  ::std::basic_streambuf< typename stream_type::char_type, traits_type >
+      *buffer = stream_.rdbuf();
+  int_type c = buffer->sgetc();
+  while (!traits_type::eq_int_type(c, traits_type::eof()) && space(c)) {
+    c = buffer->snextc();
+  }
+  ::std::size_t n = 0;
+  bool overflow = false;
+  while (!traits_type::eq_int_type(c, traits_type::eof()) && !space(c)) {
+    if (n < kTextNumberSize) {
+      token[n++] = traits_type::to_char_type(c);
+    } else {
+      overflow = true;
+    }
+    c = buffer->snextc();
+  }
+  if (traits_type::eq_int_type(c, traits_type::eof())) {
+    stream_.setstate(::std::ios_base::eofbit);
+  }
+  return overflow ? 0 : n;
+}
+
 }  // namespace serializer
 }  // namespace thunder
 
@@ -20,6 +20,7 @@
 #ifndef THUNDER_SERIALIZER_TEXT_PROTOCOL_HPP_
 #define THUNDER_SERIALIZER_TEXT_PROTOCOL_HPP_
 
+#include <cstddef>
 #include <sstream>
 
 namespace thunder {
@@ -120,7 +121,21 @@ class TextProtocol {
   template < typename S >
   void load(S *s, long double *t);
 
+  // Array serialization saves elements one by one
+  template < typename S, typename T >
+  void saveArray(S *s, const T *t, ::std::size_t n);
+  template < typename S, typename T >
+  void loadArray(S *s, T *t, ::std::size_t n);
+
  private:
+  // Numbers are formatted and parsed in-tree, and go through the stream
+  // buffer directly as tokens followed by a space
+  template < typename T >
+  void saveNumber(const T &t);
+  template < typename T >
+  void loadNumber(T *t);
+  ::std::size_t readToken(char *token);
+
   stream_type stream_;
 };
 
@@ -0,0 +1,410 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/serializer/codec.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "thunder/exception.hpp"
+#include "thunder/parallel.hpp"
+
+namespace thunder {
+namespace serializer {
+
+namespace {
+
+// Block header: length with the stored flag, then checksum
+const ::std::size_t kBlockHeaderSize = 8;
+const ::std::uint32_t kStoredFlag = 0x80000000u;
+
+// LZ format. A sequence is a token holding 4 bits of literal length and 4
+// bits of match length minus kMinMatch, each extended by bytes of 255 and a
+// final byte below 255, then the literals, then a 2-byte little endian match
+// offset. The last sequence ends after its literals.
+const ::std::size_t kMinMatch = 4;
+const ::std::size_t kLastLiterals = 5;
+const ::std::size_t kMatchLimit = 12;
+const ::std::size_t kMaxOffset = 65535;
+const int kHashBits = 14;
+
+void putUint32(char *p, ::std::uint32_t v) {
+  for (int i = 0; i < 4; ++i) {
+    p[i] = static_cast< char >((v >> (8 * i)) & 0xFF);
+  }
+}
+
+::std::uint32_t getUint32(const char *p) {
+  ::std::uint32_t v = 0;
+  for (int i = 0; i < 4; ++i) {
+    v |= static_cast< ::std::uint32_t >(static_cast< unsigned char >(p[i]))
+        << (8 * i);
+  }
+  return v;
+}
+
+::std::uint32_t read32(const char *p) {
+  ::std::uint32_t v;
+  ::std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+::std::uint64_t read64(const char *p) {
+  ::std::uint64_t v;
+  ::std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+::std::uint32_t hash(::std::uint32_t v) {
+  return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+char* putLength(char *op, ::std::size_t length) {
+  for (; length >= 255; length -= 255) {
+    *op++ = static_cast< char >(255);
+  }
+  *op++ = static_cast< char >(length);
+  return op;
+}
+
+char* putSequence(char *op, const char *literals, ::std::size_t n,
+                  ::std::size_t offset, ::std::size_t match) {
+  char *token = op++;
+  unsigned char code = static_cast< unsigned char >(::std::min(
+      n, static_cast< ::std::size_t >(15)) << 4);
+  if (n >= 15) {
+    op = putLength(op, n - 15);
+  }
+  ::std::memcpy(op, literals, n);
+  op += n;
+  if (match > 0) {
+    *op++ = static_cast< char >(offset & 0xFF);
+    *op++ = static_cast< char >(offset >> 8);
+    match -= kMinMatch;
+    code |= static_cast< unsigned char >(::std::min(
+        match, static_cast< ::std::size_t >(15)));
+    if (match >= 15) {
+      op = putLength(op, match - 15);
+    }
+  }
+  *token = static_cast< char >(code);
+  return op;
+}
+
+// Read an extended length, returning false past the end of input
+bool getLength(const unsigned char *in, ::std::size_t m, ::std::size_t *ip,
+               ::std::size_t *length) {
+  unsigned char b;
+  do {
+    if (*ip >= m) {
+      return false;
+    }
+    b = in[(*ip)++];
+    *length += b;
+  } while (b == 255);
+  return true;
+}
+
+struct CrcTables {
+  ::std::uint32_t table[8][256];
+
+  CrcTables() {
+    for (::std::uint32_t i = 0; i < 256; ++i) {
+      ::std::uint32_t crc = i;
+      for (int k = 0; k < 8; ++k) {
+        crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+      }
+      table[0][i] = crc;
+    }
+    for (int k = 1; k < 8; ++k) {
+      for (int i = 0; i < 256; ++i) {
+        table[k][i] = (table[k - 1][i] >> 8) ^
+            table[0][table[k - 1][i] & 0xFF];
+      }
+    }
+  }
+};
+
+}  // namespace
+
+void compressBlocks(
+    Codec codec, const char *data, ::std::size_t bytes, ::std::size_t width,
+    const ::std::function< void(const char*, ::std::size_t) > &write) {
+  if (width == 0 || kCodecBlockSize % width != 0) {
+    width = 1;
+  }
+  ::std::size_t blocks = (bytes + kCodecBlockSize - 1) / kCodecBlockSize;
+  ::std::size_t batch = ::std::min(
+      blocks, ::std::max(parallel::threads(), static_cast< ::std::size_t >(1)));
+  ::std::size_t capacity = kBlockHeaderSize + compressBound(kCodecBlockSize);
+  ::std::vector< char > encoded(batch * capacity);
+  ::std::vector< char > shuffled(
+      codec == Codec::kShuffleLz && width > 1 ? batch * kCodecBlockSize : 0);
+  ::std::vector< ::std::size_t > sizes(batch);
+
+  for (::std::size_t first = 0; first < blocks; first += batch) {
+    ::std::size_t count = ::std::min(batch, blocks - first);
+    parallel::run(count, [&](::std::size_t k) {
+        ::std::size_t begin = (first + k) * kCodecBlockSize;
+        ::std::size_t size = ::std::min(kCodecBlockSize, bytes - begin);
+        const char *block = data + begin;
+        const char *source = block;
+        if (!shuffled.empty()) {
+          char *scratch = shuffled.data() + k * kCodecBlockSize;
+          shuffleBytes(block, size / width, width, scratch);
+          source = scratch;
+        }
+        char *out = encoded.data() + k * capacity;
+        ::std::size_t m = compressBlock(
+            source, size, out + kBlockHeaderSize);
+        ::std::uint32_t length = static_cast< ::std::uint32_t >(m);
+        if (m >= size) {
+          ::std::memcpy(out + kBlockHeaderSize, block, size);
+          m = size;
+          length = static_cast< ::std::uint32_t >(size) | kStoredFlag;
+        }
+        putUint32(out, length);
+        putUint32(out + 4, checksum(block, size));
+        sizes[k] = kBlockHeaderSize + m;
+      });
+    for (::std::size_t k = 0; k < count; ++k) {
+      write(encoded.data() + k * capacity, sizes[k]);
+    }
+  }
+}
+
+void decompressBlocks(
+    Codec codec, char *data, ::std::size_t bytes, ::std::size_t width,
+    const ::std::function< bool(char*, ::std::size_t) > &read) {
+  if (codec != Codec::kLz && codec != Codec::kShuffleLz) {
+    throw io_error("Compressed array has an unknown codec.");
+  }
+  if (width == 0 || kCodecBlockSize % width != 0) {
+    width = 1;
+  }
+  ::std::size_t blocks = (bytes + kCodecBlockSize - 1) / kCodecBlockSize;
+  ::std::size_t batch = ::std::min(
+      blocks, ::std::max(parallel::threads(), static_cast< ::std::size_t >(1)));
+  ::std::size_t capacity = compressBound(kCodecBlockSize);
+  ::std::vector< char > encoded(batch * capacity);
+  ::std::vector< char > shuffled(
+      codec == Codec::kShuffleLz && width > 1 ? batch * kCodecBlockSize : 0);
+  ::std::vector< ::std::uint32_t > lengths(batch);
+  ::std::vector< ::std::uint32_t > checksums(batch);
+
+  for (::std::size_t first = 0; first < blocks; first += batch) {
+    ::std::size_t count = ::std::min(batch, blocks - first);
+    for (::std::size_t k = 0; k < count; ++k) {
+      ::std::size_t size = ::std::min(
+          kCodecBlockSize, bytes - (first + k) * kCodecBlockSize);
+      char header[kBlockHeaderSize];
+      if (!read(header, kBlockHeaderSize)) {
+        throw io_error("Compressed array is truncated.");
+      }
+      lengths[k] = getUint32(header);
+      checksums[k] = getUint32(header + 4);
+      ::std::size_t m = lengths[k] & ~kStoredFlag;
+      if ((lengths[k] & kStoredFlag) != 0 ? m != size : m > capacity) {
+        throw io_error("Compressed array has a corrupt block.");
+      }
+      if (!read(encoded.data() + k * capacity, m)) {
+        throw io_error("Compressed array is truncated.");
+      }
+    }
+    parallel::run(count, [&](::std::size_t k) {
+        ::std::size_t begin = (first + k) * kCodecBlockSize;
+        ::std::size_t size = ::std::min(kCodecBlockSize, bytes - begin);
+        ::std::size_t m = lengths[k] & ~kStoredFlag;
+        const char *in = encoded.data() + k * capacity;
+        char *block = data + begin;
+        bool decoded = true;
+        if ((lengths[k] & kStoredFlag) != 0) {
+          ::std::memcpy(block, in, size);
+        } else if (!shuffled.empty()) {
+          char *scratch = shuffled.data() + k * kCodecBlockSize;
+          decoded = decompressBlock(in, m, scratch, size);
+          unshuffleBytes(scratch, size / width, width, block);
+        } else {
+          decoded = decompressBlock(in, m, block, size);
+        }
+        if (!decoded) {
+          throw io_error("Compressed array has a corrupt block.");
+        }
+        if (checksum(block, size) != checksums[k]) {
+          throw io_error("Compressed array does not match its checksum.");
+        }
+      });
+  }
+}
+
+void shuffleBytes(const char *in, ::std::size_t n, ::std::size_t width,
+                  char *out) {
+  for (::std::size_t j = 0; j < width; ++j) {
+    const char *source = in + j;
+    char *target = out + j * n;
+    for (::std::size_t i = 0; i < n; ++i) {
+      target[i] = source[i * width];
+    }
+  }
+}
+
+void unshuffleBytes(const char *in, ::std::size_t n, ::std::size_t width,
+                    char *out) {
+  for (::std::size_t j = 0; j < width; ++j) {
+    const char *source = in + j * n;
+    char *target = out + j;
+    for (::std::size_t i = 0; i < n; ++i) {
+      target[i * width] = source[i];
+    }
+  }
+}
+
+::std::size_t compressBound(::std::size_t n) {
+  return n + n / 255 + 16;
+}
+
+// Greedy matching on a hash of 4-byte prefixes, skipping ahead faster the
+// longer no match is found so that incompressible data passes quickly
+::std::size_t compressBlock(const char *in, ::std::size_t n, char *out) {
+  char *op = out;
+  ::std::size_t anchor = 0;
+  if (n > kMatchLimit) {
+    ::std::vector< ::std::uint32_t > table(
+        static_cast< ::std::size_t >(1) << kHashBits, 0);
+    ::std::size_t limit = n - kLastLiterals;
+    ::std::size_t ip = 0;
+    ::std::size_t misses = 0;
+    while (ip + kMatchLimit <= n) {
+      ::std::uint32_t h = hash(read32(in + ip));
+      ::std::size_t candidate = table[h];
+      table[h] = static_cast< ::std::uint32_t >(ip);
+      if (candidate >= ip || ip - candidate > kMaxOffset ||
+          read32(in + candidate) != read32(in + ip)) {
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+      while (ip > anchor && candidate > 0 &&
+             in[ip - 1] == in[candidate - 1]) {
+        --ip;
+        --candidate;
+      }
+      ::std::size_t match = kMinMatch;
+      while (ip + match + 8 <= limit &&
+             read64(in + candidate + match) == read64(in + ip + match)) {
+        match += 8;
+      }
+      while (ip + match < limit && in[candidate + match] == in[ip + match]) {
+        ++match;
+      }
+      op = putSequence(op, in + anchor, ip - anchor, ip - candidate, match);
+      ip += match;
+      anchor = ip;
+      if (ip + kMatchLimit <= n) {
+        table[hash(read32(in + ip - 2))] =
+            static_cast< ::std::uint32_t >(ip - 2);
+      }
+    }
+  }
+  op = putSequence(op, in + anchor, n - anchor, 0, 0);
+  return static_cast< ::std::size_t >(op - out);
+}
+
+bool decompressBlock(const char *in, ::std::size_t m, char *out,
+                     ::std::size_t n) {
+  const unsigned char *source = reinterpret_cast< const unsigned char* >(in);
+  ::std::size_t ip = 0;
+  ::std::size_t op = 0;
+  while (ip < m) {
+    unsigned char token = source[ip++];
+    ::std::size_t literals = token >> 4;
+    if (literals == 15 && !getLength(source, m, &ip, &literals)) {
+      return false;
+    }
+    if (literals > m - ip || literals > n - op) {
+      return false;
+    }
+    // Short literals are copied 16 bytes at a time when both sides have room
+    if (literals <= 16 && m - ip >= 16 && n - op >= 16) {
+      ::std::memcpy(out + op, in + ip, 16);
+    } else {
+      ::std::memcpy(out + op, in + ip, literals);
+    }
+    ip += literals;
+    op += literals;
+    if (ip == m) {
+      break;
+    }
+    if (m - ip < 2) {
+      return false;
+    }
+    ::std::size_t offset = source[ip] | (source[ip + 1] << 8);
+    ip += 2;
+    ::std::size_t match = token & 15;
+    if (match == 15 && !getLength(source, m, &ip, &match)) {
+      return false;
+    }
+    match += kMinMatch;
+    if (offset == 0 || offset > op || match > n - op) {
+      return false;
+    }
+    if (offset >= 8 && n - op >= match + 8) {
+      for (::std::size_t i = 0; i < match; i += 8) {
+        ::std::memcpy(out + op + i, out + op - offset + i, 8);
+      }
+      op += match;
+      continue;
+    }
+    // Overlapping matches repeat the last offset bytes. Copying from twice
+    // as far back each time keeps the period while halving the copies.
+    for (::std::size_t step = offset; match > 0; step *= 2) {
+      ::std::size_t k = ::std::min(step, match);
+      ::std::memcpy(out + op, out + op - step, k);
+      op += k;
+      match -= k;
+    }
+  }
+  return op == n;
+}
+
+::std::uint32_t checksum(const char *data, ::std::size_t n) {
+  static const CrcTables tables;
+  const ::std::uint32_t (*t)[256] = tables.table;
+  const unsigned char *p = reinterpret_cast< const unsigned char* >(data);
+  ::std::uint32_t crc = 0xFFFFFFFFu;
+  for (; n >= 8; n -= 8, p += 8) {
+    ::std::uint32_t a = crc ^ (static_cast< ::std::uint32_t >(p[0]) |
+                               static_cast< ::std::uint32_t >(p[1]) << 8 |
+                               static_cast< ::std::uint32_t >(p[2]) << 16 |
+                               static_cast< ::std::uint32_t >(p[3]) << 24);
+    crc = t[7][a & 0xFF] ^ t[6][(a >> 8) & 0xFF] ^ t[5][(a >> 16) & 0xFF] ^
+        t[4][a >> 24] ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+  }
+  for (; n > 0; --n, ++p) {
+    crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+}  // namespace serializer
+}  // namespace thunder
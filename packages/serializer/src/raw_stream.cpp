@@ -0,0 +1,567 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/serializer/raw_stream.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <ios>
+#include <new>
+#include <string>
+
+#include "thunder/exception.hpp"
+
+namespace thunder {
+namespace serializer {
+
+namespace {
+
+// Alignment of buffers and transfers for O_DIRECT
+const ::std::size_t kDirectAlignment = 4096;
+
+}  // namespace
+
+const ::std::size_t FdStream::default_buffer_size;
+
+FdStream::FdStream() : fd_(-1), owned_(false), direct_(false) {
+  initialize(default_buffer_size);
+}
+
+FdStream::FdStream(const ::std::string &path, ::std::ios_base::openmode mode,
+                   bool direct, ::std::size_t buffer_size)
+    : fd_(-1), owned_(true) {
+  bool in = (mode & ::std::ios_base::in) != 0;
+  bool out = (mode & (::std::ios_base::out | ::std::ios_base::app)) != 0;
+  int flags = in && out ? O_RDWR : out ? O_WRONLY : O_RDONLY;
+  if (out) {
+    flags |= O_CREAT;
+  }
+  if ((mode & ::std::ios_base::trunc) != 0 ||
+      (out && !in && (mode & ::std::ios_base::app) == 0)) {
+    flags |= O_TRUNC;
+  }
+  if (direct) {
+#ifdef O_DIRECT
+    fd_ = open(path.c_str(), flags | O_DIRECT, 0644);
+#endif
+  }
+  direct_ = fd_ >= 0;
+  if (fd_ < 0) {
+    fd_ = open(path.c_str(), flags, 0644);
+  }
+  initialize(buffer_size);
+  if (fd_ < 0) {
+    state_ = ::std::ios_base::failbit;
+    return;
+  }
+  if ((mode & (::std::ios_base::app | ::std::ios_base::ate)) != 0) {
+    seek(0, ::std::ios_base::end);
+  }
+}
+
+FdStream::FdStream(int fd, ::std::size_t buffer_size)
+    : fd_(fd), owned_(false), direct_(false) {
+  initialize(buffer_size);
+}
+
+FdStream::~FdStream() {
+  if (fd_ >= 0) {
+    flushWrite();
+    if (owned_) {
+      close(fd_);
+    } else if (seekable_) {
+      // Leave a borrowed descriptor where the stream stopped, as if it had
+      // been read and written directly
+      lseek(fd_, static_cast< off_t >(tell()), SEEK_SET);
+    }
+  }
+  ::std::free(read_buffer_);
+  ::std::free(write_buffer_);
+}
+
+void FdStream::initialize(::std::size_t buffer_size) {
+  if (fd_ < 0) {
+    direct_ = false;
+  }
+  // Buffers are aligned and sized for O_DIRECT in all cases, which costs
+  // little for buffers this large
+  capacity_ = (::std::max(buffer_size, kDirectAlignment) + kDirectAlignment -
+               1) / kDirectAlignment * kDirectAlignment;
+  void *read_buffer = nullptr;
+  void *write_buffer = nullptr;
+  if (posix_memalign(&read_buffer, kDirectAlignment, capacity_) != 0 ||
+      posix_memalign(&write_buffer, kDirectAlignment, capacity_) != 0) {
+    ::std::free(read_buffer);
+    throw ::std::bad_alloc();
+  }
+  read_buffer_ = static_cast< char_type* >(read_buffer);
+  write_buffer_ = static_cast< char_type* >(write_buffer);
+  read_begin_ = 0;
+  read_end_ = 0;
+  write_size_ = 0;
+  state_ = ::std::ios_base::goodbit;
+  gcount_ = 0;
+  offset_ = 0;
+  seekable_ = false;
+  if (fd_ >= 0) {
+    off_t offset = lseek(fd_, 0, SEEK_CUR);
+    seekable_ = offset >= 0;
+    offset_ = seekable_ ? static_cast< off_type >(offset) : 0;
+  }
+}
+
+int FdStream::fd() const {
+  return fd_;
+}
+
+bool FdStream::direct() const {
+  return direct_;
+}
+
+FdStream& FdStream::write(const char_type *s, ::std::streamsize n) {
+  if (fail() || n <= 0) {
+    return *this;
+  }
+  // Files have one position, so unread bytes are dropped before writing
+  if (seekable_ && read_end_ > read_begin_) {
+    offset_ -= static_cast< off_type >(read_end_ - read_begin_);
+  }
+  read_begin_ = 0;
+  read_end_ = 0;
+
+  ::std::size_t bytes = static_cast< ::std::size_t >(n);
+  while (bytes > 0) {
+    // Large blocks are written in place unless they have to be aligned for
+    // O_DIRECT
+    if (write_size_ == 0 && !direct_ && bytes >= capacity_) {
+      if (!writeAll(s, bytes)) {
+        setstate(::std::ios_base::badbit);
+      }
+      return *this;
+    }
+    ::std::size_t m = ::std::min(bytes, capacity_ - write_size_);
+    ::std::memcpy(write_buffer_ + write_size_, s, m);
+    write_size_ += m;
+    s += m;
+    bytes -= m;
+    if (write_size_ == capacity_ && !flushWrite()) {
+      setstate(::std::ios_base::badbit);
+      return *this;
+    }
+  }
+  return *this;
+}
+
+FdStream& FdStream::read(char_type *s, ::std::streamsize n) {
+  gcount_ = 0;
+  if (fail() || n <= 0) {
+    if (n > 0) {
+      setstate(::std::ios_base::failbit);
+    }
+    return *this;
+  }
+  if (!flushWrite()) {
+    setstate(::std::ios_base::badbit);
+    return *this;
+  }
+  undirect();
+
+  ::std::size_t bytes = static_cast< ::std::size_t >(n);
+  while (bytes > 0) {
+    if (read_end_ > read_begin_) {
+      ::std::size_t m = ::std::min(bytes, read_end_ - read_begin_);
+      ::std::memcpy(s, read_buffer_ + read_begin_, m);
+      read_begin_ += m;
+      s += m;
+      bytes -= m;
+      gcount_ += static_cast< ::std::streamsize >(m);
+      continue;
+    }
+    // Large reads go straight to the destination
+    ::std::size_t got = 0;
+    if (bytes >= capacity_) {
+      got = readSome(s, bytes);
+      s += got;
+      bytes -= got;
+      gcount_ += static_cast< ::std::streamsize >(got);
+    } else {
+      got = readSome(read_buffer_, capacity_);
+      read_begin_ = 0;
+      read_end_ = got;
+    }
+    if (got == 0) {
+      setstate(::std::ios_base::eofbit | ::std::ios_base::failbit);
+      break;
+    }
+  }
+  return *this;
+}
+
+::std::streamsize FdStream::gcount() const {
+  return gcount_;
+}
+
+FdStream& FdStream::flush() {
+  if (!flushWrite()) {
+    setstate(::std::ios_base::badbit);
+  }
+  return *this;
+}
+
+FdStream::pos_type FdStream::tellp() {
+  return fail() ? pos_type(off_type(-1)) : tell();
+}
+
+FdStream::pos_type FdStream::tellg() {
+  return fail() ? pos_type(off_type(-1)) : tell();
+}
+
+FdStream& FdStream::seekp(pos_type pos) {
+  return seekp(off_type(pos), ::std::ios_base::beg);
+}
+
+FdStream& FdStream::seekp(off_type off, ::std::ios_base::seekdir dir) {
+  if (!fail()) {
+    seek(off, dir);
+  }
+  return *this;
+}
+
+FdStream& FdStream::seekg(pos_type pos) {
+  return seekg(off_type(pos), ::std::ios_base::beg);
+}
+
+FdStream& FdStream::seekg(off_type off, ::std::ios_base::seekdir dir) {
+  // Seeking to read clears the end of file, as for iostreams
+  state_ &= ~::std::ios_base::eofbit;
+  if (!fail()) {
+    seek(off, dir);
+  }
+  return *this;
+}
+
+::std::ios_base::iostate FdStream::rdstate() const {
+  return state_;
+}
+
+void FdStream::clear(::std::ios_base::iostate state) {
+  state_ = fd_ < 0 ? state | ::std::ios_base::badbit : state;
+}
+
+void FdStream::setstate(::std::ios_base::iostate state) {
+  state_ |= state;
+}
+
+bool FdStream::good() const {
+  return state_ == ::std::ios_base::goodbit;
+}
+
+bool FdStream::eof() const {
+  return (state_ & ::std::ios_base::eofbit) != 0;
+}
+
+bool FdStream::fail() const {
+  return (state_ & (::std::ios_base::failbit | ::std::ios_base::badbit)) != 0;
+}
+
+bool FdStream::bad() const {
+  return (state_ & ::std::ios_base::badbit) != 0;
+}
+
+FdStream::operator bool() const {
+  return !fail();
+}
+
+bool FdStream::operator!() const {
+  return fail();
+}
+
+bool FdStream::flushWrite() {
+  if (write_size_ == 0) {
+    return true;
+  }
+  // Only whole buffers written at aligned offsets qualify for O_DIRECT
+  if (write_size_ != capacity_ ||
+      offset_ % static_cast< off_type >(kDirectAlignment) != 0) {
+    undirect();
+  }
+  bool written = writeAll(write_buffer_, write_size_);
+  write_size_ = 0;
+  return written;
+}
+
+void FdStream::undirect() {
+#ifdef O_DIRECT
+  if (direct_) {
+    int flags = fcntl(fd_, F_GETFL);
+    if (flags >= 0) {
+      fcntl(fd_, F_SETFL, flags & ~O_DIRECT);
+    }
+    direct_ = false;
+  }
+#endif
+}
+
+::std::size_t FdStream::readSome(char_type *s, ::std::size_t n) {
+  for (;;) {
+    ::ssize_t done = seekable_ ? pread(fd_, s, n, offset_) :
+        ::read(fd_, s, n);
+    if (done >= 0) {
+      offset_ += done;
+      return static_cast< ::std::size_t >(done);
+    }
+    if (errno != EINTR) {
+      setstate(::std::ios_base::badbit);
+      return 0;
+    }
+  }
+}
+
+bool FdStream::writeAll(const char_type *s, ::std::size_t n) {
+  while (n > 0) {
+    ::ssize_t done = seekable_ ? pwrite(fd_, s, n, offset_) :
+        ::write(fd_, s, n);
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    offset_ += done;
+    s += done;
+    n -= static_cast< ::std::size_t >(done);
+  }
+  return true;
+}
+
+FdStream::pos_type FdStream::tell() const {
+  return pos_type(offset_ + static_cast< off_type >(write_size_) -
+                  static_cast< off_type >(read_end_ - read_begin_));
+}
+
+void FdStream::seek(off_type off, ::std::ios_base::seekdir dir) {
+  if (!seekable_) {
+    setstate(::std::ios_base::failbit);
+    return;
+  }
+  off_type base = 0;
+  if (dir == ::std::ios_base::cur) {
+    base = off_type(tell());
+  } else if (dir == ::std::ios_base::end) {
+    if (!flushWrite()) {
+      setstate(::std::ios_base::badbit);
+      return;
+    }
+    struct stat status;
+    if (fstat(fd_, &status) != 0) {
+      setstate(::std::ios_base::failbit);
+      return;
+    }
+    base = static_cast< off_type >(status.st_size);
+  }
+  if (base + off < 0) {
+    setstate(::std::ios_base::failbit);
+    return;
+  }
+  if (!flushWrite()) {
+    setstate(::std::ios_base::badbit);
+    return;
+  }
+  read_begin_ = 0;
+  read_end_ = 0;
+  offset_ = base + off;
+}
+
+BufferStream::BufferStream()
+    : data_(nullptr), view_(nullptr), capacity_(0), size_(0), get_(0),
+      put_(0), growable_(true), state_(::std::ios_base::goodbit),
+      gcount_(0) {}
+
+BufferStream::BufferStream(char_type *data, ::std::size_t capacity)
+    : data_(data), view_(data), capacity_(capacity), size_(0), get_(0),
+      put_(0), growable_(false), state_(::std::ios_base::goodbit),
+      gcount_(0) {}
+
+BufferStream::BufferStream(const char_type *data, ::std::size_t size)
+    : data_(nullptr), view_(data), capacity_(0), size_(size), get_(0),
+      put_(0), growable_(false), state_(::std::ios_base::goodbit),
+      gcount_(0) {}
+
+const BufferStream::char_type* BufferStream::data() const {
+  return view_;
+}
+
+::std::size_t BufferStream::size() const {
+  return size_;
+}
+
+::std::string BufferStream::str() const {
+  return size_ == 0 ? ::std::string() : ::std::string(view_, size_);
+}
+
+const BufferStream::char_type* BufferStream::next(::std::size_t n) {
+  if (fail() || n > size_ - get_) {
+    setstate(::std::ios_base::failbit);
+    return nullptr;
+  }
+  const char_type *p = view_ + get_;
+  get_ += n;
+  return p;
+}
+
+BufferStream& BufferStream::write(const char_type *s, ::std::streamsize n) {
+  if (fail() || n <= 0) {
+    return *this;
+  }
+  ::std::size_t bytes = static_cast< ::std::size_t >(n);
+  if (bytes > capacity_ - put_) {
+    if (!growable_) {
+      setstate(::std::ios_base::badbit);
+      return *this;
+    }
+    owned_.resize(::std::max(put_ + bytes, 2 * capacity_));
+    data_ = owned_.data();
+    view_ = data_;
+    capacity_ = owned_.size();
+  }
+  ::std::memcpy(data_ + put_, s, bytes);
+  put_ += bytes;
+  size_ = ::std::max(size_, put_);
+  return *this;
+}
+
+BufferStream& BufferStream::read(char_type *s, ::std::streamsize n) {
+  gcount_ = 0;
+  if (fail() || n <= 0) {
+    if (n > 0) {
+      setstate(::std::ios_base::failbit);
+    }
+    return *this;
+  }
+  ::std::size_t bytes = ::std::min(static_cast< ::std::size_t >(n),
+                                   size_ - get_);
+  if (bytes > 0) {
+    ::std::memcpy(s, view_ + get_, bytes);
+  }
+  get_ += bytes;
+  gcount_ = static_cast< ::std::streamsize >(bytes);
+  if (gcount_ < n) {
+    setstate(::std::ios_base::eofbit | ::std::ios_base::failbit);
+  }
+  return *this;
+}
+
+::std::streamsize BufferStream::gcount() const {
+  return gcount_;
+}
+
+BufferStream& BufferStream::flush() {
+  return *this;
+}
+
+BufferStream::pos_type BufferStream::tellp() const {
+  return fail() ? pos_type(off_type(-1)) : pos_type(off_type(put_));
+}
+
+BufferStream::pos_type BufferStream::tellg() const {
+  return fail() ? pos_type(off_type(-1)) : pos_type(off_type(get_));
+}
+
+BufferStream& BufferStream::seekp(pos_type pos) {
+  return seekp(off_type(pos), ::std::ios_base::beg);
+}
+
+BufferStream& BufferStream::seekp(off_type off,
+                                  ::std::ios_base::seekdir dir) {
+  if (!fail() && (data_ == nullptr || !seek(&put_, off, dir))) {
+    setstate(::std::ios_base::failbit);
+  }
+  return *this;
+}
+
+BufferStream& BufferStream::seekg(pos_type pos) {
+  return seekg(off_type(pos), ::std::ios_base::beg);
+}
+
+BufferStream& BufferStream::seekg(off_type off,
+                                  ::std::ios_base::seekdir dir) {
+  state_ &= ~::std::ios_base::eofbit;
+  if (!fail() && !seek(&get_, off, dir)) {
+    setstate(::std::ios_base::failbit);
+  }
+  return *this;
+}
+
+::std::ios_base::iostate BufferStream::rdstate() const {
+  return state_;
+}
+
+void BufferStream::clear(::std::ios_base::iostate state) {
+  state_ = state;
+}
+
+void BufferStream::setstate(::std::ios_base::iostate state) {
+  state_ |= state;
+}
+
+bool BufferStream::good() const {
+  return state_ == ::std::ios_base::goodbit;
+}
+
+bool BufferStream::eof() const {
+  return (state_ & ::std::ios_base::eofbit) != 0;
+}
+
+bool BufferStream::fail() const {
+  return (state_ & (::std::ios_base::failbit | ::std::ios_base::badbit)) != 0;
+}
+
+bool BufferStream::bad() const {
+  return (state_ & ::std::ios_base::badbit) != 0;
+}
+
+BufferStream::operator bool() const {
+  return !fail();
+}
+
+bool BufferStream::operator!() const {
+  return fail();
+}
+
+bool BufferStream::seek(::std::size_t *position, off_type off,
+                        ::std::ios_base::seekdir dir) {
+  off_type base = dir == ::std::ios_base::beg ? 0 :
+      dir == ::std::ios_base::end ? static_cast< off_type >(size_) :
+      static_cast< off_type >(*position);
+  if (base + off < 0 || base + off > static_cast< off_type >(size_)) {
+    return false;
+  }
+  *position = static_cast< ::std::size_t >(base + off);
+  return true;
+}
+
+}  // namespace serializer
+}  // namespace thunder
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "thunder/serializer/binary_protocol.hpp"
+#include "thunder/serializer/raw_stream.hpp"
 #include "thunder/serializer/serializer.hpp"
 #include "thunder/serializer/static.hpp"
 #include "thunder/serializer/text_protocol.hpp"
@@ -37,11 +38,15 @@ namespace serializer {
 
 template class BinaryProtocol< ::std::stringstream >;
 template class BinaryProtocol< ::std::fstream >;
+template class BinaryProtocol< FdStream >;
+template class BinaryProtocol< BufferStream >;
 template class TextProtocol< ::std::stringstream >;
 template class TextProtocol< ::std::fstream >;
 
 template class Serializer< BinaryProtocol< ::std::stringstream > >;
 template class Serializer< BinaryProtocol< ::std::fstream > >;
+template class Serializer< BinaryProtocol< FdStream > >;
+template class Serializer< BinaryProtocol< BufferStream > >;
 template class Serializer< TextProtocol< ::std::stringstream > >;
 template class Serializer< TextProtocol< ::std::fstream > >;
 
@@ -75,5 +80,30 @@ THUNDER_SERIALIZER_INSTANTIATE_FSTREAM_CONSTRUCTOR(
 
 #undef THUNDER_SERIALIZER_INSTANTIATE_FSTREAM_CONSTRUCTOR
 
+#define THUNDER_SERIALIZER_INSTANTIATE_FDSTREAM_CONSTRUCTOR(P)          \
+  template Serializer< P >::Serializer();                               \
+  template Serializer< P >::Serializer(int fd);                         \
+  template Serializer< P >::Serializer(::std::string path);             \
+  template Serializer< P >::Serializer(                                 \
+      ::std::string path, ::std::ios_base::openmode mode);              \
+  template Serializer< P >::Serializer(                                 \
+      ::std::string path, ::std::ios_base::openmode mode, bool direct);
+
+THUNDER_SERIALIZER_INSTANTIATE_FDSTREAM_CONSTRUCTOR(BinaryProtocol< FdStream >);
+
+#undef THUNDER_SERIALIZER_INSTANTIATE_FDSTREAM_CONSTRUCTOR
+
+#define THUNDER_SERIALIZER_INSTANTIATE_BUFFERSTREAM_CONSTRUCTOR(P)      \
+  template Serializer< P >::Serializer();                               \
+  template Serializer< P >::Serializer(                                 \
+      char *data, ::std::size_t capacity);                              \
+  template Serializer< P >::Serializer(                                 \
+      const char *data, ::std::size_t size);
+
+THUNDER_SERIALIZER_INSTANTIATE_BUFFERSTREAM_CONSTRUCTOR(
+    BinaryProtocol< BufferStream >);
+
+#undef THUNDER_SERIALIZER_INSTANTIATE_BUFFERSTREAM_CONSTRUCTOR
+
 }  // namespace serializer
 }  // namespace thunder
@@ -0,0 +1,596 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/serializer/text_format.hpp"
+
+#include <locale.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace thunder {
+namespace serializer {
+
+namespace {
+
+// Normalized significands and binary exponents of 10^k for k = -348, -340,
+// ..., 340, which scale values into the range Grisu2 works in
+const ::std::uint64_t kPowerSignificands[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+  0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+  0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+  0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+  0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+  0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+  0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+  0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+  0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+  0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+  0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+  0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+  0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+  0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+  0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+  0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+  0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+  0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+  0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+  0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+  0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+  0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+const int kPowerExponents[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954,
+  -927, -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635,
+  -608, -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316,
+  -289, -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30, 56,
+  83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348, 375, 402, 428, 455,
+  481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747, 774, 800, 827, 853,
+  880, 907, 933, 960, 986, 1013, 1039, 1066
+};
+
+const ::std::uint32_t kTens[] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Powers of ten that are exact in each type, for the fast parsing path
+const double kDoubleTens[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const float kFloatTens[] = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+// The C locale, so that the library conversions used on slow paths read and
+// write a point whatever LC_NUMERIC the program runs under
+locale_t cLocale() {
+  static locale_t locale = newlocale(LC_ALL_MASK, "C",
+                                     static_cast< locale_t >(0));
+  if (locale == static_cast< locale_t >(0)) {
+    throw ::std::bad_alloc();
+  }
+  return locale;
+}
+
+// Number f * 2^e with a 64-bit significand
+struct DiyFp {
+  ::std::uint64_t f;
+  int e;
+};
+
+DiyFp normalize(DiyFp x) {
+  while ((x.f & (1ULL << 63)) == 0) {
+    x.f <<= 1;
+    --x.e;
+  }
+  return x;
+}
+
+// Upper 64 bits of the product, rounded
+DiyFp multiply(DiyFp x, DiyFp y) {
+  const ::std::uint64_t mask = 0xffffffffULL;
+  ::std::uint64_t a = x.f >> 32, b = x.f & mask;
+  ::std::uint64_t c = y.f >> 32, d = y.f & mask;
+  ::std::uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  ::std::uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) +
+      (1ULL << 31);
+  DiyFp result = {ac + (ad >> 32) + (bc >> 32) + (middle >> 32),
+                  x.e + y.e + 64};
+  return result;
+}
+
+// Power 10^-k whose product with a number of binary exponent e has a binary
+// exponent in [-60, -32]
+DiyFp cachedPower(int e, int *k) {
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int ik = static_cast< int >(dk);
+  if (dk - ik > 0.0) {
+    ++ik;
+  }
+  int index = (ik >> 3) + 1;
+  *k = 348 - index * 8;
+  DiyFp result = {kPowerSignificands[index], kPowerExponents[index]};
+  return result;
+}
+
+// Move the last digit towards w while staying inside the boundaries
+void roundWeed(char *buffer, int length, ::std::uint64_t delta,
+               ::std::uint64_t rest, ::std::uint64_t ten_kappa,
+               ::std::uint64_t wp_w) {
+  while (rest < wp_w && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+    --buffer[length - 1];
+    rest += ten_kappa;
+  }
+}
+
+// Generate digits of mp until the remainder falls within delta
+void generateDigits(DiyFp w, DiyFp mp, ::std::uint64_t delta, char *buffer,
+                    int *length, int *k) {
+  const DiyFp one = {1ULL << -mp.e, mp.e};
+  const ::std::uint64_t wp_w = mp.f - w.f;
+  ::std::uint32_t p1 = static_cast< ::std::uint32_t >(mp.f >> -one.e);
+  ::std::uint64_t p2 = mp.f & (one.f - 1);
+  int kappa = 1;
+  while (kappa < 10 && p1 >= kTens[kappa]) {
+    ++kappa;
+  }
+  *length = 0;
+  while (kappa > 0) {
+    ::std::uint32_t d = p1 / kTens[kappa - 1];
+    p1 %= kTens[kappa - 1];
+    if (d != 0 || *length != 0) {
+      buffer[(*length)++] = static_cast< char >('0' + d);
+    }
+    --kappa;
+    ::std::uint64_t rest = (static_cast< ::std::uint64_t >(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      *k += kappa;
+      roundWeed(buffer, *length, delta, rest,
+                static_cast< ::std::uint64_t >(kTens[kappa]) << -one.e, wp_w);
+      return;
+    }
+  }
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    char d = static_cast< char >(p2 >> -one.e);
+    if (d != 0 || *length != 0) {
+      buffer[(*length)++] = static_cast< char >('0' + d);
+    }
+    p2 &= one.f - 1;
+    --kappa;
+    if (p2 < delta) {
+      *k += kappa;
+      roundWeed(buffer, *length, delta, p2, one.f,
+                -kappa < 10 ? wp_w * kTens[-kappa] : 0);
+      return;
+    }
+  }
+}
+
+// Grisu2 digits of f * 2^e, which is positive. The result times 10^k lies
+// strictly between the halfway points to the neighbouring values, so it
+// always reads back exactly, and is the shortest such string for nearly all
+// values. The lower neighbour is closer when f is a power of two.
+void grisu2(::std::uint64_t f, int e, bool lower_closer, char *buffer,
+            int *length, int *k) {
+  DiyFp plus = {(f << 1) + 1, e - 1};
+  plus = normalize(plus);
+  DiyFp minus = {lower_closer ? (f << 2) - 1 : (f << 1) - 1,
+                 lower_closer ? e - 2 : e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  DiyFp value = {f, e};
+
+  DiyFp c = cachedPower(plus.e, k);
+  DiyFp w = multiply(normalize(value), c);
+  DiyFp wp = multiply(plus, c);
+  DiyFp wm = multiply(minus, c);
+  ++wm.f;
+  --wp.f;
+  generateDigits(w, wp, wp.f - wm.f, buffer, length, k);
+}
+
+// Lay out digits times 10^k in fixed notation for moderate exponents and in
+// scientific notation otherwise
+::std::size_t formatDigits(const char *digits, int length, int k,
+                           bool negative, char *buffer) {
+  char *p = buffer;
+  if (negative) {
+    *p++ = '-';
+  }
+  int point = length + k;
+  if (k >= 0 && point <= 15) {
+    ::std::memcpy(p, digits, length);
+    p += length;
+    for (int i = 0; i < k; ++i) {
+      *p++ = '0';
+    }
+  } else if (point > 0 && point <= 15) {
+    ::std::memcpy(p, digits, point);
+    p += point;
+    *p++ = '.';
+    ::std::memcpy(p, digits + point, length - point);
+    p += length - point;
+  } else if (point > -5 && point <= 0) {
+    *p++ = '0';
+    *p++ = '.';
+    for (int i = point; i < 0; ++i) {
+      *p++ = '0';
+    }
+    ::std::memcpy(p, digits, length);
+    p += length;
+  } else {
+    *p++ = digits[0];
+    if (length > 1) {
+      *p++ = '.';
+      ::std::memcpy(p, digits + 1, length - 1);
+      p += length - 1;
+    }
+    int exponent = point - 1;
+    *p++ = 'e';
+    *p++ = exponent < 0 ? '-' : '+';
+    exponent = exponent < 0 ? -exponent : exponent;
+    if (exponent >= 100) {
+      *p++ = static_cast< char >('0' + exponent / 100);
+    }
+    *p++ = static_cast< char >('0' + exponent / 10 % 10);
+    *p++ = static_cast< char >('0' + exponent % 10);
+  }
+  return static_cast< ::std::size_t >(p - buffer);
+}
+
+// Special values, or zero if t is finite and nonzero
+::std::size_t formatSpecial(bool nan, bool inf, bool zero, bool negative,
+                            char *buffer) {
+  const char *s = nan ? "nan" : inf ? (negative ? "-inf" : "inf") :
+      zero ? (negative ? "-0" : "0") : "";
+  ::std::size_t n = ::std::strlen(s);
+  ::std::memcpy(buffer, s, n);
+  return n;
+}
+
+template < typename T >
+::std::size_t formatBinary(T t, char *buffer) {
+  ::std::size_t n = formatSpecial(::std::isnan(t), ::std::isinf(t), t == 0,
+                                  ::std::signbit(t), buffer);
+  if (n > 0) {
+    return n;
+  }
+
+  // Split into significand and exponent, with subnormal numbers sharing the
+  // exponent of the smallest normal one
+  typedef typename ::std::conditional< sizeof(T) == 4, ::std::uint32_t,
+                                       ::std::uint64_t >::type bits_type;
+  const int bits = ::std::numeric_limits< T >::digits - 1;
+  const int bias = ::std::numeric_limits< T >::max_exponent - 1 + bits;
+  bits_type u;
+  ::std::memcpy(&u, &t, sizeof(T));
+  ::std::uint64_t significand = u & ((static_cast< bits_type >(1) << bits) - 1);
+  int biased = static_cast< int >((u >> bits) &
+                                  ((static_cast< bits_type >(1) <<
+                                    (sizeof(T) * 8 - 1 - bits)) - 1));
+  ::std::uint64_t f = biased == 0 ? significand :
+      significand | (1ULL << bits);
+  int e = (biased == 0 ? 1 : biased) - bias;
+
+  char digits[24];
+  int length = 0, k = 0;
+  grisu2(f, e, significand == 0 && biased > 1, digits, &length, &k);
+  return formatDigits(digits, length, k, ::std::signbit(t), buffer);
+}
+
+// Long double has no fast path. Precision grows from the digits every value
+// keeps until the value reads back.
+::std::size_t formatLong(long double t, char *buffer) {
+  ::std::size_t n = formatSpecial(::std::isnan(t), ::std::isinf(t), t == 0,
+                                  ::std::signbit(t), buffer);
+  if (n > 0) {
+    return n;
+  }
+  int m = 0;
+  locale_t previous = uselocale(cLocale());
+  for (int precision = ::std::numeric_limits< long double >::digits10;
+       precision <= ::std::numeric_limits< long double >::max_digits10;
+       ++precision) {
+    m = ::std::snprintf(buffer, kTextNumberSize, "%.*Lg", precision, t);
+    if (strtold_l(buffer, nullptr, cLocale()) == t) {
+      break;
+    }
+  }
+  uselocale(previous);
+  return static_cast< ::std::size_t >(m);
+}
+
+// Split a decimal token into up to 19 significant digits and a decimal
+// exponent. Anything else, including inf and nan, is rejected.
+bool parseDecimal(const char *token, ::std::size_t n, bool *negative,
+                  ::std::uint64_t *mantissa, int *digits, int *exponent) {
+  ::std::size_t i = 0;
+  *negative = false;
+  if (i < n && (token[i] == '-' || token[i] == '+')) {
+    *negative = token[i] == '-';
+    ++i;
+  }
+  *mantissa = 0;
+  *digits = 0;
+  *exponent = 0;
+  bool any = false;
+  bool point = false;
+  for (; i < n; ++i) {
+    char c = token[i];
+    if (c >= '0' && c <= '9') {
+      any = true;
+      if (*digits == 0 && c == '0') {
+        *exponent -= point ? 1 : 0;
+      } else if (*digits < 19) {
+        *mantissa = *mantissa * 10 + static_cast< ::std::uint64_t >(c - '0');
+        *exponent -= point ? 1 : 0;
+        ++*digits;
+      } else {
+        *exponent += point ? 0 : 1;
+        ++*digits;
+      }
+    } else if (c == '.' && !point) {
+      point = true;
+    } else {
+      break;
+    }
+  }
+  if (!any) {
+    return false;
+  }
+  if (i < n && (token[i] == 'e' || token[i] == 'E')) {
+    ++i;
+    bool negative_exponent = false;
+    if (i < n && (token[i] == '-' || token[i] == '+')) {
+      negative_exponent = token[i] == '-';
+      ++i;
+    }
+    if (i == n) {
+      return false;
+    }
+    int value = 0;
+    for (; i < n; ++i) {
+      if (token[i] < '0' || token[i] > '9') {
+        return false;
+      }
+      value = value < 100000 ? value * 10 + (token[i] - '0') : value;
+    }
+    *exponent += negative_exponent ? -value : value;
+  }
+  return i == n;
+}
+
+// Values whose digits fit in the significand and whose power of ten is exact
+// are computed with one rounding, as the library parsers would (Clinger)
+bool parseExact(bool negative, ::std::uint64_t mantissa, int digits,
+                int exponent, double *t) {
+  if (digits > 19 || mantissa > (1ULL << 53) || exponent < -22 ||
+      exponent > 22) {
+    return false;
+  }
+  double value = static_cast< double >(mantissa);
+  value = exponent < 0 ? value / kDoubleTens[-exponent] :
+      value * kDoubleTens[exponent];
+  *t = negative ? -value : value;
+  return true;
+}
+
+bool parseExact(bool negative, ::std::uint64_t mantissa, int digits,
+                int exponent, float *t) {
+  if (digits > 19 || mantissa > (1ULL << 24) || exponent < -10 ||
+      exponent > 10) {
+    return false;
+  }
+  float value = static_cast< float >(mantissa);
+  value = exponent < 0 ? value / kFloatTens[-exponent] :
+      value * kFloatTens[exponent];
+  *t = negative ? -value : value;
+  return true;
+}
+
+bool parseExact(bool, ::std::uint64_t, int, int, long double *) {
+  return false;
+}
+
+double toFloat(const char *s, char **end, double) {
+  return strtod_l(s, end, cLocale());
+}
+
+float toFloat(const char *s, char **end, float) {
+  return strtof_l(s, end, cLocale());
+}
+
+long double toFloat(const char *s, char **end, long double) {
+  return strtold_l(s, end, cLocale());
+}
+
+template < typename T >
+bool parseFloat(const char *token, ::std::size_t n, T *t) {
+  *t = 0;
+  bool negative = false;
+  ::std::uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  if (parseDecimal(token, n, &negative, &mantissa, &digits, &exponent) &&
+      parseExact(negative, mantissa, digits, exponent, t)) {
+    return true;
+  }
+
+  char buffer[kTextNumberSize];
+  if (n == 0 || n >= kTextNumberSize) {
+    return false;
+  }
+  ::std::memcpy(buffer, token, n);
+  buffer[n] = '\0';
+  char *end = nullptr;
+  errno = 0;
+  T value = toFloat(buffer, &end, T());
+  if (end != buffer + n) {
+    return false;
+  }
+  // Underflow to subnormal values is accepted as correctly rounded
+  if (errno == ERANGE && ::std::isinf(value)) {
+    *t = value < 0 ? -::std::numeric_limits< T >::max() :
+        ::std::numeric_limits< T >::max();
+    return false;
+  }
+  *t = value;
+  return true;
+}
+
+// Digits of an optionally signed integer token. A magnitude too large for
+// unsigned long long sets *overflow and saturates.
+bool parseInteger(const char *token, ::std::size_t n, bool *negative,
+                  unsigned long long *t, bool *overflow) {
+  ::std::size_t i = 0;
+  *negative = false;
+  *overflow = false;
+  if (n > 0 && (token[0] == '-' || token[0] == '+')) {
+    *negative = token[0] == '-';
+    ++i;
+  }
+  if (i == n) {
+    return false;
+  }
+  const unsigned long long limit =
+      ::std::numeric_limits< unsigned long long >::max();
+  *t = 0;
+  for (; i < n; ++i) {
+    if (token[i] < '0' || token[i] > '9') {
+      return false;
+    }
+    unsigned long long digit = static_cast< unsigned long long >(
+        token[i] - '0');
+    if (*overflow || *t > (limit - digit) / 10) {
+      *overflow = true;
+      *t = limit;
+    } else {
+      *t = *t * 10 + digit;
+    }
+  }
+  return true;
+}
+
+::std::size_t formatInteger(unsigned long long t, bool negative,
+                            char *buffer) {
+  char digits[kTextNumberSize];
+  char *end = digits + kTextNumberSize;
+  char *p = end;
+  do {
+    *--p = static_cast< char >('0' + t % 10);
+    t /= 10;
+  } while (t != 0);
+  if (negative) {
+    *--p = '-';
+  }
+  ::std::size_t n = static_cast< ::std::size_t >(end - p);
+  ::std::memcpy(buffer, p, n);
+  return n;
+}
+
+}  // namespace
+
+::std::size_t formatNumber(long long t, char *buffer) {
+  unsigned long long magnitude = t < 0 ?
+      0ULL - static_cast< unsigned long long >(t) :
+      static_cast< unsigned long long >(t);
+  return formatInteger(magnitude, t < 0, buffer);
+}
+
+::std::size_t formatNumber(unsigned long long t, char *buffer) {
+  return formatInteger(t, false, buffer);
+}
+
+::std::size_t formatNumber(float t, char *buffer) {
+  return formatBinary(t, buffer);
+}
+
+::std::size_t formatNumber(double t, char *buffer) {
+  return formatBinary(t, buffer);
+}
+
+::std::size_t formatNumber(long double t, char *buffer) {
+  return formatLong(t, buffer);
+}
+
+bool parseNumber(const char *token, ::std::size_t n, long long *t) {
+  bool negative = false, overflow = false;
+  unsigned long long magnitude = 0;
+  *t = 0;
+  if (!parseInteger(token, n, &negative, &magnitude, &overflow)) {
+    return false;
+  }
+  const unsigned long long limit = static_cast< unsigned long long >(
+      ::std::numeric_limits< long long >::max());
+  if (overflow || magnitude > limit + (negative ? 1 : 0)) {
+    *t = negative ? ::std::numeric_limits< long long >::min() :
+        ::std::numeric_limits< long long >::max();
+    return false;
+  }
+  *t = negative ? static_cast< long long >(0ULL - magnitude) :
+      static_cast< long long >(magnitude);
+  return true;
+}
+
+bool parseNumber(const char *token, ::std::size_t n, unsigned long long *t) {
+  bool negative = false, overflow = false;
+  if (!parseInteger(token, n, &negative, t, &overflow)) {
+    *t = 0;
+    return false;
+  }
+  // Negative values are out of range, with zero the nearest
+  if (negative && *t != 0) {
+    *t = 0;
+    return false;
+  }
+  return !overflow;
+}
+
+bool parseNumber(const char *token, ::std::size_t n, float *t) {
+  return parseFloat(token, n, t);
+}
+
+bool parseNumber(const char *token, ::std::size_t n, double *t) {
+  return parseFloat(token, n, t);
+}
+
+bool parseNumber(const char *token, ::std::size_t n, long double *t) {
+  return parseFloat(token, n, t);
+}
+
+}  // namespace serializer
+}  // namespace thunder
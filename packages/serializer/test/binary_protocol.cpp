@@ -19,10 +19,19 @@
 
 #include "thunder/serializer/binary_protocol.hpp"
 
+#include <complex>
 #include <sstream>
+#include <string>
+#include <utility>
 
 #include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/serializer/serializer.hpp"
+#include "thunder/serializer/static.hpp"
+
 #include "thunder/serializer/binary_protocol-inl.hpp"
+#include "thunder/serializer/serializer-inl.hpp"
+#include "thunder/serializer/static-inl.hpp"
 
 namespace thunder {
 namespace serializer {
@@ -122,5 +131,97 @@ TEST(BinaryProtocolTest, floatTest) {
   floatTest< long double >();
 }
 
+template < typename T >
+void arrayTest() {
+  Serializer< BinaryProtocol< ::std::stringstream > > s;
+
+  T saved[100];
+  T loaded[100];
+  for (int i = 0; i < 100; ++i) {
+    saved[i] = static_cast< T >(i * 3);
+    loaded[i] = static_cast< T >(0);
+  }
+  s.saveArray(saved, 100);
+  EXPECT_EQ(4 + 100 * sizeof(T), s.protocol().stream().str().size());
+  s.loadArray(loaded, 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(saved[i], loaded[i]);
+  }
+}
+
+TEST(BinaryProtocolTest, arrayTest) {
+  arrayTest< char >();
+  arrayTest< int >();
+  arrayTest< unsigned long >();
+  arrayTest< float >();
+  arrayTest< double >();
+  arrayTest< ::std::complex< float > >();
+  arrayTest< ::std::complex< double > >();
+
+  // Elements without bulk support are saved one by one with no header
+  Serializer< BinaryProtocol< ::std::stringstream > > s;
+  ::std::pair< int, int > saved[3] = {{1, 2}, {3, 4}, {5, 6}};
+  ::std::pair< int, int > loaded[3];
+  s.saveArray(saved, 3);
+  EXPECT_EQ(6 * sizeof(int), s.protocol().stream().str().size());
+  s.loadArray(loaded, 3);
+  EXPECT_EQ(saved[2], loaded[2]);
+}
+
+TEST(BinaryProtocolTest, byteOrderTest) {
+  // Arrays written on a machine of the other byte order are swapped
+  unsigned short probe = 1;
+  bool little = *reinterpret_cast< unsigned char* >(&probe) == 1;
+  ::std::string bytes;
+  bytes.push_back(static_cast< char >(0xA7));
+  bytes.push_back(static_cast< char >(sizeof(unsigned int)));
+  bytes.push_back(static_cast< char >(little ? 2 : 1));
+  bytes.push_back(static_cast< char >(1));
+  unsigned int values[2] = {0x01020304, 0x0A0B0C0D};
+  bytes.append(reinterpret_cast< const char* >(values), sizeof(values));
+
+  Serializer< BinaryProtocol< ::std::stringstream > > s(bytes);
+  unsigned int loaded[2];
+  s.loadArray(loaded, 2);
+  EXPECT_EQ(0x04030201u, loaded[0]);
+  EXPECT_EQ(0x0D0C0B0Au, loaded[1]);
+
+  // Element size mismatches are detected
+  Serializer< BinaryProtocol< ::std::stringstream > > t;
+  t.saveArray(values, 2);
+  double wrong[1];
+  EXPECT_THROW(t.loadArray(wrong, 1), io_error);
+}
+
+TEST(BinaryProtocolTest, legacyTest) {
+  // Arrays written before the header are raw elements in native byte order,
+  // including ones whose first byte looks like a magic byte
+  int values[3] = {0xA7, 5, -6};
+  ::std::string bytes(reinterpret_cast< const char* >(values), sizeof(values));
+  Serializer< BinaryProtocol< ::std::stringstream > > s(bytes);
+  int loaded[3];
+  s.loadArray(loaded, 3);
+  EXPECT_EQ(0xA7, loaded[0]);
+  EXPECT_EQ(5, loaded[1]);
+  EXPECT_EQ(-6, loaded[2]);
+
+  // So are storages, which save their size before the array
+  Serializer< BinaryProtocol< ::std::stringstream > > t;
+  t.save(static_cast< unsigned long >(2));
+  double pair[2] = {1.5, -2.5};
+  t.protocol().stream().write(
+      reinterpret_cast< const char* >(pair), sizeof(pair));
+  unsigned long size = 0;
+  double loaded_pair[2];
+  t.load(&size);
+  t.loadArray(loaded_pair, size);
+  EXPECT_EQ(-2.5, loaded_pair[1]);
+
+  // Empty arrays are written as nothing
+  Serializer< BinaryProtocol< ::std::stringstream > > u;
+  u.saveArray(pair, 0);
+  EXPECT_EQ(0, u.protocol().stream().str().size());
+}
+
 }  // namespace serializer
 }  // namespace thunder
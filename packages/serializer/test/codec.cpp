@@ -0,0 +1,161 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/serializer/codec.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/serializer.hpp"
+#include "thunder/serializer/binary_protocol-inl.hpp"
+#include "thunder/serializer/serializer-inl.hpp"
+
+namespace thunder {
+namespace serializer {
+namespace {
+
+void blockTest(const ::std::vector< char > &data) {
+  ::std::vector< char > compressed(compressBound(data.size()));
+  ::std::size_t m = compressBlock(data.data(), data.size(), compressed.data());
+  ASSERT_LE(m, compressed.size());
+  ::std::vector< char > decompressed(data.size());
+  EXPECT_TRUE(decompressBlock(compressed.data(), m, decompressed.data(),
+                              decompressed.size()));
+  EXPECT_EQ(data, decompressed);
+  if (m > 1) {
+    EXPECT_FALSE(decompressBlock(compressed.data(), m - 1,
+                                 decompressed.data(), decompressed.size()));
+  }
+}
+
+TEST(CodecTest, blockTest) {
+  ::std::mt19937 generator(7);
+  ::std::vector< char > data;
+  blockTest(data);
+  for (::std::size_t n : {1, 12, 13, 100, 70000, 1048576}) {
+    data.assign(n, 0);
+    blockTest(data);
+    for (::std::size_t i = 0; i < n; ++i) {
+      data[i] = static_cast< char >(generator());
+    }
+    blockTest(data);
+    for (::std::size_t i = 0; i < n; ++i) {
+      data[i] = static_cast< char >(generator() % 4 == 0 ? i % 7 : 0);
+    }
+    blockTest(data);
+  }
+
+  data.assign(1048576, 0);
+  ::std::vector< char > compressed(compressBound(data.size()));
+  EXPECT_GT(data.size() / 100,
+            compressBlock(data.data(), data.size(), compressed.data()));
+}
+
+TEST(CodecTest, shuffleTest) {
+  const char data[] = "abcdefghijkl";
+  char shuffled[12];
+  shuffleBytes(data, 3, 4, shuffled);
+  EXPECT_EQ("aeibfjcgkdhl", ::std::string(shuffled, 12));
+  char unshuffled[12];
+  unshuffleBytes(shuffled, 3, 4, unshuffled);
+  EXPECT_EQ("abcdefghijkl", ::std::string(unshuffled, 12));
+}
+
+TEST(CodecTest, checksumTest) {
+  EXPECT_EQ(0xE3069283u, checksum("123456789", 9));
+  EXPECT_EQ(0u, checksum("", 0));
+}
+
+template < typename T >
+void arrayTest(Codec codec) {
+  ::std::mt19937 generator(13);
+  ::std::vector< T > saved(300000);
+  for (::std::size_t i = 0; i < saved.size(); ++i) {
+    saved[i] = generator() % 3 == 0 ? static_cast< T >(i % 17) : T(0);
+  }
+  StringBinarySerializer s;
+  s.protocol().setCodec(codec);
+  s.saveArray(saved.data(), saved.size());
+  ::std::size_t bytes = s.protocol().stream().str().size();
+  if (codec != Codec::kNone) {
+    EXPECT_GT(saved.size() * sizeof(T) / 2, bytes);
+  }
+  ::std::vector< T > loaded(saved.size());
+  s.loadArray(loaded.data(), loaded.size());
+  EXPECT_EQ(saved, loaded);
+}
+
+TEST(CodecTest, arrayTest) {
+  for (Codec codec : {Codec::kNone, Codec::kLz, Codec::kShuffleLz}) {
+    arrayTest< int >(codec);
+    arrayTest< float >(codec);
+    arrayTest< double >(codec);
+    arrayTest< ::std::complex< double > >(codec);
+  }
+}
+
+TEST(CodecTest, mixedTest) {
+  ::std::vector< double > large(5000, 1.5);
+  ::std::vector< double > small(10, 2.5);
+  StringBinarySerializer s;
+  s.protocol().setCodec(Codec::kShuffleLz);
+  s.saveArray(large.data(), large.size());
+  s.saveArray(small.data(), small.size());
+  s.protocol().setCodec(Codec::kNone);
+  s.saveArray(large.data(), large.size());
+
+  StringBinarySerializer t(s.protocol().stream().str());
+  ::std::vector< double > loaded(large.size());
+  t.loadArray(loaded.data(), loaded.size());
+  EXPECT_EQ(large, loaded);
+  loaded.resize(small.size());
+  t.loadArray(loaded.data(), loaded.size());
+  EXPECT_EQ(small, loaded);
+  loaded.resize(large.size());
+  t.loadArray(loaded.data(), loaded.size());
+  EXPECT_EQ(large, loaded);
+}
+
+TEST(CodecTest, corruptTest) {
+  ::std::vector< float > saved(100000, 0.25f);
+  StringBinarySerializer s;
+  s.protocol().setCodec(Codec::kLz);
+  s.saveArray(saved.data(), saved.size());
+  ::std::string str = s.protocol().stream().str();
+  ::std::vector< float > loaded(saved.size());
+
+  // Flip a bit of the first block checksum
+  ::std::string corrupt = str;
+  corrupt[5 + 4] ^= 1;
+  StringBinarySerializer t(corrupt);
+  EXPECT_THROW(t.loadArray(loaded.data(), loaded.size()), io_error);
+
+  StringBinarySerializer u(str.substr(0, str.size() - 1));
+  EXPECT_THROW(u.loadArray(loaded.data(), loaded.size()), io_error);
+}
+
+}  // namespace
+}  // namespace serializer
+}  // namespace thunder
@@ -0,0 +1,214 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/serializer/raw_stream.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "thunder/serializer.hpp"
+#include "thunder/serializer/binary_protocol-inl.hpp"
+#include "thunder/serializer/serializer-inl.hpp"
+#include "thunder/test/temporary_file.hpp"
+
+namespace thunder {
+namespace serializer {
+namespace {
+
+using test::temporaryFile;
+
+template < typename S >
+void save(S *s) {
+  s->save(7);
+  s->save(-2.5);
+  ::std::vector< double > array(10000);
+  for (::std::size_t i = 0; i < array.size(); ++i) {
+    array[i] = static_cast< double >(i) / 3;
+  }
+  s->saveArray(array.data(), array.size());
+  ::std::shared_ptr< int > pointer = ::std::make_shared< int >(11);
+  s->save(pointer);
+  s->save(pointer);
+}
+
+template < typename S >
+void load(S *s) {
+  int integer = 0;
+  s->load(&integer);
+  EXPECT_EQ(7, integer);
+  double real = 0;
+  s->load(&real);
+  EXPECT_EQ(-2.5, real);
+  ::std::vector< double > array(10000);
+  s->loadArray(array.data(), array.size());
+  for (::std::size_t i = 0; i < array.size(); ++i) {
+    EXPECT_EQ(static_cast< double >(i) / 3, array[i]);
+  }
+  ::std::shared_ptr< int > first, second;
+  s->load(&first);
+  s->load(&second);
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(11, *first);
+  EXPECT_EQ(first, second);
+}
+
+TEST(RawStreamTest, fdTest) {
+  ::std::string path = temporaryFile();
+  for (bool direct : {false, true}) {
+    {
+      FdBinarySerializer s(path, ::std::ios_base::out, direct);
+      ASSERT_TRUE(s.protocol().stream().good());
+      save(&s);
+      s.saveNamed("answer", 42);
+      s.saveNamed("ratio", 0.75);
+      s.saveIndex();
+      s.protocol().stream().flush();
+      EXPECT_TRUE(s.protocol().stream().good());
+    }
+    {
+      FdBinarySerializer s(path, ::std::ios_base::in);
+      load(&s);
+      EXPECT_EQ(0.75, s.loadNamed< double >("ratio"));
+      EXPECT_EQ(42, s.loadNamed< int >("answer"));
+      int extra = 0;
+      s.protocol().stream().seekg(0, ::std::ios_base::end);
+      s.load(&extra);
+      EXPECT_TRUE(s.protocol().stream().eof());
+    }
+  }
+  ::std::remove(path.c_str());
+}
+
+TEST(RawStreamTest, fdSmallBufferTest) {
+  ::std::string path = temporaryFile();
+  FdBinarySerializer s(path, ::std::ios_base::in | ::std::ios_base::out |
+                       ::std::ios_base::trunc, false, 4096);
+  save(&s);
+  s.protocol().stream().seekg(0);
+  load(&s);
+  ::std::remove(path.c_str());
+}
+
+TEST(RawStreamTest, fdOffsetTest) {
+  // Streams over a borrowed descriptor start at its offset and leave it at
+  // their own position
+  ::std::string path = temporaryFile();
+  int fd = open(path.c_str(), O_RDWR);
+  ASSERT_LE(0, fd);
+  ASSERT_EQ(4, ::write(fd, "head", 4));
+  {
+    FdStream stream(fd);
+    stream.write("body", 4);
+  }
+  EXPECT_EQ(8, lseek(fd, 0, SEEK_CUR));
+  lseek(fd, 2, SEEK_SET);
+  {
+    FdStream stream(fd);
+    char bytes[3] = {};
+    stream.read(bytes, 2);
+    EXPECT_EQ(::std::string("ad"), bytes);
+  }
+  EXPECT_EQ(4, lseek(fd, 0, SEEK_CUR));
+  close(fd);
+  ::std::remove(path.c_str());
+}
+
+TEST(RawStreamTest, pipeTest) {
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  {
+    FdBinarySerializer s(fds[1]);
+    s.save(3.25);
+    s.save(-9);
+    s.protocol().stream().seekp(0);
+    EXPECT_TRUE(s.protocol().stream().fail());
+    s.protocol().stream().clear();
+  }
+  close(fds[1]);
+  {
+    FdBinarySerializer s(fds[0]);
+    double real = 0;
+    s.load(&real);
+    EXPECT_EQ(3.25, real);
+    int integer = 0;
+    s.load(&integer);
+    EXPECT_EQ(-9, integer);
+    s.load(&real);
+    EXPECT_TRUE(s.protocol().stream().eof());
+  }
+  close(fds[0]);
+}
+
+TEST(RawStreamTest, bufferTest) {
+  BufferBinarySerializer s;
+  save(&s);
+  load(&s);
+
+  BufferStream &stream = s.protocol().stream();
+  ::std::vector< char > bytes(stream.data(), stream.data() + stream.size());
+  BufferBinarySerializer view(
+      static_cast< const char* >(bytes.data()), bytes.size());
+  load(&view);
+  EXPECT_EQ(bytes.size(), static_cast< ::std::size_t >(
+      view.protocol().stream().tellg()));
+  view.save(1);
+  EXPECT_TRUE(view.protocol().stream().bad());
+}
+
+TEST(RawStreamTest, callerBufferTest) {
+  char buffer[128];
+  BufferBinarySerializer s(buffer, sizeof(buffer));
+  s.save(1.5);
+  s.saveNamed("three", 3);
+  s.saveIndex();
+  EXPECT_FALSE(s.protocol().stream().fail());
+  EXPECT_EQ(s.protocol().stream().data(), buffer);
+
+  BufferBinarySerializer view(static_cast< const char* >(buffer),
+                              s.protocol().stream().size());
+  EXPECT_EQ(3, view.loadNamed< int >("three"));
+
+  double values[32] = {0};
+  s.saveArray(values, 32);
+  EXPECT_TRUE(s.protocol().stream().bad());
+}
+
+TEST(RawStreamTest, nextTest) {
+  const char bytes[] = "zero-copy";
+  BufferStream stream(bytes, sizeof(bytes) - 1);
+  const char *zero = stream.next(4);
+  EXPECT_EQ(bytes, zero);
+  stream.seekg(1, ::std::ios_base::cur);
+  const char *copy = stream.next(4);
+  EXPECT_EQ(bytes + 5, copy);
+  EXPECT_EQ(nullptr, stream.next(1));
+  EXPECT_TRUE(stream.fail());
+}
+
+}  // namespace
+}  // namespace serializer
+}  // namespace thunder
@@ -23,9 +23,13 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "thunder/exception.hpp"
 #include "thunder/serializer.hpp"
+#include "thunder/serializer/binary_protocol.hpp"
+#include "thunder/serializer/binary_protocol-inl.hpp"
 #include "thunder/serializer/serializer-inl.hpp"
 #include "thunder/serializer/text_protocol.hpp"
 #include "thunder/serializer/text_protocol-inl.hpp"
@@ -208,5 +212,87 @@ TEST(SerializerTest, pointerTest) {
   pointerTest< StringTextSerializer, int >();
 }
 
+template < typename S >
+void sharedTest() {
+  S s;
+  ::std::shared_ptr< int > shared = ::std::make_shared< int >(7);
+  s.save(shared);
+  s.save(shared);
+  s.save(shared.get());
+
+  // The shared pointer loaded first goes away before the key is seen again
+  ::std::shared_ptr< int > *first = new ::std::shared_ptr< int >();
+  s.load(first);
+  ::std::shared_ptr< int > kept = *first;
+  delete first;
+  ::std::shared_ptr< int > *other =
+      new ::std::shared_ptr< int >(::std::make_shared< int >(9));
+
+  ::std::shared_ptr< int > second;
+  int *third = nullptr;
+  s.load(&second);
+  s.load(&third);
+  EXPECT_EQ(7, *kept);
+  EXPECT_EQ(kept, second);
+  EXPECT_EQ(kept.get(), third);
+  delete other;
+}
+
+TEST(SerializerTest, sharedTest) {
+  sharedTest< StringTextSerializer >();
+  sharedTest< StringBinarySerializer >();
+}
+
+template < typename S >
+void namedTest() {
+  S s;
+  for (int i = 0; i < 100; ++i) {
+    s.saveNamed("layer" + ::std::to_string(i) + ".weight", i * 0.5);
+  }
+  ::std::shared_ptr< int > shared = ::std::make_shared< int >(7);
+  s.saveNamed("shared", shared);
+  EXPECT_THROW(s.saveNamed("shared", shared), invalid_argument);
+  s.saveIndex();
+
+  // A new serializer reads the index and seeks to single records
+  S t(s.protocol().stream().str());
+  const ::std::vector< ::std::string > &names = t.names();
+  ASSERT_EQ(101, names.size());
+  EXPECT_EQ("layer0.weight", names[0]);
+  EXPECT_EQ("shared", names[100]);
+  EXPECT_TRUE(t.containsNamed("layer42.weight"));
+  EXPECT_FALSE(t.containsNamed("layer100.weight"));
+  EXPECT_EQ(21.0, t.template loadNamed< double >("layer42.weight"));
+  EXPECT_EQ(1.5, t.template loadNamed< double >("layer3.weight"));
+  ::std::shared_ptr< int > shared_loaded;
+  t.loadNamed("shared", &shared_loaded);
+  EXPECT_EQ(7, *shared_loaded);
+  EXPECT_EQ(49.5, t.template loadNamed< double >("layer99.weight"));
+  double missing;
+  EXPECT_THROW(t.loadNamed("missing", &missing), out_of_range);
+
+  // Streams without an index are rejected
+  S u;
+  u.save(1.0);
+  EXPECT_THROW(u.loadIndex(), io_error);
+
+  // Writers use their own index, also before saving any named record
+  S v;
+  v.save(1.0);
+  EXPECT_TRUE(v.names().empty());
+  EXPECT_FALSE(v.containsNamed("shared"));
+  v.saveNamed("half", 0.5);
+  ASSERT_EQ(1, v.names().size());
+  EXPECT_TRUE(v.containsNamed("half"));
+  EXPECT_EQ(0.5, v.template loadNamed< double >("half"));
+  S w;
+  EXPECT_THROW(w.names(), io_error);
+}
+
+TEST(SerializerTest, namedTest) {
+  namedTest< StringTextSerializer >();
+  namedTest< StringBinarySerializer >();
+}
+
 }  // namespace serializer
 }  // namespace thunder
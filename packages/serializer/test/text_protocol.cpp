@@ -19,7 +19,11 @@
 
 #include "thunder/serializer/text_protocol.hpp"
 
+#include <clocale>
+#include <cmath>
+#include <limits>
 #include <sstream>
+#include <string>
 
 #include "gtest/gtest.h"
 #include "thunder/serializer/text_protocol-inl.hpp"
@@ -122,5 +126,127 @@ TEST(TextProtocolTest, floatTest) {
   floatTest< long double >();
 }
 
+template < typename T >
+void roundTripTest() {
+  typedef ::std::numeric_limits< T > limits;
+  TextProtocol< ::std::stringstream> t;
+  T values[] = {static_cast< T >(0.1), static_cast< T >(1) / 3, -0.0,
+                limits::max(), limits::lowest(), limits::min(),
+                limits::denorm_min(), limits::epsilon(), limits::infinity(),
+                -limits::infinity(), 123456, static_cast< T >(-1e-30)};
+  for (const T &value : values) {
+    t.save(&value, value);
+  }
+  // Values from a simple generator cover all the digit counts
+  unsigned long long state = 42;
+  for (int i = 0; i < 1000; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    T value = static_cast< T >(static_cast< double >(state >> 11) /
+                               static_cast< double >(1ULL << 40));
+    t.save(&value, value);
+  }
+  T nan = limits::quiet_NaN();
+  t.save(&nan, nan);
+
+  for (const T &value : values) {
+    T loaded = 0;
+    t.load(&loaded, &loaded);
+    EXPECT_EQ(value, loaded);
+    EXPECT_EQ(::std::signbit(value), ::std::signbit(loaded));
+  }
+  state = 42;
+  for (int i = 0; i < 1000; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    T value = static_cast< T >(static_cast< double >(state >> 11) /
+                               static_cast< double >(1ULL << 40));
+    T loaded = 0;
+    t.load(&loaded, &loaded);
+    EXPECT_EQ(value, loaded);
+  }
+  T loaded = 0;
+  t.load(&loaded, &loaded);
+  EXPECT_TRUE(::std::isnan(loaded));
+  EXPECT_TRUE(static_cast< bool >(t.stream()));
+}
+
+TEST(TextProtocolTest, roundTripTest) {
+  roundTripTest< float >();
+  roundTripTest< double >();
+  roundTripTest< long double >();
+}
+
+TEST(TextProtocolTest, formatTest) {
+  // Numbers use the fewest digits that read back to the same value
+  TextProtocol< ::std::stringstream > t;
+  t.save(&t, 0.1);
+  t.save(&t, 0.1f);
+  t.save(&t, 2.0);
+  t.save(&t, -0.0);
+  t.save(&t, 1e100);
+  t.save(&t, -9223372036854775807LL - 1);
+  t.save(&t, 18446744073709551615ULL);
+  EXPECT_EQ("0.1 0.1 2 -0 1e+100 -9223372036854775808 18446744073709551615 ",
+            t.stream().str());
+
+  // Malformed or out of range numbers fail the stream. As with operator>>,
+  // malformed ones load as zero and out of range ones as the nearest value.
+  TextProtocol< ::std::stringstream > u("1.5x 70000 ");
+  double d = 3.0;
+  u.load(&u, &d);
+  EXPECT_TRUE(u.stream().fail());
+  EXPECT_EQ(0.0, d);
+  TextProtocol< ::std::stringstream > v("70000 ");
+  short s = 0;
+  v.load(&v, &s);
+  EXPECT_TRUE(v.stream().fail());
+  EXPECT_EQ(32767, s);
+  TextProtocol< ::std::stringstream > w("-70000 ");
+  w.load(&w, &s);
+  EXPECT_EQ(-32768, s);
+  TextProtocol< ::std::stringstream > x("-99999999999999999999 ");
+  long long ll = 0;
+  x.load(&x, &ll);
+  EXPECT_TRUE(x.stream().fail());
+  EXPECT_EQ(::std::numeric_limits< long long >::min(), ll);
+  TextProtocol< ::std::stringstream > y("-5 ");
+  unsigned int ui = 7;
+  y.load(&y, &ui);
+  EXPECT_TRUE(y.stream().fail());
+  EXPECT_EQ(0, ui);
+  TextProtocol< ::std::stringstream > z("-1e999 ");
+  z.load(&z, &d);
+  EXPECT_TRUE(z.stream().fail());
+  EXPECT_EQ(-::std::numeric_limits< double >::max(), d);
+}
+
+TEST(TextProtocolTest, localeTest) {
+  // Numbers keep a point under locales with a decimal comma, on the slow
+  // paths as well. Nothing is checked if no such locale is installed.
+  const char *names[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8",
+                         "fr_FR.utf8", "ru_RU.UTF-8", "ru_RU.utf8"};
+  bool found = false;
+  for (const char *name : names) {
+    if (::std::setlocale(LC_NUMERIC, name) != nullptr) {
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    return;
+  }
+  TextProtocol< ::std::stringstream > t;
+  t.save(&t, 0.1L);
+  t.save(&t, 1.2345678901234567e-300);
+  EXPECT_EQ('.', t.stream().str()[1]);
+  long double l = 0;
+  double d = 0;
+  t.load(&t, &l);
+  t.load(&t, &d);
+  ::std::setlocale(LC_NUMERIC, "C");
+  EXPECT_TRUE(static_cast< bool >(t.stream()));
+  EXPECT_EQ(0.1L, l);
+  EXPECT_EQ(1.2345678901234567e-300, d);
+}
+
 }  // namespace serializer
 }  // namespace thunder
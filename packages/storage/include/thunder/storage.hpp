@@ -20,29 +20,82 @@
 #ifndef THUNDER_STORAGE_HPP_
 #define THUNDER_STORAGE_HPP_
 
+#include "thunder/storage/allocator.hpp"
+#include "thunder/storage/caching_allocator.hpp"
+#include "thunder/storage/mapped.hpp"
+#include "thunder/storage/memory.hpp"
+#include "thunder/storage/numa.hpp"
+#include "thunder/storage/shared_memory.hpp"
+#include "thunder/storage/small_storage.hpp"
 #include "thunder/storage/storage.hpp"
+#include "thunder/storage/workspace.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <complex>
+#include <string>
 #include <utility>
 
 #include "thunder/serializer.hpp"
 
 namespace thunder {
 
-template < typename D = double, typename A = ::std::allocator< D > >
+// Default allocators follow storage::DefaultAllocator, which is aligned if
+// THUNDER_ALIGNED_STORAGE is defined.
+template < typename D = double, typename A = storage::DefaultAllocator< D > >
 using Storage = storage::Storage< D, A >;
-typedef Storage< double, ::std::allocator< double > > DoubleStorage;
-typedef Storage< float, ::std::allocator< float > > FloatStorage;
-typedef Storage< ::std::size_t, ::std::allocator< ::std::size_t > > SizeStorage;
+typedef Storage< double > DoubleStorage;
+typedef Storage< float > FloatStorage;
+typedef Storage< ::std::size_t > SizeStorage;
 
 template < typename D = double,
-           typename A = ::std::allocator< ::std::complex< D > > >
+           typename A = storage::DefaultAllocator< ::std::complex< D > > >
 using ComplexStorage = storage::Storage< ::std::complex< D >, A >;
-typedef ComplexStorage< double, ::std::allocator< ::std::complex< double > > >
-DoubleComplexStorage;
-typedef ComplexStorage< float, ::std::allocator< ::std::complex< float > > >
-FloatComplexStorage;
+typedef ComplexStorage< double > DoubleComplexStorage;
+typedef ComplexStorage< float > FloatComplexStorage;
+
+template < typename D, ::std::size_t Align = 64 >
+using AlignedAllocator = storage::AlignedAllocator< D, Align >;
+template < typename D >
+using HugePageAllocator = storage::HugePageAllocator< D >;
+typedef Storage< double, AlignedAllocator< double > > AlignedDoubleStorage;
+typedef Storage< float, AlignedAllocator< float > > AlignedFloatStorage;
+typedef Storage< double, HugePageAllocator< double > > HugePageDoubleStorage;
+typedef Storage< float, HugePageAllocator< float > > HugePageFloatStorage;
+
+template < typename D >
+using CachingAllocator = storage::CachingAllocator< D >;
+typedef Storage< double, CachingAllocator< double > > CachingDoubleStorage;
+typedef Storage< float, CachingAllocator< float > > CachingFloatStorage;
+typedef ComplexStorage< double, CachingAllocator< ::std::complex< double > > >
+CachingDoubleComplexStorage;
+typedef ComplexStorage< float, CachingAllocator< ::std::complex< float > > >
+CachingFloatComplexStorage;
+
+using storage::MapMode;
+using storage::MapAdvice;
+
+using MemoryScope = storage::MemoryScope;
+
+using storage::NumaPolicy;
+template < typename D >
+using NumaAllocator = storage::NumaAllocator< D >;
+typedef Storage< double, NumaAllocator< double > > NumaDoubleStorage;
+typedef Storage< float, NumaAllocator< float > > NumaFloatStorage;
+
+using Workspace = storage::Workspace;
+using WorkspaceScope = storage::WorkspaceScope;
+template < typename D >
+using WorkspaceAllocator = storage::WorkspaceAllocator< D >;
+typedef Storage< double, WorkspaceAllocator< double > > WorkspaceDoubleStorage;
+typedef Storage< float, WorkspaceAllocator< float > > WorkspaceFloatStorage;
+typedef ComplexStorage< double, WorkspaceAllocator< ::std::complex< double > > >
+WorkspaceDoubleComplexStorage;
+typedef ComplexStorage< float, WorkspaceAllocator< ::std::complex< float > > >
+WorkspaceFloatComplexStorage;
+
+template < typename D, ::std::size_t N = 8 >
+using SmallStorage = storage::SmallStorage< D, N >;
 
 }  // namespace thunder
 
@@ -57,6 +110,90 @@ extern template class Storage< ::std::size_t >;
 extern template class Storage< ::std::ptrdiff_t >;
 extern template class Storage< ::std::pair< ::std::size_t, ::std::size_t > >;
 
+extern template class AlignedAllocator< double >;
+extern template class AlignedAllocator< float >;
+extern template class AlignedAllocator< ::std::complex< double > >;
+extern template class AlignedAllocator< ::std::complex< float > >;
+extern template class AlignedAllocator< ::std::size_t >;
+extern template class AlignedAllocator< ::std::ptrdiff_t >;
+extern template class AlignedAllocator<
+  ::std::pair< ::std::size_t, ::std::size_t > >;
+extern template class HugePageAllocator< double >;
+extern template class HugePageAllocator< float >;
+#ifndef THUNDER_ALIGNED_STORAGE
+extern template class Storage< double, AlignedAllocator< double > >;
+extern template class Storage< float, AlignedAllocator< float > >;
+#endif
+extern template class Storage< double, HugePageAllocator< double > >;
+extern template class Storage< float, HugePageAllocator< float > >;
+extern template class CachingAllocator< double >;
+extern template class CachingAllocator< float >;
+extern template class CachingAllocator< ::std::complex< double > >;
+extern template class CachingAllocator< ::std::complex< float > >;
+extern template class Storage< double, CachingAllocator< double > >;
+extern template class Storage< float, CachingAllocator< float > >;
+extern template class Storage< ::std::complex< double >,
+  CachingAllocator< ::std::complex< double > > >;
+extern template class Storage< ::std::complex< float >,
+  CachingAllocator< ::std::complex< float > > >;
+extern template class NumaAllocator< double >;
+extern template class NumaAllocator< float >;
+extern template class Storage< double, NumaAllocator< double > >;
+extern template class Storage< float, NumaAllocator< float > >;
+extern template class WorkspaceAllocator< double >;
+extern template class WorkspaceAllocator< float >;
+extern template class WorkspaceAllocator< ::std::complex< double > >;
+extern template class WorkspaceAllocator< ::std::complex< float > >;
+extern template class Storage< double, WorkspaceAllocator< double > >;
+extern template class Storage< float, WorkspaceAllocator< float > >;
+extern template class Storage< ::std::complex< double >,
+  WorkspaceAllocator< ::std::complex< double > > >;
+extern template class Storage< ::std::complex< float >,
+  WorkspaceAllocator< ::std::complex< float > > >;
+
+#define THUNDER_STORAGE_INSTANTIATE_MAPPED(D)                   \
+  extern template Storage< D > mapStorage(                      \
+      const ::std::string &path, MapMode mode,                  \
+      typename Storage< D >::size_type count,                   \
+      ::std::size_t offset);                                    \
+  extern template void advise(const Storage< D > &s,            \
+                              MapAdvice advice);                \
+  extern template void sync(const Storage< D > &s, bool async);
+
+THUNDER_STORAGE_INSTANTIATE_MAPPED(double);
+THUNDER_STORAGE_INSTANTIATE_MAPPED(float);
+THUNDER_STORAGE_INSTANTIATE_MAPPED(::std::complex< double >);
+THUNDER_STORAGE_INSTANTIATE_MAPPED(::std::complex< float >);
+
+#undef THUNDER_STORAGE_INSTANTIATE_MAPPED
+
+#define THUNDER_STORAGE_INSTANTIATE_SHARED(D)                           \
+  extern template Storage< D > createSharedStorage(                     \
+      const ::std::string &name,                                        \
+      typename Storage< D >::size_type count);                          \
+  extern template Storage< D > publishStorage(                          \
+      const ::std::string &name, const Storage< D > &s);                \
+  extern template Storage< D > openSharedStorage(                       \
+      const ::std::string &name, MapMode mode);
+
+THUNDER_STORAGE_INSTANTIATE_SHARED(double);
+THUNDER_STORAGE_INSTANTIATE_SHARED(float);
+THUNDER_STORAGE_INSTANTIATE_SHARED(::std::complex< double >);
+THUNDER_STORAGE_INSTANTIATE_SHARED(::std::complex< float >);
+
+#undef THUNDER_STORAGE_INSTANTIATE_SHARED
+
+extern template class SmallStorage< ::std::size_t >;
+extern template class SmallStorage< ::std::ptrdiff_t >;
+extern template SmallStorage< ::std::size_t >::SmallStorage(
+    const Storage< ::std::size_t > &other);
+extern template SmallStorage< ::std::ptrdiff_t >::SmallStorage(
+    const Storage< ::std::ptrdiff_t > &other);
+extern template SmallStorage< ::std::size_t >::operator
+Storage< ::std::size_t >() const;
+extern template SmallStorage< ::std::ptrdiff_t >::operator
+Storage< ::std::ptrdiff_t >() const;
+
 extern template Storage< double > Storage<
   ::std::complex< double > >::template view< Storage< double > >();
 extern template Storage< float > Storage<
@@ -0,0 +1,134 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_ALLOCATOR_INL_HPP_
+#define THUNDER_STORAGE_ALLOCATOR_INL_HPP_
+
+#include "thunder/storage/allocator.hpp"
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace thunder {
+namespace storage {
+
+template < typename D, ::std::size_t Align >
+AlignedAllocator< D, Align >::AlignedAllocator() {}
+
+template < typename D, ::std::size_t Align >
+typename AlignedAllocator< D, Align >::pointer
+AlignedAllocator< D, Align >::allocate(size_type n, const void *) {
+  if (n > max_size()) {
+    throw ::std::bad_alloc();
+  }
+  void *p = nullptr;
+  if (posix_memalign(&p, alignment(), n * sizeof(D)) != 0) {
+    throw ::std::bad_alloc();
+  }
+  return static_cast< pointer >(p);
+}
+
+template < typename D, ::std::size_t Align >
+void AlignedAllocator< D, Align >::deallocate(pointer p, size_type) {
+  ::std::free(p);
+}
+
+template < typename D, ::std::size_t Align >
+typename AlignedAllocator< D, Align >::size_type
+AlignedAllocator< D, Align >::max_size() const {
+  return ::std::numeric_limits< size_type >::max() / sizeof(D);
+}
+
+template < typename D >
+HugePageAllocator< D >::HugePageAllocator() {}
+
+template < typename D >
+typename HugePageAllocator< D >::pointer HugePageAllocator< D >::allocate(
+    size_type n, const void *) {
+  if (n > max_size()) {
+    throw ::std::bad_alloc();
+  }
+  size_type bytes = mapped(n);
+  if (bytes == 0) {
+    return AlignedAllocator< D >().allocate(n);
+  }
+
+  void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (p == MAP_FAILED) {
+    // No huge pages reserved. Let the kernel promote the mapping instead.
+    p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw ::std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+  }
+  return static_cast< pointer >(p);
+}
+
+template < typename D >
+void HugePageAllocator< D >::deallocate(pointer p, size_type n) {
+  size_type bytes = mapped(n);
+  if (bytes == 0) {
+    AlignedAllocator< D >().deallocate(p, n);
+  } else {
+    munmap(p, bytes);
+  }
+}
+
+template < typename D >
+typename HugePageAllocator< D >::size_type
+HugePageAllocator< D >::max_size() const {
+  return (::std::numeric_limits< size_type >::max() - page()) / sizeof(D);
+}
+
+template < typename D >
+typename HugePageAllocator< D >::size_type HugePageAllocator< D >::mapped(
+    size_type n) {
+  // Below half a page the rounding would waste more than it saves
+  size_type bytes = n * sizeof(D);
+  if (bytes < page() / 2) {
+    return 0;
+  }
+  return (bytes + page() - 1) / page() * page();
+}
+
+template < ::std::size_t Align, typename D >
+D* assumeAligned(D *p) {
+#if defined(__GNUC__)
+  return static_cast< D* >(__builtin_assume_aligned(p, Align));
+#else
+  return p;
+#endif
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_ALLOCATOR_INL_HPP_
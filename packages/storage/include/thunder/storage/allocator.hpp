@@ -0,0 +1,180 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_ALLOCATOR_HPP_
+#define THUNDER_STORAGE_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <memory>
+
+namespace thunder {
+namespace storage {
+
+// Allocator returning memory aligned to Align bytes, which defaults to the
+// cache line size so that vector loads never straddle two lines.
+template < typename D, ::std::size_t Align = 64 >
+class AlignedAllocator {
+ public:
+  // Typedefs
+  typedef D value_type;
+  typedef D& reference;
+  typedef const D& const_reference;
+  typedef D* pointer;
+  typedef const D* const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+
+  template < typename U >
+  struct rebind {
+    typedef AlignedAllocator< U, Align > other;
+  };
+
+  // Alignment in bytes of all allocations
+  static constexpr size_type alignment() {
+    return Align < alignof(D) ? alignof(D) : Align;
+  }
+
+  AlignedAllocator();
+  // Allocators of other types are interchangeable with this one
+  template < typename U >
+  AlignedAllocator(const AlignedAllocator< U, Align > &) {}
+
+  pointer allocate(size_type n, const void *hint = nullptr);
+  void deallocate(pointer p, size_type n);
+  size_type max_size() const;
+
+  template < typename U >
+  bool operator==(const AlignedAllocator< U, Align > &) const {
+    return true;
+  }
+  template < typename U >
+  bool operator!=(const AlignedAllocator< U, Align > &) const {
+    return false;
+  }
+};
+
+// Allocator backing large allocations with huge pages. It asks for explicit
+// huge pages with MAP_HUGETLB and falls back to transparent huge pages via
+// madvise if none are reserved. Small allocations are only cache-line aligned.
+template < typename D >
+class HugePageAllocator {
+ public:
+  // Typedefs
+  typedef D value_type;
+  typedef D& reference;
+  typedef const D& const_reference;
+  typedef D* pointer;
+  typedef const D* const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+
+  template < typename U >
+  struct rebind {
+    typedef HugePageAllocator< U > other;
+  };
+
+  // Size of a huge page in bytes
+  static constexpr size_type page() {
+    return 2 * 1024 * 1024;
+  }
+  // Alignment in bytes of all allocations
+  static constexpr size_type alignment() {
+    return AlignedAllocator< D >::alignment();
+  }
+
+  HugePageAllocator();
+  // Allocators of other types are interchangeable with this one
+  template < typename U >
+  HugePageAllocator(const HugePageAllocator< U > &other) {}
+
+  pointer allocate(size_type n, const void *hint = nullptr);
+  void deallocate(pointer p, size_type n);
+  size_type max_size() const;
+
+  template < typename U >
+  bool operator==(const HugePageAllocator< U > &other) const {
+    return true;
+  }
+  template < typename U >
+  bool operator!=(const HugePageAllocator< U > &other) const {
+    return false;
+  }
+
+ private:
+  // Number of bytes mapped for n elements, or 0 if they are not mapped
+  static size_type mapped(size_type n);
+};
+
+// Alignment in bytes guaranteed for memory returned by allocator A
+template < typename A >
+class AllocatorAlignment {
+ public:
+  static constexpr ::std::size_t value = alignof(typename A::value_type);
+};
+
+template < typename D >
+class AllocatorAlignment< ::std::allocator< D > > {
+ public:
+  static constexpr ::std::size_t value =
+      alignof(D) < alignof(::std::max_align_t) ?
+      alignof(::std::max_align_t) : alignof(D);
+};
+
+template < typename D, ::std::size_t Align >
+class AllocatorAlignment< AlignedAllocator< D, Align > > {
+ public:
+  static constexpr ::std::size_t value =
+      AlignedAllocator< D, Align >::alignment();
+};
+
+template < typename D >
+class AllocatorAlignment< HugePageAllocator< D > > {
+ public:
+  static constexpr ::std::size_t value = HugePageAllocator< D >::alignment();
+};
+
+template < typename A >
+constexpr ::std::size_t AllocatorAlignment< A >::value;
+template < typename D >
+constexpr ::std::size_t AllocatorAlignment< ::std::allocator< D > >::value;
+template < typename D, ::std::size_t Align >
+constexpr ::std::size_t AllocatorAlignment<
+  AlignedAllocator< D, Align > >::value;
+template < typename D >
+constexpr ::std::size_t AllocatorAlignment< HugePageAllocator< D > >::value;
+
+// Tell the compiler that p is aligned to Align bytes so that loops over it
+// can use aligned vector loads
+template < ::std::size_t Align, typename D >
+D* assumeAligned(D *p);
+
+// Default allocator of storages. Define THUNDER_ALIGNED_STORAGE to make every
+// storage cache-line aligned unless an allocator is given explicitly.
+#ifdef THUNDER_ALIGNED_STORAGE
+template < typename D >
+using DefaultAllocator = AlignedAllocator< D >;
+#else
+template < typename D >
+using DefaultAllocator = ::std::allocator< D >;
+#endif
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_ALLOCATOR_HPP_
@@ -0,0 +1,59 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_CACHING_ALLOCATOR_INL_HPP_
+#define THUNDER_STORAGE_CACHING_ALLOCATOR_INL_HPP_
+
+#include "thunder/storage/caching_allocator.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace thunder {
+namespace storage {
+
+template < typename D >
+CachingAllocator< D >::CachingAllocator() {}
+
+template < typename D >
+typename CachingAllocator< D >::pointer CachingAllocator< D >::allocate(
+    size_type n, const void *) {
+  if (n > max_size()) {
+    throw ::std::bad_alloc();
+  }
+  return static_cast< pointer >(cachedAllocate(n * sizeof(D)));
+}
+
+template < typename D >
+void CachingAllocator< D >::deallocate(pointer p, size_type n) {
+  cachedDeallocate(p, n * sizeof(D));
+}
+
+template < typename D >
+typename CachingAllocator< D >::size_type
+CachingAllocator< D >::max_size() const {
+  // Leave room for rounding up to the size class
+  return ::std::numeric_limits< size_type >::max() / 2 / sizeof(D);
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_CACHING_ALLOCATOR_INL_HPP_
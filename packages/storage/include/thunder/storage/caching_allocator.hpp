@@ -0,0 +1,103 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_CACHING_ALLOCATOR_HPP_
+#define THUNDER_STORAGE_CACHING_ALLOCATOR_HPP_
+
+#include <cstddef>
+
+#include "thunder/storage/allocator.hpp"
+
+namespace thunder {
+namespace storage {
+
+// Allocate a cache-line aligned block of at least bytes from the cache
+void* cachedAllocate(::std::size_t bytes);
+// Return a block obtained from cachedAllocate with the same bytes
+void cachedDeallocate(void *p, ::std::size_t bytes);
+
+// Bytes a request is rounded up to. Size classes are 1.25x apart.
+::std::size_t cachedBytes(::std::size_t bytes);
+// Bytes currently held in all caches
+::std::size_t cacheSize();
+// Get the maximum number of bytes kept in all caches
+::std::size_t cacheCeiling();
+// Set the maximum number of bytes kept in all caches
+void setCacheCeiling(::std::size_t bytes);
+// Release the global pool and the cache of the calling thread to the system.
+// Caches of other threads are released when those threads exit.
+void emptyCache();
+
+// Allocator recycling freed blocks by size class. Each thread keeps a few
+// blocks per class without locking and shares the rest via a global pool,
+// so steady-state allocation of same-sized temporaries avoids malloc.
+template < typename D >
+class CachingAllocator {
+ public:
+  // Typedefs
+  typedef D value_type;
+  typedef D& reference;
+  typedef const D& const_reference;
+  typedef D* pointer;
+  typedef const D* const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+
+  template < typename U >
+  struct rebind {
+    typedef CachingAllocator< U > other;
+  };
+
+  // Alignment in bytes of all allocations
+  static constexpr size_type alignment() {
+    return alignof(D) < 64 ? 64 : alignof(D);
+  }
+
+  CachingAllocator();
+  // Allocators of other types are interchangeable with this one
+  template < typename U >
+  CachingAllocator(const CachingAllocator< U > &other) {}
+
+  pointer allocate(size_type n, const void *hint = nullptr);
+  void deallocate(pointer p, size_type n);
+  size_type max_size() const;
+
+  template < typename U >
+  bool operator==(const CachingAllocator< U > &other) const {
+    return true;
+  }
+  template < typename U >
+  bool operator!=(const CachingAllocator< U > &other) const {
+    return false;
+  }
+};
+
+template < typename D >
+class AllocatorAlignment< CachingAllocator< D > > {
+ public:
+  static constexpr ::std::size_t value = CachingAllocator< D >::alignment();
+};
+
+template < typename D >
+constexpr ::std::size_t AllocatorAlignment< CachingAllocator< D > >::value;
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_CACHING_ALLOCATOR_HPP_
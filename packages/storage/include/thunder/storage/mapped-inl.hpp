@@ -0,0 +1,71 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_MAPPED_INL_HPP_
+#define THUNDER_STORAGE_MAPPED_INL_HPP_
+
+#include "thunder/storage/mapped.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "thunder/exception.hpp"
+
+namespace thunder {
+namespace storage {
+
+template < typename S >
+S mapStorage(const ::std::string &path, MapMode mode,
+             typename S::size_type count, ::std::size_t offset) {
+  typedef typename S::value_type value_type;
+  typedef typename S::pointer pointer;
+  typedef typename S::shared_pointer shared_pointer;
+  typedef typename S::allocator_type allocator_type;
+
+  if (offset % alignof(value_type) != 0) {
+    throw invalid_argument("Offset is not aligned for the element type.");
+  }
+  if (count > ::std::numeric_limits< ::std::size_t >::max() /
+      sizeof(value_type)) {
+    throw out_of_range("Count exceeds the addressable size.");
+  }
+  ::std::size_t bytes = count * sizeof(value_type);
+  ::std::shared_ptr< char > region = mapFile(path, mode, offset, &bytes);
+
+  // Aliasing the mapping keeps it alive as long as any storage views it
+  return S(shared_pointer(region, reinterpret_cast< pointer >(region.get())),
+           bytes / sizeof(value_type), allocator_type());
+}
+
+template < typename S >
+void advise(const S &s, MapAdvice advice) {
+  adviseMemory(s.data(), s.size() * sizeof(typename S::value_type), advice);
+}
+
+template < typename S >
+void sync(const S &s, bool async) {
+  syncMemory(s.data(), s.size() * sizeof(typename S::value_type), async);
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_MAPPED_INL_HPP_
@@ -0,0 +1,71 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_MAPPED_HPP_
+#define THUNDER_STORAGE_MAPPED_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace thunder {
+namespace storage {
+
+// How a file is mapped. Copy-on-write changes stay private to the process.
+enum class MapMode { kReadOnly, kReadWrite, kCopyOnWrite };
+
+// Access pattern hints passed to madvise. kDontNeed drops the pages from
+// memory, which discards copy-on-write changes.
+enum class MapAdvice { kNormal, kSequential, kRandom, kWillNeed, kDontNeed };
+
+// Map *bytes bytes of a file starting at offset, which need not be page
+// aligned. Zero bytes maps up to the end of the file and stores the size
+// mapped in *bytes. In read-write mode the file is created or extended if it
+// is too short. The mapping is released with the last pointer sharing it.
+::std::shared_ptr< char > mapFile(const ::std::string &path, MapMode mode,
+                                  ::std::size_t offset, ::std::size_t *bytes);
+// Map an open file in the same way. The descriptor stays open and can be
+// closed at once, as the mapping does not need it.
+::std::shared_ptr< char > mapFile(int fd, MapMode mode, ::std::size_t offset,
+                                  ::std::size_t *bytes);
+// Apply an access pattern hint to the pages covering a memory range
+void adviseMemory(const void *p, ::std::size_t bytes, MapAdvice advice);
+// Write back the pages covering a mapped memory range to its file
+void syncMemory(const void *p, ::std::size_t bytes, bool async = false);
+
+// Create a storage viewing count elements of a file starting at offset bytes,
+// which must be a multiple of the alignment of the element type. Zero count
+// maps up to the end of the file. The storage works with tensors
+// as any other, with data paged in on access and out through the page cache.
+template < typename S >
+S mapStorage(const ::std::string &path, MapMode mode = MapMode::kReadOnly,
+             typename S::size_type count = 0, ::std::size_t offset = 0);
+
+// Apply an access pattern hint to the data of a storage
+template < typename S >
+void advise(const S &s, MapAdvice advice);
+
+// Write back the data of a mapped storage to its file
+template < typename S >
+void sync(const S &s, bool async = false);
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_MAPPED_HPP_
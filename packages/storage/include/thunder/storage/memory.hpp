@@ -0,0 +1,127 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_MEMORY_HPP_
+#define THUNDER_STORAGE_MEMORY_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace thunder {
+namespace storage {
+
+// Counters of one element type or scope tag
+struct MemoryStats {
+  ::std::string name;
+  ::std::size_t live_bytes;
+  ::std::size_t peak_bytes;
+  ::std::size_t allocations;
+  ::std::size_t deallocations;
+};
+
+// A live storage allocation of at least memoryTrackThreshold() bytes
+struct MemoryBlock {
+  const void *data;
+  ::std::size_t bytes;
+  ::std::string type;
+  ::std::string tag;
+  // Size of the tensor the storage was allocated for, empty if unknown
+  ::std::vector< ::std::size_t > shape;
+};
+
+// Lock-free counters kept for the lifetime of the program
+class MemoryCounter {
+ public:
+  explicit MemoryCounter(const ::std::string &name);
+
+  void acquire(::std::size_t bytes);
+  void release(::std::size_t bytes);
+  void resetPeak();
+  const ::std::string &name() const;
+  MemoryStats stats() const;
+
+ private:
+  ::std::string name_;
+  ::std::atomic< ::std::size_t > live_bytes_;
+  ::std::atomic< ::std::size_t > peak_bytes_;
+  ::std::atomic< ::std::size_t > allocations_;
+  ::std::atomic< ::std::size_t > deallocations_;
+};
+
+// What an allocation was accounted to, kept by its deleter
+struct MemoryRecord {
+  MemoryCounter *type;
+  MemoryCounter *tag;
+  ::std::size_t bytes;
+  bool tracked;
+};
+
+// Tags allocations made by the current thread while in scope. Scopes nest and
+// the innermost tag wins. Scopes sharing a tag share its counters.
+class MemoryScope {
+ public:
+  explicit MemoryScope(const ::std::string &tag);
+  ~MemoryScope();
+
+  MemoryScope(const MemoryScope &other) = delete;
+  MemoryScope &operator=(const MemoryScope &other) = delete;
+
+ private:
+  MemoryCounter *previous_;
+};
+
+// Get whether storage allocations are accounted. It is on by default.
+bool memoryAccounting();
+// Set whether storage allocations are accounted
+void setMemoryAccounting(bool enable);
+// Get the bytes from which allocations are listed in memorySnapshot()
+::std::size_t memoryTrackThreshold();
+// Set the bytes from which allocations are listed in memorySnapshot()
+void setMemoryTrackThreshold(::std::size_t bytes);
+
+// Counters of all element types and all tags seen so far
+::std::vector< MemoryStats > memoryStatsByType();
+::std::vector< MemoryStats > memoryStatsByTag();
+// Set peak bytes of all counters to their live bytes
+void resetMemoryPeak();
+// The largest count live allocations listed, in decreasing size
+::std::vector< MemoryBlock > memorySnapshot(::std::size_t count = 16);
+
+// Counters of an element type by name, created on first use
+MemoryCounter* memoryTypeCounter(const ::std::type_info &type);
+template < typename D >
+MemoryCounter* memoryTypeCounter() {
+  static MemoryCounter *counter = memoryTypeCounter(typeid(D));
+  return counter;
+}
+// Account an allocation and return what to pass to memoryRelease()
+MemoryRecord memoryAcquire(MemoryCounter *type, const void *data,
+                           ::std::size_t bytes);
+void memoryRelease(const MemoryRecord &record, const void *data);
+// Attach the tensor size to a listed allocation
+void memoryAnnotate(const void *data, ::std::size_t bytes,
+                    const ::std::size_t *shape, ::std::size_t dimension);
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_MEMORY_HPP_
@@ -0,0 +1,101 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_NUMA_INL_HPP_
+#define THUNDER_STORAGE_NUMA_INL_HPP_
+
+#include "thunder/storage/numa.hpp"
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "thunder/storage/allocator-inl.hpp"
+
+namespace thunder {
+namespace storage {
+
+template < typename D >
+NumaAllocator< D >::NumaAllocator(NumaPolicy policy, size_type node)
+    : policy_(policy), node_(node) {}
+
+template < typename D >
+typename NumaAllocator< D >::pointer NumaAllocator< D >::allocate(
+    size_type n, const void *) {
+  if (n > max_size()) {
+    throw ::std::bad_alloc();
+  }
+  size_type bytes = mapped(n);
+  if (bytes == 0) {
+    return AlignedAllocator< D >().allocate(n);
+  }
+
+  // Fresh anonymous pages are not placed until first touched
+  void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    throw ::std::bad_alloc();
+  }
+  numaPlace(p, bytes, policy_, node_);
+  return static_cast< pointer >(p);
+}
+
+template < typename D >
+void NumaAllocator< D >::deallocate(pointer p, size_type n) {
+  size_type bytes = mapped(n);
+  if (bytes == 0) {
+    AlignedAllocator< D >().deallocate(p, n);
+  } else {
+    munmap(p, bytes);
+  }
+}
+
+template < typename D >
+typename NumaAllocator< D >::size_type NumaAllocator< D >::max_size() const {
+  return ::std::numeric_limits< size_type >::max() / 2 / sizeof(D);
+}
+
+template < typename D >
+NumaPolicy NumaAllocator< D >::policy() const {
+  return policy_;
+}
+
+template < typename D >
+typename NumaAllocator< D >::size_type NumaAllocator< D >::node() const {
+  return node_;
+}
+
+template < typename D >
+typename NumaAllocator< D >::size_type NumaAllocator< D >::mapped(
+    size_type n) {
+  // Placement only matters for allocations spanning many pages
+  const size_type page = 4096;
+  size_type bytes = n * sizeof(D);
+  if (bytes < 16 * page) {
+    return 0;
+  }
+  return (bytes + page - 1) / page * page;
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_NUMA_INL_HPP_
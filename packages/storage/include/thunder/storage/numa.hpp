@@ -0,0 +1,112 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_NUMA_HPP_
+#define THUNDER_STORAGE_NUMA_HPP_
+
+#include <cstddef>
+
+#include "thunder/storage/allocator.hpp"
+
+namespace thunder {
+namespace storage {
+
+// Placement of memory pages on NUMA nodes. kLocal places a page on the node
+// where the thread touching it first runs at that moment, kInterleave spreads
+// pages over all nodes and kBind keeps them on one node.
+enum class NumaPolicy { kDefault, kLocal, kInterleave, kBind };
+
+// Number of NUMA nodes of the system as one past the highest online node, 1
+// if unknown
+::std::size_t numaNodes();
+// Apply a policy to the pages covering a memory range before they are first
+// touched. Returns false if the system does not support it, in which case the
+// default placement applies.
+bool numaPlace(void *p, ::std::size_t bytes, NumaPolicy policy,
+               ::std::size_t node = 0);
+
+// Allocator placing pages of large allocations with a NUMA policy. It uses
+// mbind directly and needs no libnuma. Parallel threads are not pinned, so
+// kLocal follows wherever the scheduler runs the first toucher; use kBind or
+// kInterleave when placement must be guaranteed.
+template < typename D >
+class NumaAllocator {
+ public:
+  // Typedefs
+  typedef D value_type;
+  typedef D& reference;
+  typedef const D& const_reference;
+  typedef D* pointer;
+  typedef const D* const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+
+  template < typename U >
+  struct rebind {
+    typedef NumaAllocator< U > other;
+  };
+
+  // Alignment in bytes of all allocations
+  static constexpr size_type alignment() {
+    return AlignedAllocator< D >::alignment();
+  }
+
+  explicit NumaAllocator(NumaPolicy policy = NumaPolicy::kInterleave,
+                         size_type node = 0);
+  template < typename U >
+  NumaAllocator(const NumaAllocator< U > &other)
+      : policy_(other.policy()), node_(other.node()) {}
+
+  pointer allocate(size_type n, const void *hint = nullptr);
+  void deallocate(pointer p, size_type n);
+  size_type max_size() const;
+
+  NumaPolicy policy() const;
+  size_type node() const;
+
+  template < typename U >
+  bool operator==(const NumaAllocator< U > &other) const {
+    return policy_ == other.policy() && node_ == other.node();
+  }
+  template < typename U >
+  bool operator!=(const NumaAllocator< U > &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  // Number of bytes mapped for n elements, or 0 if they are not mapped
+  static size_type mapped(size_type n);
+
+  NumaPolicy policy_;
+  size_type node_;
+};
+
+template < typename D >
+class AllocatorAlignment< NumaAllocator< D > > {
+ public:
+  static constexpr ::std::size_t value = NumaAllocator< D >::alignment();
+};
+
+template < typename D >
+constexpr ::std::size_t AllocatorAlignment< NumaAllocator< D > >::value;
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_NUMA_HPP_
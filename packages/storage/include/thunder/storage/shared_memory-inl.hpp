@@ -0,0 +1,75 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_SHARED_MEMORY_INL_HPP_
+#define THUNDER_STORAGE_SHARED_MEMORY_INL_HPP_
+
+#include "thunder/storage/shared_memory.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "thunder/exception.hpp"
+
+namespace thunder {
+namespace storage {
+
+template < typename S >
+S createSharedStorage(const ::std::string &name, typename S::size_type count) {
+  typedef typename S::value_type value_type;
+  typedef typename S::pointer pointer;
+  typedef typename S::shared_pointer shared_pointer;
+  typedef typename S::allocator_type allocator_type;
+
+  ::std::shared_ptr< char > region =
+      createSharedMemory(name, count * sizeof(value_type));
+  return S(shared_pointer(region, reinterpret_cast< pointer >(region.get())),
+           count, allocator_type());
+}
+
+template < typename S >
+S publishStorage(const ::std::string &name, const S &s) {
+  S shared = createSharedStorage< S >(name, s.size());
+  for (typename S::size_type i = 0; i < s.size(); ++i) {
+    shared[i] = s[i];
+  }
+  return shared;
+}
+
+template < typename S >
+S openSharedStorage(const ::std::string &name, MapMode mode) {
+  typedef typename S::value_type value_type;
+  typedef typename S::pointer pointer;
+  typedef typename S::shared_pointer shared_pointer;
+  typedef typename S::allocator_type allocator_type;
+
+  ::std::size_t bytes = 0;
+  ::std::shared_ptr< char > region = openSharedMemory(name, mode, &bytes);
+  if (bytes % sizeof(value_type) != 0) {
+    throw invalid_argument("Segment size is not a multiple of element size.");
+  }
+  return S(shared_pointer(region, reinterpret_cast< pointer >(region.get())),
+           bytes / sizeof(value_type), allocator_type());
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_SHARED_MEMORY_INL_HPP_
@@ -0,0 +1,63 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_SHARED_MEMORY_HPP_
+#define THUNDER_STORAGE_SHARED_MEMORY_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "thunder/storage/mapped.hpp"
+
+namespace thunder {
+namespace storage {
+
+// Named POSIX shared memory segments. A segment counts the mappings of all
+// processes in its header and its name is removed when the last one is
+// released, so it lives exactly as long as some process uses it. Segments of
+// crashed processes are left behind and can be removed by name.
+
+// Create a segment of bytes and map it read-write. Throws io_error if the
+// name is taken.
+::std::shared_ptr< char > createSharedMemory(const ::std::string &name,
+                                             ::std::size_t bytes);
+// Map an existing segment and store its size in *bytes. Read-only mappings
+// cannot write the data, and copy-on-write changes stay in the process.
+::std::shared_ptr< char > openSharedMemory(const ::std::string &name,
+                                           MapMode mode, ::std::size_t *bytes);
+// Remove the name of a segment. Existing mappings remain valid.
+void removeSharedMemory(const ::std::string &name);
+
+// Create a storage of count elements in a new segment. Names follow
+// shm_open, as in "/model.weights".
+template < typename S >
+S createSharedStorage(const ::std::string &name, typename S::size_type count);
+// Create a segment holding a copy of s, for other processes to open
+template < typename S >
+S publishStorage(const ::std::string &name, const S &s);
+// Map the storage published under name without copying its data
+template < typename S >
+S openSharedStorage(const ::std::string &name,
+                    MapMode mode = MapMode::kReadOnly);
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_SHARED_MEMORY_HPP_
@@ -0,0 +1,203 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_SMALL_STORAGE_INL_HPP_
+#define THUNDER_STORAGE_SMALL_STORAGE_INL_HPP_
+
+#include "thunder/storage/small_storage.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+#include "thunder/storage/storage.hpp"
+
+namespace thunder {
+namespace storage {
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::SmallStorage() : size_(0), data_(buffer_) {}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::SmallStorage(size_type count)
+    : size_(count), data_(count > N ? new D[count] : buffer_) {}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::SmallStorage(size_type count, const_reference value)
+    : SmallStorage(count) {
+  for (size_type i = 0; i < size_; ++i) {
+    data_[i] = value;
+  }
+}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::SmallStorage(const SmallStorage &other)
+    : SmallStorage(other.size_) {
+  for (size_type i = 0; i < size_; ++i) {
+    data_[i] = other.data_[i];
+  }
+}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::SmallStorage(SmallStorage &&other)
+    : size_(other.size_), data_(buffer_) {
+  if (other.data_ != other.buffer_) {
+    data_ = other.data_;
+    other.size_ = 0;
+    other.data_ = other.buffer_;
+  } else {
+    for (size_type i = 0; i < size_; ++i) {
+      data_[i] = other.data_[i];
+    }
+  }
+}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::SmallStorage(::std::initializer_list< D > init)
+    : SmallStorage(init.size()) {
+  size_type i = 0;
+  for (const D &value : init) {
+    data_[i++] = value;
+  }
+}
+
+template < typename D, ::std::size_t N >
+template < typename A >
+SmallStorage< D, N >::SmallStorage(const Storage< D, A > &other)
+    : SmallStorage(other.size()) {
+  for (size_type i = 0; i < size_; ++i) {
+    data_[i] = other[i];
+  }
+}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N >::~SmallStorage() {
+  if (data_ != buffer_) {
+    delete[] data_;
+  }
+}
+
+template < typename D, ::std::size_t N >
+SmallStorage< D, N > &SmallStorage< D, N >::operator=(SmallStorage other) {
+  if (data_ != buffer_ && other.data_ != other.buffer_) {
+    ::std::swap(data_, other.data_);
+    ::std::swap(size_, other.size_);
+  } else {
+    resize(other.size_);
+    for (size_type i = 0; i < size_; ++i) {
+      data_[i] = other.data_[i];
+    }
+  }
+  return *this;
+}
+
+template < typename D, ::std::size_t N >
+template < typename A >
+SmallStorage< D, N >::operator Storage< D, A >() const {
+  Storage< D, A > storage(size_);
+  for (size_type i = 0; i < size_; ++i) {
+    storage[i] = data_[i];
+  }
+  return storage;
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::reference SmallStorage< D, N >::operator[](
+    size_type pos) {
+  return data_[pos];
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::const_reference
+SmallStorage< D, N >::operator[](size_type pos) const {
+  return data_[pos];
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::pointer SmallStorage< D, N >::data() {
+  return data_;
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::const_pointer
+SmallStorage< D, N >::data() const {
+  return data_;
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::iterator SmallStorage< D, N >::begin() {
+  return data_;
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::const_iterator
+SmallStorage< D, N >::begin() const {
+  return data_;
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::iterator SmallStorage< D, N >::end() {
+  return data_ + size_;
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::const_iterator
+SmallStorage< D, N >::end() const {
+  return data_ + size_;
+}
+
+template < typename D, ::std::size_t N >
+void SmallStorage< D, N >::resize(size_type count) {
+  if (data_ != buffer_ && count <= size_) {
+    // Keep the heap buffer when shrinking
+    size_ = count;
+    return;
+  }
+  if (data_ != buffer_) {
+    delete[] data_;
+    data_ = buffer_;
+  }
+  if (count > N) {
+    data_ = new D[count];
+  }
+  size_ = count;
+}
+
+template < typename D, ::std::size_t N >
+void SmallStorage< D, N >::resize(size_type count, const_reference value) {
+  resize(count);
+  for (size_type i = 0; i < size_; ++i) {
+    data_[i] = value;
+  }
+}
+
+template < typename D, ::std::size_t N >
+typename SmallStorage< D, N >::size_type SmallStorage< D, N >::size() const {
+  return size_;
+}
+
+template < typename D, ::std::size_t N >
+bool SmallStorage< D, N >::isInline() const {
+  return data_ == buffer_;
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_SMALL_STORAGE_INL_HPP_
@@ -0,0 +1,117 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_SMALL_STORAGE_HPP_
+#define THUNDER_STORAGE_SMALL_STORAGE_HPP_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+
+#include "thunder/storage/storage.hpp"
+
+namespace thunder {
+namespace storage {
+
+// Storage of value semantics keeping up to N elements inline. It does not
+// allocate unless its size exceeds N, which makes it suitable for metadata
+// such as tensor sizes and strides that are copied frequently.
+template < typename D, ::std::size_t N = 8 >
+class SmallStorage {
+ public:
+  // Typedefs
+  typedef D value_type;
+  typedef D& reference;
+  typedef const D& const_reference;
+  typedef D* pointer;
+  typedef const D* const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+
+  // Iterator definitions
+  typedef pointer iterator;
+  typedef const_pointer const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  // Default constructor
+  SmallStorage();
+  // Constructor with given size
+  explicit SmallStorage(size_type count);
+  // Constructor with given size and a default value
+  SmallStorage(size_type count, const_reference value);
+  // Copy constructor
+  SmallStorage(const SmallStorage &other);
+  // Move constructor
+  SmallStorage(SmallStorage &&other);
+  // Constructor from initializer_list
+  SmallStorage(::std::initializer_list< D > init);
+  // Constructor from a storage
+  template < typename A >
+  SmallStorage(const Storage< D, A > &other);
+
+  // Destructor
+  ~SmallStorage();
+
+  // Assignment operator (using copy and swap idiom)
+  SmallStorage &operator=(SmallStorage other);
+
+  // Conversion to a storage
+  template < typename A >
+  operator Storage< D, A >() const;
+
+  // Get reference at pos without bound checking
+  reference operator[](size_type pos);
+  // Get const reference at pos without bound checking
+  const_reference operator[](size_type pos) const;
+
+  // Get raw pointer to data
+  pointer data();
+  // Get const raw pointer to data
+  const_pointer data() const;
+
+  // Get iterator to data
+  iterator begin();
+  // Get const iterator to data
+  const_iterator begin() const;
+  // Get iterater pass the last element
+  iterator end();
+  // Get const iterator passing the last element
+  const_iterator end() const;
+
+  // Resize. Data content will be lost.
+  void resize(size_type count);
+  // Resize with all elements using target value
+  void resize(size_type count, const_reference value);
+
+  // Check the size of the storage
+  size_type size() const;
+  // Check whether the data is kept inline
+  bool isInline() const;
+
+ private:
+  size_type size_;
+  pointer data_;
+  D buffer_[N];
+};
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_SMALL_STORAGE_HPP_
@@ -20,87 +20,107 @@
 #ifndef THUNDER_STORAGE_STORAGE_INL_HPP
 #define THUNDER_STORAGE_STORAGE_INL_HPP
 
+#include "thunder/parallel.hpp"
 #include "thunder/serializer.hpp"
+#include "thunder/storage/allocator.hpp"
+#include "thunder/storage/memory.hpp"
 #include "thunder/storage/storage.hpp"
+#include "thunder/storage/workspace.hpp"
 
-#include <functional>
+#include "thunder/parallel/parallel-inl.hpp"
+#include "thunder/storage/allocator-inl.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace thunder {
 namespace storage {
 
+// Number of elements processed by one parallel block at least
+const ::std::size_t parallel_grain = 65536;
+
 template < typename D, typename A >
 Storage< D, A >::Storage(A alloc)
-    : alloc_(alloc), size_(0), shared_(nullptr), data_(shared_.get()) {}
+    : alloc_(alloc), size_(0), capacity_(0), shared_(nullptr),
+      data_(shared_.get()) {}
 
 template < typename D, typename A >
 Storage< D, A >::Storage(size_type count, A alloc)
-    : alloc_(alloc), size_(count),
-      shared_(size_ == 0 ? nullptr : alloc_.allocate(size_), ::std::bind(
-          &A::deallocate, &alloc_, std::placeholders::_1, size_)),
-      data_(shared_.get()) {}
+    : alloc_(alloc), size_(count), capacity_(count),
+      shared_(allocate(alloc_, size_)), data_(shared_.get()) {}
 
 template < typename D, typename A >
 Storage< D, A >::Storage(size_type count, const_reference value, A alloc)
-    : alloc_(alloc), size_(count),
-      shared_(size_ == 0 ? nullptr : alloc_.allocate(size_), ::std::bind(
-          &A::deallocate, &alloc_, std::placeholders::_1, size_)),
-      data_(shared_.get()) {
-  for (size_type i = 0; i < size_; ++i) {
-    data_[i] = value;
-  }
+    : alloc_(alloc), size_(count), capacity_(count),
+      shared_(allocate(alloc_, size_)), data_(shared_.get()) {
+  fill(value);
 }
 
 template < typename D, typename A >
 Storage< D, A >::Storage(shared_pointer shared, size_type count, A alloc)
-    : alloc_(alloc), size_(count), shared_(shared), data_(shared_.get()){}
+    : alloc_(alloc), size_(count), capacity_(count), shared_(shared),
+      data_(shared_.get()){}
 
 template < typename D, typename A >
 Storage< D, A >::Storage(pointer data, size_type count, A alloc)
-    : alloc_(alloc), size_(count),
+    : alloc_(alloc), size_(count), capacity_(count),
       shared_(size_ == 0 ? nullptr : data, [](pointer){}),
       data_(shared_.get()){}
 
 template < typename D, typename A >
 Storage< D, A >::Storage(const Storage &other)
-    : alloc_(other.alloc_), size_(other.size_),
-      shared_(size_ == 0 ? nullptr : alloc_.allocate(size_), ::std::bind(
-          &A::deallocate, &alloc_, std::placeholders::_1, size_)),
-      data_(shared_.get()) {
-  pointer data_ = data();
-  for (size_type i = 0; i < size_; ++i) {
-    data_[i] = other.data_[i];
-  }
+    : alloc_(other.alloc_), size_(other.size_), capacity_(other.size_),
+      shared_(allocate(alloc_, size_)), data_(shared_.get()) {
+  copyData(data_, other.data_, size_);
 }
 
 template < typename D, typename A >
 Storage< D, A >::Storage(Storage &&other)
     : alloc_(::std::move(other.alloc_)), size_(::std::move(other.size_)),
-      shared_(::std::move(other.shared_)), data_(::std::move(other.data_)) {
-}
+      capacity_(::std::move(other.capacity_)),
+      shared_(::std::move(other.shared_)), data_(::std::move(other.data_)),
+      lazy_(::std::move(other.lazy_)) {}
 
 template < typename D, typename A >
 Storage< D, A >::Storage(::std::initializer_list< D > init, A alloc)
-    :alloc_(alloc), size_(init.size()),
-     shared_(size_ == 0 ? nullptr : alloc_.allocate(size_), ::std::bind(
-         &A::deallocate, &alloc_, std::placeholders::_1, size_)),
-     data_(shared_.get()) {
-  size_t i = 0;
-  for (const D& value : init) {
-    data_[i++] = value;
-  }
+    :alloc_(alloc), size_(init.size()), capacity_(init.size()),
+     shared_(allocate(alloc_, size_)), data_(shared_.get()) {
+  copyData(data_, init.begin(), size_);
 }
 
 template < typename D, typename A >
 Storage< D, A >::~Storage() {}
 
+template < typename D, typename A >
+Storage< D, A > Storage< D, A >::scratch(size_type count, A alloc) {
+  Workspace *workspace = Workspace::current();
+  if (workspace == nullptr || count == 0) {
+    return Storage(count, alloc);
+  }
+  if (count > ::std::numeric_limits< size_type >::max() / sizeof(D)) {
+    throw ::std::bad_alloc();
+  }
+  ::std::shared_ptr< char > chunk;
+  pointer data = static_cast< pointer >(workspace->allocate(
+      count * sizeof(D), AllocatorAlignment< A >::value, &chunk));
+  // Sharing the chunk keeps the data valid if the storage escapes the scope
+  return Storage(shared_pointer(chunk, data), count, alloc);
+}
+
 template < typename D, typename A >
 Storage< D, A > &Storage< D, A >::operator=(Storage< D, A > other) {
   std::swap(alloc_, other.alloc_);
   std::swap(size_, other.size_);
+  std::swap(capacity_, other.capacity_);
   std::swap(shared_, other.shared_);
   std::swap(data_, other.data_);
+  std::swap(lazy_, other.lazy_);
   return *this;
 }
 
@@ -150,31 +170,92 @@ template < typename S >
 void Storage< D, A >::copy(const S &other) {
   if (this != reinterpret_cast<const Storage*> (&other)) {
     resize(static_cast< size_type >(other.size()));
-    for (size_type i = 0; i < size_; ++i) {
-      data_[i] = static_cast< D > (
-          other[static_cast< typename S::size_type >(i)]);
+    unshare();
+    if (::std::is_same< typename S::value_type, D >::value) {
+      copyData(data_, reinterpret_cast< const_pointer >(other.data()), size_);
+      return;
     }
+    pointer data = data_;
+    parallel::forRange(size_, parallel_grain, [data, &other](
+        size_type begin, size_type end) {
+      for (size_type i = begin; i < end; ++i) {
+        data[i] = static_cast< D > (
+            other[static_cast< typename S::size_type >(i)]);
+      }
+    });
+  }
+}
+
+template < typename D, typename A >
+void Storage< D, A >::fill(const_reference value) {
+  unshare();
+  if (size_ == 0) {
+    return;
+  }
+  // Large storages are filled in parallel blocks. Pages are placed on the
+  // node of whichever pool thread touches them first, which is best effort
+  // since the threads are not pinned.
+  pointer data = data_;
+
+  // Values made of one repeated byte, such as zero, are set with memset
+  bool bytewise = false;
+  unsigned char byte = 0;
+  if (::std::is_trivially_copyable< D >::value) {
+    unsigned char bytes[sizeof(D)];
+    ::std::memcpy(bytes, static_cast< const void* >(&value), sizeof(D));
+    byte = bytes[0];
+    bytewise = ::std::all_of(bytes, bytes + sizeof(D), [byte](
+        unsigned char b) { return b == byte; });
   }
+  parallel::forRange(size_, parallel_grain, [data, &value, bytewise, byte](
+      size_type begin, size_type end) {
+    if (bytewise) {
+      ::std::memset(static_cast< void* >(data + begin), byte,
+                    (end - begin) * sizeof(D));
+    } else {
+      ::std::fill(data + begin, data + end, value);
+    }
+  });
 }
 
 template < typename D, typename A >
 void Storage< D, A >::resize(size_type count) {
   if (size_ != count) {
+    // Release the old data before allocating the new one
     shared_ = nullptr;
-    if (count > 0) {
-      shared_.reset(alloc_.allocate(count), ::std::bind(
-          &A::deallocate, &alloc_, std::placeholders::_1, size_));
-    }
+    shared_ = allocate(alloc_, count);
     size_ = count;
+    capacity_ = count;
     data_ = shared_.get();
+    lazy_ = nullptr;
   }
 }
 
 template < typename D, typename A >
 void Storage< D, A >::resize(size_type count, const_reference value) {
   resize(count);
-  for (size_type i = 0; i < size_; ++i) {
-    data_[i] = value;
+  fill(value);
+}
+
+template < typename D, typename A >
+void Storage< D, A >::reserve(size_type count) {
+  if (count > capacity_) {
+    reallocate(count);
+  }
+}
+
+template < typename D, typename A >
+void Storage< D, A >::grow(size_type count) {
+  if (count > capacity_) {
+    reallocate(::std::max(count, capacity_ * 2));
+  }
+  size_ = count;
+}
+
+template < typename D, typename A >
+void Storage< D, A >::shrinkToFit() {
+  if (capacity_ > size_) {
+    reallocate(size_);
   }
 }
 
@@ -183,11 +264,61 @@ typename Storage< D, A >::size_type Storage< D, A >::size() const {
   return size_;
 }
 
+template < typename D, typename A >
+typename Storage< D, A >::size_type Storage< D, A >::capacity() const {
+  return capacity_;
+}
+
 template < typename D, typename A >
 A Storage< D, A >::allocator() const {
   return alloc_;
 }
 
+template < typename D, typename A >
+typename Storage< D, A >::shared_pointer Storage< D, A >::allocate(
+    A alloc, size_type count) {
+  if (count == 0) {
+    return shared_pointer(nullptr);
+  }
+  pointer data = alloc.allocate(count);
+  MemoryRecord record = memoryAcquire(
+      memoryTypeCounter< D >(), data, count * sizeof(D));
+  return shared_pointer(data, [alloc, count, record](pointer p) {
+      memoryRelease(record, p);
+      A(alloc).deallocate(p, count);
+    });
+}
+
+template < typename D, typename A >
+void Storage< D, A >::reallocate(size_type count) {
+  shared_pointer shared = allocate(alloc_, count);
+  copyData(shared.get(), data_, ::std::min(size_, count));
+  shared_ = shared;
+  data_ = shared_.get();
+  capacity_ = count;
+  lazy_ = nullptr;
+}
+
+template < typename D, typename A >
+void Storage< D, A >::copyData(pointer dst, const_pointer src,
+                               size_type count) {
+  // Empty storages may have null data, which memcpy does not accept
+  if (count == 0) {
+    return;
+  }
+  // Large copies are bandwidth bound and run in parallel blocks
+  parallel::forRange(count, parallel_grain, [dst, src](
+      size_type begin, size_type end) {
+    if (::std::is_trivially_copyable< D >::value) {
+      ::std::memcpy(static_cast< void* >(dst + begin),
+                    static_cast< const void* >(src + begin),
+                    (end - begin) * sizeof(D));
+    } else {
+      ::std::copy(src + begin, src + end, dst + begin);
+    }
+  });
+}
+
 template < typename D, typename A >
 template < typename S >
 S Storage< D, A >::view() {
@@ -204,6 +335,29 @@ S Storage< D, A >::view() {
       other_allocator(alloc_));
 }
 
+template < typename D, typename A >
+Storage< D, A > Storage< D, A >::lazyCopy() const {
+  if (lazy_ == nullptr) {
+    lazy_ = ::std::make_shared< char >(0);
+  }
+  Storage other(shared_, size_, alloc_);
+  other.lazy_ = lazy_;
+  return other;
+}
+
+template < typename D, typename A >
+bool Storage< D, A >::isShared() const {
+  return lazy_.use_count() > 1;
+}
+
+template < typename D, typename A >
+void Storage< D, A >::unshare() {
+  if (isShared()) {
+    reallocate(size_);
+  }
+  lazy_ = nullptr;
+}
+
 }  // namespace storage
 }  // namespace thunder
 
@@ -219,27 +373,22 @@ void save(S *s, const storage::Storage< D, A > &t) {
   typename T::size_type size = t.size();
   s->save(size);
 
-  // Save data of storage
-  typename T::const_pointer data = t.data();
-  for (typename T::size_type i = 0; i < size; ++i) {
-    s->save(data[i]);
-  }
+  // Save data of storage, in bulk if the protocol supports it
+  s->saveArray(t.data(), size);
 }
 
 template < typename S, typename D, typename A >
 void load(S *s, storage::Storage< D, A > *t) {
   typedef storage::Storage< D, A > T;
 
-  // Load size of storage
-  typename T::size_type size;
+  // Load size of storage, which stays zero if the stream fails
+  typename T::size_type size = 0;
   s->load(&size);
   t->resize(size);
+  t->unshare();
 
   // Restore data of storage
-  typename T::pointer data = t->data();
-  for (typename T::size_type i = 0; i < size; ++i) {
-    s->load(&data[i]);
-  }
+  s->loadArray(t->data(), size);
 }
 
 }  // namespace serializer
@@ -24,11 +24,12 @@
 #include <memory>
 
 #include "thunder/serializer.hpp"
+#include "thunder/storage/allocator.hpp"
 
 namespace thunder {
 namespace storage {
 
-template < typename D = double, typename A = ::std::allocator< D > >
+template < typename D = double, typename A = DefaultAllocator< D > >
 class Storage {
  public:
   // Typedefs from allocator
@@ -68,6 +69,10 @@ class Storage {
   // Destructor
   ~Storage();
 
+  // Storage of count elements for temporaries. It is drawn from the current
+  // workspace of the thread if there is one, and from alloc otherwise.
+  static Storage scratch(size_type count, A alloc = A());
+
   // Assignment operator (using copy and swap idiom)
   Storage &operator=(Storage other);
 
@@ -94,13 +99,25 @@ class Storage {
   template< typename S >
   void copy(const S &other);
 
+  // Set all elements to value, in parallel for large storages
+  void fill(const_reference value);
+
   // Resize. Data content will be lost.
   void resize(size_type count);
   // Resize with all elements using target value
   void resize(size_type count, const_reference value);
+  // Make room for count elements without changing the size or the content
+  void reserve(size_type count);
+  // Resize keeping the content. Capacity at least doubles when exceeded, so
+  // that growing one element at a time costs amortized constant time.
+  void grow(size_type count);
+  // Release the capacity beyond the size
+  void shrinkToFit();
 
   // Check the size of the storage
   size_type size() const;
+  // Check the number of elements allocated
+  size_type capacity() const;
 
   // Get the allocator
   A allocator() const;
@@ -109,11 +126,32 @@ class Storage {
   template < typename S >
   S view();
 
+  // Lazy copy sharing the data until either side calls unshare(). Storage
+  // methods that write call unshare() themselves; raw pointers do not.
+  Storage lazyCopy() const;
+  // Whether the data is still lazily shared with another storage
+  bool isShared() const;
+  // Make a private copy of the data if it is lazily shared
+  void unshare();
+
  private:
+  // Allocate count elements owned by a shared pointer that frees them using
+  // its own copy of the allocator. Both are accounted in memory statistics.
+  static shared_pointer allocate(A alloc, size_type count);
+
+  // Move the content to a new allocation of count elements
+  void reallocate(size_type count);
+  // Copy count elements between distinct buffers, in parallel for large
+  // counts and with memcpy for trivially copyable types
+  static void copyData(pointer dst, const_pointer src, size_type count);
+
   A alloc_;
   size_type size_;
+  size_type capacity_;
   shared_pointer shared_;
   pointer data_;
+  // Token held by all storages lazily sharing the same data
+  mutable ::std::shared_ptr< void > lazy_;
 };
 
 }  // namespace storage
@@ -0,0 +1,82 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_WORKSPACE_INL_HPP_
+#define THUNDER_STORAGE_WORKSPACE_INL_HPP_
+
+#include "thunder/storage/workspace.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include "thunder/storage/allocator-inl.hpp"
+
+namespace thunder {
+namespace storage {
+
+template < typename D >
+WorkspaceAllocator< D >::WorkspaceAllocator()
+    : workspace_(Workspace::current()) {}
+
+template < typename D >
+WorkspaceAllocator< D >::WorkspaceAllocator(Workspace *workspace)
+    : workspace_(workspace) {}
+
+template < typename D >
+typename WorkspaceAllocator< D >::pointer WorkspaceAllocator< D >::allocate(
+    size_type n, const void *) {
+  if (n > max_size()) {
+    throw ::std::bad_alloc();
+  }
+  if (workspace_ == nullptr) {
+    return AlignedAllocator< D >().allocate(n);
+  }
+  return static_cast< pointer >(
+      workspace_->allocate(n * sizeof(D), alignment(), &chunk_));
+}
+
+template < typename D >
+void WorkspaceAllocator< D >::deallocate(pointer p, size_type n) {
+  if (workspace_ == nullptr) {
+    AlignedAllocator< D >().deallocate(p, n);
+  }
+}
+
+template < typename D >
+typename WorkspaceAllocator< D >::size_type
+WorkspaceAllocator< D >::max_size() const {
+  return ::std::numeric_limits< size_type >::max() / 2 / sizeof(D);
+}
+
+template < typename D >
+Workspace* WorkspaceAllocator< D >::workspace() const {
+  return workspace_;
+}
+
+template < typename D >
+::std::shared_ptr< char > WorkspaceAllocator< D >::chunk() const {
+  return chunk_;
+}
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_WORKSPACE_INL_HPP_
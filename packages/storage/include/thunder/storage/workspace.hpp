@@ -0,0 +1,162 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_STORAGE_WORKSPACE_HPP_
+#define THUNDER_STORAGE_WORKSPACE_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "thunder/storage/allocator.hpp"
+
+namespace thunder {
+namespace storage {
+
+// Bump-pointer arena for temporaries. Allocation moves a pointer forward and
+// nothing is freed individually; reset() releases everything at once. When
+// one reset cycle needed several chunks they are merged into one, so a
+// steady workload ends up allocating from a single chunk. Allocations can
+// share ownership of their chunk, in which case reset() leaves the chunk to
+// its owners and carries on with a fresh one.
+class Workspace {
+ public:
+  typedef ::std::size_t size_type;
+
+  explicit Workspace(size_type bytes = 1 << 20);
+  ~Workspace();
+
+  Workspace(const Workspace &other) = delete;
+  Workspace &operator=(const Workspace &other) = delete;
+
+  // Allocate bytes aligned to align, which must be a power of 2. The memory
+  // is valid until the next reset().
+  void* allocate(size_type bytes, size_type align = 64);
+  // Allocate as above and set owner to share the chunk, so that the memory
+  // stays valid across reset() for as long as owner or its copies live.
+  void* allocate(size_type bytes, size_type align,
+                 ::std::shared_ptr< char > *owner);
+  // Release all allocations. Memory is kept for reuse.
+  void reset();
+
+  // Bytes handed out since the last reset
+  size_type used() const;
+  // Bytes held by the workspace
+  size_type capacity() const;
+
+  // Workspace installed by the innermost WorkspaceScope of this thread, or
+  // nullptr if there is none
+  static Workspace* current();
+
+ private:
+  friend class WorkspaceScope;
+
+  // Chunks as pointer and size. Allocations come from the last one.
+  ::std::vector< ::std::pair< ::std::shared_ptr< char >, size_type > > chunks_;
+  size_type offset_;
+  size_type used_;
+  size_type depth_;
+};
+
+// Installs a workspace as the current one of this thread for its lifetime.
+// The outermost scope of a workspace resets it on exit. Storages drawn from
+// it share their chunk, so those that outlive the scope remain valid.
+class WorkspaceScope {
+ public:
+  explicit WorkspaceScope(Workspace *workspace);
+  ~WorkspaceScope();
+
+  WorkspaceScope(const WorkspaceScope &other) = delete;
+  WorkspaceScope &operator=(const WorkspaceScope &other) = delete;
+
+ private:
+  Workspace *workspace_;
+  Workspace *previous_;
+};
+
+// Allocator drawing from a workspace. A default constructed allocator uses
+// the current workspace of the thread, and falls back to the heap if there
+// is none. Deallocation from a workspace is a no-op. Each allocation makes
+// the allocator share the chunk it came from, and Storage keeps a copy of
+// the allocator with its data, so storages may outlive the workspace scope.
+template < typename D >
+class WorkspaceAllocator {
+ public:
+  // Typedefs
+  typedef D value_type;
+  typedef D& reference;
+  typedef const D& const_reference;
+  typedef D* pointer;
+  typedef const D* const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+
+  template < typename U >
+  struct rebind {
+    typedef WorkspaceAllocator< U > other;
+  };
+
+  // Alignment in bytes of all allocations
+  static constexpr size_type alignment() {
+    return AlignedAllocator< D >::alignment();
+  }
+
+  WorkspaceAllocator();
+  explicit WorkspaceAllocator(Workspace *workspace);
+  template < typename U >
+  WorkspaceAllocator(const WorkspaceAllocator< U > &other)
+      : workspace_(other.workspace()), chunk_(other.chunk()) {}
+
+  pointer allocate(size_type n, const void *hint = nullptr);
+  void deallocate(pointer p, size_type n);
+  size_type max_size() const;
+
+  // The workspace used, or nullptr for the heap
+  Workspace *workspace() const;
+  // Chunk of the last allocation from the workspace
+  ::std::shared_ptr< char > chunk() const;
+
+  template < typename U >
+  bool operator==(const WorkspaceAllocator< U > &other) const {
+    return workspace_ == other.workspace();
+  }
+  template < typename U >
+  bool operator!=(const WorkspaceAllocator< U > &other) const {
+    return workspace_ != other.workspace();
+  }
+
+ private:
+  Workspace *workspace_;
+  ::std::shared_ptr< char > chunk_;
+};
+
+template < typename D >
+class AllocatorAlignment< WorkspaceAllocator< D > > {
+ public:
+  static constexpr ::std::size_t value = WorkspaceAllocator< D >::alignment();
+};
+
+template < typename D >
+constexpr ::std::size_t AllocatorAlignment< WorkspaceAllocator< D > >::value;
+
+}  // namespace storage
+}  // namespace thunder
+
+#endif  // THUNDER_STORAGE_WORKSPACE_HPP_
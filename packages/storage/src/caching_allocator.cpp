@@ -0,0 +1,190 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage/caching_allocator.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace thunder {
+namespace storage {
+
+namespace {
+
+// Requests of at most this many bytes share the smallest class
+const ::std::size_t min_bytes = 64;
+// Enough classes for any request allowed by max_size()
+const ::std::size_t classes = 256;
+// Blocks per class kept by a thread before sharing them with the pool
+const ::std::size_t thread_blocks = 4;
+
+// Size classes are 2^k * (1 + j / 4) for j = 1, 2, 3, 4 above min_bytes
+::std::size_t sizeClass(::std::size_t bytes) {
+  if (bytes <= min_bytes) {
+    return 0;
+  }
+  ::std::size_t k = 0;
+  while ((bytes - 1) >> (k + 1) != 0) {
+    ++k;
+  }
+  ::std::size_t base = static_cast< ::std::size_t >(1) << k;
+  return (k - 6) * 4 + (bytes - 1 - base) / (base / 4) + 1;
+}
+
+::std::size_t classBytes(::std::size_t c) {
+  if (c == 0) {
+    return min_bytes;
+  }
+  ::std::size_t base = static_cast< ::std::size_t >(1) << ((c - 1) / 4 + 6);
+  return base + ((c - 1) % 4 + 1) * (base / 4);
+}
+
+::std::atomic< ::std::size_t > ceiling_(static_cast< ::std::size_t >(1) << 30);
+::std::atomic< ::std::size_t > cached_(0);
+
+class Pool {
+ public:
+  ::std::mutex mutex;
+  ::std::vector< void* > blocks[classes];
+};
+
+// Never destroyed so that threads exiting late can still return blocks
+Pool* pool() {
+  static Pool *p = new Pool();
+  return p;
+}
+
+// Set once the cache of the thread is gone, during thread or program exit
+thread_local bool cache_destroyed_ = false;
+
+class ThreadCache {
+ public:
+  ~ThreadCache() {
+    Pool *p = pool();
+    ::std::lock_guard< ::std::mutex > lock(p->mutex);
+    for (::std::size_t c = 0; c < classes; ++c) {
+      p->blocks[c].insert(p->blocks[c].end(), blocks[c].begin(),
+                          blocks[c].end());
+    }
+    cache_destroyed_ = true;
+  }
+
+  ::std::vector< void* > blocks[classes];
+};
+
+thread_local ThreadCache cache_;
+
+}  // namespace
+
+void* cachedAllocate(::std::size_t bytes) {
+  ::std::size_t c = sizeClass(bytes);
+  ::std::size_t size = classBytes(c);
+
+  // Lock-free path from the cache of this thread
+  if (!cache_destroyed_ && !cache_.blocks[c].empty()) {
+    void *p = cache_.blocks[c].back();
+    cache_.blocks[c].pop_back();
+    cached_.fetch_sub(size);
+    return p;
+  }
+
+  {
+    Pool *p = pool();
+    ::std::lock_guard< ::std::mutex > lock(p->mutex);
+    if (!p->blocks[c].empty()) {
+      void *block = p->blocks[c].back();
+      p->blocks[c].pop_back();
+      cached_.fetch_sub(size);
+      return block;
+    }
+  }
+
+  // Cached blocks of other classes may be what keeps the system from
+  // satisfying the request, so release them before giving up
+  void *p = nullptr;
+  if (posix_memalign(&p, min_bytes, size) != 0) {
+    emptyCache();
+    if (posix_memalign(&p, min_bytes, size) != 0) {
+      throw ::std::bad_alloc();
+    }
+  }
+  return p;
+}
+
+void cachedDeallocate(void *p, ::std::size_t bytes) {
+  ::std::size_t c = sizeClass(bytes);
+  ::std::size_t size = classBytes(c);
+  if (cached_.fetch_add(size) + size > ceiling_.load()) {
+    cached_.fetch_sub(size);
+    ::std::free(p);
+    return;
+  }
+
+  if (!cache_destroyed_ && cache_.blocks[c].size() < thread_blocks) {
+    cache_.blocks[c].push_back(p);
+    return;
+  }
+  Pool *pl = pool();
+  ::std::lock_guard< ::std::mutex > lock(pl->mutex);
+  pl->blocks[c].push_back(p);
+}
+
+::std::size_t cachedBytes(::std::size_t bytes) {
+  return classBytes(sizeClass(bytes));
+}
+
+::std::size_t cacheSize() {
+  return cached_.load();
+}
+
+::std::size_t cacheCeiling() {
+  return ceiling_.load();
+}
+
+void setCacheCeiling(::std::size_t bytes) {
+  ceiling_.store(bytes);
+}
+
+void emptyCache() {
+  if (!cache_destroyed_) {
+    for (::std::size_t c = 0; c < classes; ++c) {
+      for (void *p : cache_.blocks[c]) {
+        ::std::free(p);
+      }
+      cached_.fetch_sub(cache_.blocks[c].size() * classBytes(c));
+      cache_.blocks[c].clear();
+    }
+  }
+  Pool *p = pool();
+  ::std::lock_guard< ::std::mutex > lock(p->mutex);
+  for (::std::size_t c = 0; c < classes; ++c) {
+    for (void *block : p->blocks[c]) {
+      ::std::free(block);
+    }
+    cached_.fetch_sub(p->blocks[c].size() * classBytes(c));
+    p->blocks[c].clear();
+  }
+}
+
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,168 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage/mapped.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "thunder/exception.hpp"
+
+namespace thunder {
+namespace storage {
+
+namespace {
+
+::std::string systemError(const ::std::string &what) {
+  return what + ": " + ::std::strerror(errno);
+}
+
+// Widen a memory range to the pages covering it
+void pageRange(const void *p, ::std::size_t bytes, char **begin,
+               ::std::size_t *length) {
+  ::std::size_t page = static_cast< ::std::size_t >(sysconf(_SC_PAGESIZE));
+  ::std::size_t address = reinterpret_cast< ::std::size_t >(p);
+  *begin = reinterpret_cast< char* >(address / page * page);
+  *length = address + bytes - address / page * page;
+}
+
+// Map an open file, leaving the descriptor open. Errors refer to the file
+// by name.
+::std::shared_ptr< char > mapDescriptor(int fd, MapMode mode,
+                                        ::std::size_t offset,
+                                        ::std::size_t *bytes,
+                                        const ::std::string &name) {
+  struct stat status;
+  if (fstat(fd, &status) != 0) {
+    throw io_error(systemError("Cannot stat " + name));
+  }
+
+  ::std::size_t size = static_cast< ::std::size_t >(status.st_size);
+  if (*bytes == 0) {
+    if (offset > size) {
+      throw out_of_range("Offset exceeds file size.");
+    }
+    *bytes = size - offset;
+  } else if (offset + *bytes > size) {
+    if (mode != MapMode::kReadWrite) {
+      throw out_of_range("Offset and size exceed file size.");
+    }
+    if (ftruncate(fd, static_cast< off_t >(offset + *bytes)) != 0) {
+      throw io_error(systemError("Cannot extend " + name));
+    }
+  }
+  if (*bytes == 0) {
+    return ::std::shared_ptr< char >();
+  }
+
+  // The mapping has to start at a page boundary of the file
+  ::std::size_t page = static_cast< ::std::size_t >(sysconf(_SC_PAGESIZE));
+  ::std::size_t begin = offset / page * page;
+  ::std::size_t length = offset + *bytes - begin;
+  void *p = mmap(nullptr, length, mode == MapMode::kReadOnly ? PROT_READ :
+                 PROT_READ | PROT_WRITE, mode == MapMode::kCopyOnWrite ?
+                 MAP_PRIVATE : MAP_SHARED, fd, static_cast< off_t >(begin));
+  if (p == MAP_FAILED) {
+    throw io_error(systemError("Cannot map " + name));
+  }
+
+  char *base = static_cast< char* >(p);
+  return ::std::shared_ptr< char >(
+      base + (offset - begin), [base, length](char *) {
+        munmap(base, length);
+      });
+}
+
+}  // namespace
+
+::std::shared_ptr< char > mapFile(const ::std::string &path, MapMode mode,
+                                  ::std::size_t offset, ::std::size_t *bytes) {
+  int fd = open(path.c_str(), mode == MapMode::kReadWrite ? O_RDWR | O_CREAT :
+                O_RDONLY, 0644);
+  if (fd < 0) {
+    throw io_error(systemError("Cannot open " + path));
+  }
+  ::std::shared_ptr< char > mapping;
+  try {
+    mapping = mapDescriptor(fd, mode, offset, bytes, path);
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+  return mapping;
+}
+
+::std::shared_ptr< char > mapFile(int fd, MapMode mode, ::std::size_t offset,
+                                  ::std::size_t *bytes) {
+  return mapDescriptor(fd, mode, offset, bytes,
+                       "file descriptor " + ::std::to_string(fd));
+}
+
+void adviseMemory(const void *p, ::std::size_t bytes, MapAdvice advice) {
+  if (p == nullptr || bytes == 0) {
+    return;
+  }
+  int flag = MADV_NORMAL;
+  switch (advice) {
+    case MapAdvice::kSequential:
+      flag = MADV_SEQUENTIAL;
+      break;
+    case MapAdvice::kRandom:
+      flag = MADV_RANDOM;
+      break;
+    case MapAdvice::kWillNeed:
+      flag = MADV_WILLNEED;
+      break;
+    case MapAdvice::kDontNeed:
+      flag = MADV_DONTNEED;
+      break;
+    default:
+      break;
+  }
+
+  // Hints are best effort, so failures are ignored
+  char *begin = nullptr;
+  ::std::size_t length = 0;
+  pageRange(p, bytes, &begin, &length);
+  madvise(begin, length, flag);
+}
+
+void syncMemory(const void *p, ::std::size_t bytes, bool async) {
+  if (p == nullptr || bytes == 0) {
+    return;
+  }
+  char *begin = nullptr;
+  ::std::size_t length = 0;
+  pageRange(p, bytes, &begin, &length);
+  if (msync(begin, length, async ? MS_ASYNC : MS_SYNC) != 0) {
+    throw io_error(systemError("Cannot sync mapped memory"));
+  }
+}
+
+}  // namespace storage
+}  // namespace thunder
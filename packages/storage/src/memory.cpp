@@ -0,0 +1,273 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage/memory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace thunder {
+namespace storage {
+
+namespace {
+
+::std::atomic< bool > accounting_(true);
+::std::atomic< ::std::size_t > threshold_(
+    static_cast< ::std::size_t >(1) << 20);
+
+// Innermost tag of the current thread
+thread_local MemoryCounter *tag_ = nullptr;
+
+struct Block {
+  MemoryCounter *type;
+  MemoryCounter *tag;
+  ::std::size_t bytes;
+  ::std::vector< ::std::size_t > shape;
+};
+
+class Registry {
+ public:
+  ::std::mutex mutex;
+  ::std::map< ::std::string, MemoryCounter* > types;
+  ::std::map< ::std::string, MemoryCounter* > tags;
+  ::std::unordered_map< const void*, Block > blocks;
+};
+
+// Never destroyed so that storages freed during program exit are accounted
+Registry* registry() {
+  static Registry *r = new Registry();
+  return r;
+}
+
+::std::string typeName(const ::std::type_info &type) {
+#ifdef __GNUG__
+  int status = 0;
+  char *name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+  if (status == 0 && name != nullptr) {
+    ::std::string result(name);
+    ::std::free(name);
+    return result;
+  }
+#endif
+  return type.name();
+}
+
+::std::vector< MemoryStats > collect(
+    const ::std::map< ::std::string, MemoryCounter* > &counters) {
+  ::std::vector< MemoryStats > result;
+  for (const auto &pair : counters) {
+    result.push_back(pair.second->stats());
+  }
+  return result;
+}
+
+}  // namespace
+
+MemoryCounter::MemoryCounter(const ::std::string &name)
+    : name_(name), live_bytes_(0), peak_bytes_(0), allocations_(0),
+      deallocations_(0) {}
+
+void MemoryCounter::acquire(::std::size_t bytes) {
+  ::std::size_t live = live_bytes_.fetch_add(bytes) + bytes;
+  ::std::size_t peak = peak_bytes_.load();
+  while (live > peak && !peak_bytes_.compare_exchange_weak(peak, live)) {}
+  allocations_.fetch_add(1);
+}
+
+void MemoryCounter::release(::std::size_t bytes) {
+  live_bytes_.fetch_sub(bytes);
+  deallocations_.fetch_add(1);
+}
+
+void MemoryCounter::resetPeak() {
+  peak_bytes_.store(live_bytes_.load());
+}
+
+const ::std::string &MemoryCounter::name() const {
+  return name_;
+}
+
+MemoryStats MemoryCounter::stats() const {
+  MemoryStats result;
+  result.name = name_;
+  result.live_bytes = live_bytes_.load();
+  result.peak_bytes = peak_bytes_.load();
+  result.allocations = allocations_.load();
+  result.deallocations = deallocations_.load();
+  return result;
+}
+
+MemoryScope::MemoryScope(const ::std::string &tag) : previous_(tag_) {
+  Registry *r = registry();
+  ::std::lock_guard< ::std::mutex > lock(r->mutex);
+  MemoryCounter *&counter = r->tags[tag];
+  if (counter == nullptr) {
+    counter = new MemoryCounter(tag);
+  }
+  tag_ = counter;
+}
+
+MemoryScope::~MemoryScope() {
+  tag_ = previous_;
+}
+
+bool memoryAccounting() {
+  return accounting_.load();
+}
+
+void setMemoryAccounting(bool enable) {
+  accounting_.store(enable);
+}
+
+::std::size_t memoryTrackThreshold() {
+  return threshold_.load();
+}
+
+void setMemoryTrackThreshold(::std::size_t bytes) {
+  threshold_.store(bytes);
+}
+
+::std::vector< MemoryStats > memoryStatsByType() {
+  Registry *r = registry();
+  ::std::lock_guard< ::std::mutex > lock(r->mutex);
+  return collect(r->types);
+}
+
+::std::vector< MemoryStats > memoryStatsByTag() {
+  Registry *r = registry();
+  ::std::lock_guard< ::std::mutex > lock(r->mutex);
+  return collect(r->tags);
+}
+
+void resetMemoryPeak() {
+  Registry *r = registry();
+  ::std::lock_guard< ::std::mutex > lock(r->mutex);
+  for (const auto &pair : r->types) {
+    pair.second->resetPeak();
+  }
+  for (const auto &pair : r->tags) {
+    pair.second->resetPeak();
+  }
+}
+
+::std::vector< MemoryBlock > memorySnapshot(::std::size_t count) {
+  ::std::vector< MemoryBlock > result;
+  {
+    Registry *r = registry();
+    ::std::lock_guard< ::std::mutex > lock(r->mutex);
+    for (const auto &pair : r->blocks) {
+      MemoryBlock block;
+      block.data = pair.first;
+      block.bytes = pair.second.bytes;
+      block.type = pair.second.type->name();
+      if (pair.second.tag != nullptr) {
+        block.tag = pair.second.tag->name();
+      }
+      block.shape = pair.second.shape;
+      result.push_back(block);
+    }
+  }
+  count = ::std::min(count, result.size());
+  ::std::partial_sort(
+      result.begin(), result.begin() + count, result.end(),
+      [](const MemoryBlock &a, const MemoryBlock &b) {
+        return a.bytes > b.bytes;
+      });
+  result.resize(count);
+  return result;
+}
+
+MemoryCounter* memoryTypeCounter(const ::std::type_info &type) {
+  ::std::string name = typeName(type);
+  Registry *r = registry();
+  ::std::lock_guard< ::std::mutex > lock(r->mutex);
+  MemoryCounter *&counter = r->types[name];
+  if (counter == nullptr) {
+    counter = new MemoryCounter(name);
+  }
+  return counter;
+}
+
+MemoryRecord memoryAcquire(MemoryCounter *type, const void *data,
+                           ::std::size_t bytes) {
+  MemoryRecord record = {nullptr, nullptr, bytes, false};
+  if (!accounting_.load()) {
+    return record;
+  }
+  record.type = type;
+  record.tag = tag_;
+  type->acquire(bytes);
+  if (record.tag != nullptr) {
+    record.tag->acquire(bytes);
+  }
+  if (bytes >= threshold_.load()) {
+    Registry *r = registry();
+    ::std::lock_guard< ::std::mutex > lock(r->mutex);
+    Block &block = r->blocks[data];
+    block.type = record.type;
+    block.tag = record.tag;
+    block.bytes = bytes;
+    block.shape.clear();
+    record.tracked = true;
+  }
+  return record;
+}
+
+void memoryRelease(const MemoryRecord &record, const void *data) {
+  if (record.type == nullptr) {
+    return;
+  }
+  record.type->release(record.bytes);
+  if (record.tag != nullptr) {
+    record.tag->release(record.bytes);
+  }
+  if (record.tracked) {
+    Registry *r = registry();
+    ::std::lock_guard< ::std::mutex > lock(r->mutex);
+    r->blocks.erase(data);
+  }
+}
+
+void memoryAnnotate(const void *data, ::std::size_t bytes,
+                    const ::std::size_t *shape, ::std::size_t dimension) {
+  if (!accounting_.load() || bytes < threshold_.load()) {
+    return;
+  }
+  Registry *r = registry();
+  ::std::lock_guard< ::std::mutex > lock(r->mutex);
+  auto found = r->blocks.find(data);
+  if (found != r->blocks.end()) {
+    found->second.shape.assign(shape, shape + dimension);
+  }
+}
+
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,113 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage/numa.hpp"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace thunder {
+namespace storage {
+
+namespace {
+
+// Memory policy modes of the mbind system call
+const int mpol_default = 0;
+const int mpol_preferred = 1;
+const int mpol_bind = 2;
+const int mpol_interleave = 3;
+
+const ::std::size_t word_bits = sizeof(unsigned long) * 8;
+
+}  // namespace
+
+::std::size_t numaNodes() {
+  static const ::std::size_t nodes = []() {
+    // The online list holds ranges such as 0-1,4 and may have holes, so the
+    // count covers the highest node rather than stopping at the first gap
+    ::std::ifstream file("/sys/devices/system/node/online");
+    ::std::string range;
+    ::std::size_t n = 0;
+    while (::std::getline(file, range, ',')) {
+      ::std::size_t dash = range.find('-');
+      const char *last = range.c_str() +
+          (dash == ::std::string::npos ? 0 : dash + 1);
+      char *end = nullptr;
+      unsigned long node = ::std::strtoul(last, &end, 10);
+      if (end == last) {
+        break;
+      }
+      if (node + 1 > n) {
+        n = node + 1;
+      }
+    }
+    return n == 0 ? 1 : n;
+  }();
+  return nodes;
+}
+
+bool numaPlace(void *p, ::std::size_t bytes, NumaPolicy policy,
+               ::std::size_t node) {
+#ifdef SYS_mbind
+  ::std::size_t nodes = numaNodes();
+  ::std::vector< unsigned long > mask((nodes + word_bits - 1) / word_bits, 0);
+  int mode = mpol_default;
+  switch (policy) {
+    case NumaPolicy::kLocal:
+      // Preferred with an empty mask means the node of the touching thread
+      mode = mpol_preferred;
+      break;
+    case NumaPolicy::kInterleave:
+      mode = mpol_interleave;
+      for (::std::size_t i = 0; i < nodes; ++i) {
+        mask[i / word_bits] |= 1UL << (i % word_bits);
+      }
+      break;
+    case NumaPolicy::kBind:
+      if (node >= nodes) {
+        return false;
+      }
+      mode = mpol_bind;
+      mask[node / word_bits] |= 1UL << (node % word_bits);
+      break;
+    default:
+      break;
+  }
+
+  // The range has to start at a page boundary
+  ::std::size_t page = static_cast< ::std::size_t >(sysconf(_SC_PAGESIZE));
+  ::std::size_t address = reinterpret_cast< ::std::size_t >(p);
+  ::std::size_t begin = address / page * page;
+  return syscall(SYS_mbind, reinterpret_cast< void* >(begin),
+                 address + bytes - begin, mode,
+                 mode == mpol_default || mode == mpol_preferred ?
+                 nullptr : mask.data(), mask.size() * word_bits + 1, 0) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,181 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage/shared_memory.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "thunder/exception.hpp"
+
+namespace thunder {
+namespace storage {
+
+namespace {
+
+// Spells THUNDERS, written last by the creator once the header is complete
+const ::std::uint64_t segment_magic = 0x5352454e44554854ULL;
+
+// Header in the first page of a segment, so that the data is page aligned
+struct SegmentHeader {
+  ::std::atomic< ::std::uint64_t > magic;
+  ::std::atomic< ::std::uint64_t > references;
+  ::std::uint64_t bytes;
+};
+
+::std::string systemError(const ::std::string &what) {
+  return what + ": " + ::std::strerror(errno);
+}
+
+::std::size_t pageSize() {
+  return static_cast< ::std::size_t >(sysconf(_SC_PAGESIZE));
+}
+
+// Map the data of a segment whose header already counts this mapping. The
+// returned pointer drops the count and removes the name when it reaches zero.
+::std::shared_ptr< char > mapSegment(const ::std::string &name, int fd,
+                                     SegmentHeader *header,
+                                     ::std::size_t bytes, MapMode mode) {
+  ::std::size_t page = pageSize();
+  char *data = nullptr;
+  if (bytes != 0) {
+    void *p = mmap(nullptr, bytes, mode == MapMode::kReadOnly ? PROT_READ :
+                   PROT_READ | PROT_WRITE, mode == MapMode::kCopyOnWrite ?
+                   MAP_PRIVATE : MAP_SHARED, fd, static_cast< off_t >(page));
+    if (p == MAP_FAILED) {
+      ::std::string error = systemError("Cannot map shared memory " + name);
+      if (header->references.fetch_sub(1) == 1) {
+        shm_unlink(name.c_str());
+      }
+      munmap(header, page);
+      close(fd);
+      throw io_error(error);
+    }
+    data = static_cast< char* >(p);
+  }
+  close(fd);
+  return ::std::shared_ptr< char >(
+      data, [name, header, page, data, bytes](char *) {
+        if (data != nullptr) {
+          munmap(data, bytes);
+        }
+        if (header->references.fetch_sub(1) == 1) {
+          shm_unlink(name.c_str());
+        }
+        munmap(header, page);
+      });
+}
+
+}  // namespace
+
+::std::shared_ptr< char > createSharedMemory(const ::std::string &name,
+                                             ::std::size_t bytes) {
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    throw io_error(systemError("Cannot create shared memory " + name));
+  }
+  ::std::size_t page = pageSize();
+  if (ftruncate(fd, static_cast< off_t >(page + bytes)) != 0) {
+    ::std::string error = systemError("Cannot size shared memory " + name);
+    close(fd);
+    shm_unlink(name.c_str());
+    throw io_error(error);
+  }
+  void *p = mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    ::std::string error = systemError("Cannot map shared memory " + name);
+    close(fd);
+    shm_unlink(name.c_str());
+    throw io_error(error);
+  }
+
+  SegmentHeader *header = new (p) SegmentHeader();
+  header->bytes = bytes;
+  header->references.store(1);
+  header->magic.store(segment_magic);
+  return mapSegment(name, fd, header, bytes, MapMode::kReadWrite);
+}
+
+::std::shared_ptr< char > openSharedMemory(const ::std::string &name,
+                                           MapMode mode, ::std::size_t *bytes) {
+  // Even read-only mappings write the reference count in the header
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw io_error(systemError("Cannot open shared memory " + name));
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0) {
+    ::std::string error = systemError("Cannot stat shared memory " + name);
+    close(fd);
+    throw io_error(error);
+  }
+  ::std::size_t page = pageSize();
+  ::std::size_t size = static_cast< ::std::size_t >(status.st_size);
+  if (size < page) {
+    close(fd);
+    throw invalid_argument("Shared memory " + name + " is not a segment.");
+  }
+  void *p = mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    ::std::string error = systemError("Cannot map shared memory " + name);
+    close(fd);
+    throw io_error(error);
+  }
+
+  SegmentHeader *header = static_cast< SegmentHeader* >(p);
+  if (header->magic.load() != segment_magic ||
+      size < page + header->bytes) {
+    munmap(p, page);
+    close(fd);
+    throw invalid_argument("Shared memory " + name + " is not a segment.");
+  }
+  // A segment whose count reached zero is being removed and cannot be revived
+  ::std::uint64_t references = header->references.load();
+  do {
+    if (references == 0) {
+      munmap(p, page);
+      close(fd);
+      throw io_error("Shared memory " + name + " has been released.");
+    }
+  } while (!header->references.compare_exchange_weak(
+      references, references + 1));
+
+  *bytes = static_cast< ::std::size_t >(header->bytes);
+  return mapSegment(name, fd, header, *bytes, mode);
+}
+
+void removeSharedMemory(const ::std::string &name) {
+  if (shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+    throw io_error(systemError("Cannot remove shared memory " + name));
+  }
+}
+
+}  // namespace storage
+}  // namespace thunder
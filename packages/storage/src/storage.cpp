@@ -17,9 +17,18 @@
  * @}
  */
 
+#include "thunder/storage/allocator.hpp"
+#include "thunder/storage/caching_allocator.hpp"
+#include "thunder/storage/mapped.hpp"
+#include "thunder/storage/numa.hpp"
+#include "thunder/storage/shared_memory.hpp"
+#include "thunder/storage/small_storage.hpp"
 #include "thunder/storage/storage.hpp"
+#include "thunder/storage/workspace.hpp"
 
 #include <complex>
+#include <cstddef>
+#include <string>
 #include <utility>
 
 #include "thunder/serializer.hpp"
@@ -32,7 +41,14 @@
 #include "thunder/serializer/serializer-inl.hpp"
 #include "thunder/serializer/static-inl.hpp"
 #include "thunder/serializer/text_protocol-inl.hpp"
+#include "thunder/storage/allocator-inl.hpp"
+#include "thunder/storage/caching_allocator-inl.hpp"
+#include "thunder/storage/mapped-inl.hpp"
+#include "thunder/storage/numa-inl.hpp"
+#include "thunder/storage/shared_memory-inl.hpp"
+#include "thunder/storage/small_storage-inl.hpp"
 #include "thunder/storage/storage-inl.hpp"
+#include "thunder/storage/workspace-inl.hpp"
 
 namespace thunder {
 namespace storage {
@@ -45,6 +61,90 @@ template class Storage< ::std::size_t >;
 template class Storage< ::std::ptrdiff_t >;
 template class Storage< ::std::pair< ::std::size_t, ::std::size_t > >;
 
+template class AlignedAllocator< double >;
+template class AlignedAllocator< float >;
+template class AlignedAllocator< ::std::complex< double > >;
+template class AlignedAllocator< ::std::complex< float > >;
+template class AlignedAllocator< ::std::size_t >;
+template class AlignedAllocator< ::std::ptrdiff_t >;
+template class AlignedAllocator<
+  ::std::pair< ::std::size_t, ::std::size_t > >;
+template class HugePageAllocator< double >;
+template class HugePageAllocator< float >;
+#ifndef THUNDER_ALIGNED_STORAGE
+template class Storage< double, AlignedAllocator< double > >;
+template class Storage< float, AlignedAllocator< float > >;
+#endif
+template class Storage< double, HugePageAllocator< double > >;
+template class Storage< float, HugePageAllocator< float > >;
+template class CachingAllocator< double >;
+template class CachingAllocator< float >;
+template class CachingAllocator< ::std::complex< double > >;
+template class CachingAllocator< ::std::complex< float > >;
+template class Storage< double, CachingAllocator< double > >;
+template class Storage< float, CachingAllocator< float > >;
+template class Storage< ::std::complex< double >,
+  CachingAllocator< ::std::complex< double > > >;
+template class Storage< ::std::complex< float >,
+  CachingAllocator< ::std::complex< float > > >;
+template class NumaAllocator< double >;
+template class NumaAllocator< float >;
+template class Storage< double, NumaAllocator< double > >;
+template class Storage< float, NumaAllocator< float > >;
+template class WorkspaceAllocator< double >;
+template class WorkspaceAllocator< float >;
+template class WorkspaceAllocator< ::std::complex< double > >;
+template class WorkspaceAllocator< ::std::complex< float > >;
+template class Storage< double, WorkspaceAllocator< double > >;
+template class Storage< float, WorkspaceAllocator< float > >;
+template class Storage< ::std::complex< double >,
+  WorkspaceAllocator< ::std::complex< double > > >;
+template class Storage< ::std::complex< float >,
+  WorkspaceAllocator< ::std::complex< float > > >;
+
+#define THUNDER_STORAGE_INSTANTIATE_MAPPED(D)                   \
+  template Storage< D > mapStorage(                             \
+      const ::std::string &path, MapMode mode,                  \
+      typename Storage< D >::size_type count,                   \
+      ::std::size_t offset);                                    \
+  template void advise(const Storage< D > &s,                   \
+                        MapAdvice advice);                      \
+  template void sync(const Storage< D > &s, bool async);
+
+THUNDER_STORAGE_INSTANTIATE_MAPPED(double);
+THUNDER_STORAGE_INSTANTIATE_MAPPED(float);
+THUNDER_STORAGE_INSTANTIATE_MAPPED(::std::complex< double >);
+THUNDER_STORAGE_INSTANTIATE_MAPPED(::std::complex< float >);
+
+#undef THUNDER_STORAGE_INSTANTIATE_MAPPED
+
+#define THUNDER_STORAGE_INSTANTIATE_SHARED(D)                           \
+  template Storage< D > createSharedStorage(                            \
+      const ::std::string &name,                                        \
+      typename Storage< D >::size_type count);                          \
+  template Storage< D > publishStorage(                                 \
+      const ::std::string &name, const Storage< D > &s);                \
+  template Storage< D > openSharedStorage(                              \
+      const ::std::string &name, MapMode mode);
+
+THUNDER_STORAGE_INSTANTIATE_SHARED(double);
+THUNDER_STORAGE_INSTANTIATE_SHARED(float);
+THUNDER_STORAGE_INSTANTIATE_SHARED(::std::complex< double >);
+THUNDER_STORAGE_INSTANTIATE_SHARED(::std::complex< float >);
+
+#undef THUNDER_STORAGE_INSTANTIATE_SHARED
+
+template class SmallStorage< ::std::size_t >;
+template class SmallStorage< ::std::ptrdiff_t >;
+template SmallStorage< ::std::size_t >::SmallStorage(
+    const Storage< ::std::size_t > &other);
+template SmallStorage< ::std::ptrdiff_t >::SmallStorage(
+    const Storage< ::std::ptrdiff_t > &other);
+template SmallStorage< ::std::size_t >::operator
+Storage< ::std::size_t >() const;
+template SmallStorage< ::std::ptrdiff_t >::operator
+Storage< ::std::ptrdiff_t >() const;
+
 template Storage< double > Storage<
   ::std::complex< double > >::template view< Storage< double > >();
 template Storage< float > Storage<
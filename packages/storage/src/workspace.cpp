@@ -0,0 +1,133 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage/workspace.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace thunder {
+namespace storage {
+
+namespace {
+
+// Alignment of chunks
+const ::std::size_t chunk_alignment = 64;
+
+thread_local Workspace *current_ = nullptr;
+
+::std::shared_ptr< char > allocateChunk(::std::size_t bytes) {
+  void *p = nullptr;
+  if (posix_memalign(&p, chunk_alignment, bytes) != 0) {
+    throw ::std::bad_alloc();
+  }
+  return ::std::shared_ptr< char >(static_cast< char* >(p), ::std::free);
+}
+
+}  // namespace
+
+Workspace::Workspace(size_type bytes) : offset_(0), used_(0), depth_(0) {
+  if (bytes > 0) {
+    chunks_.emplace_back(allocateChunk(bytes), bytes);
+  }
+}
+
+Workspace::~Workspace() {}
+
+void* Workspace::allocate(size_type bytes, size_type align) {
+  if (!chunks_.empty()) {
+    char *data = chunks_.back().first.get();
+    ::std::uintptr_t base = reinterpret_cast< ::std::uintptr_t >(data);
+    size_type begin = ((base + offset_ + align - 1) & ~(align - 1)) - base;
+    if (begin + bytes <= chunks_.back().second) {
+      offset_ = begin + bytes;
+      used_ += bytes;
+      return data + begin;
+    }
+  }
+
+  // Grow geometrically so that the number of chunks stays logarithmic
+  size_type size = chunks_.empty() ? 0 : chunks_.back().second * 2;
+  if (size < bytes + align) {
+    size = bytes + align;
+  }
+  chunks_.emplace_back(allocateChunk(size), size);
+  offset_ = 0;
+  return allocate(bytes, align);
+}
+
+void* Workspace::allocate(size_type bytes, size_type align,
+                          ::std::shared_ptr< char > *owner) {
+  void *p = allocate(bytes, align);
+  *owner = chunks_.back().first;
+  return p;
+}
+
+void Workspace::reset() {
+  // Chunks still shared by storages are left to them
+  bool shared = false;
+  for (const ::std::pair< ::std::shared_ptr< char >, size_type > &chunk :
+           chunks_) {
+    shared = shared || chunk.first.use_count() > 1;
+  }
+  if (chunks_.size() > 1 || shared) {
+    size_type size = capacity();
+    chunks_.clear();
+    chunks_.emplace_back(allocateChunk(size), size);
+  }
+  offset_ = 0;
+  used_ = 0;
+}
+
+Workspace::size_type Workspace::used() const {
+  return used_;
+}
+
+Workspace::size_type Workspace::capacity() const {
+  size_type size = 0;
+  for (const ::std::pair< ::std::shared_ptr< char >, size_type > &chunk :
+           chunks_) {
+    size += chunk.second;
+  }
+  return size;
+}
+
+Workspace* Workspace::current() {
+  return current_;
+}
+
+WorkspaceScope::WorkspaceScope(Workspace *workspace)
+    : workspace_(workspace), previous_(current_) {
+  ++workspace_->depth_;
+  current_ = workspace_;
+}
+
+WorkspaceScope::~WorkspaceScope() {
+  current_ = previous_;
+  if (--workspace_->depth_ == 0) {
+    workspace_->reset();
+  }
+}
+
+}  // namespace storage
+}  // namespace thunder
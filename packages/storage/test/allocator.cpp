@@ -0,0 +1,111 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/allocator.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "thunder/storage/allocator-inl.hpp"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+bool isAligned(const void *p, ::std::size_t align) {
+  return reinterpret_cast< ::std::uintptr_t >(p) % align == 0;
+}
+
+template < typename S >
+void alignedTest() {
+  typedef typename S::value_type D;
+  typedef typename S::allocator_type A;
+  ::std::size_t align = AllocatorAlignment< A >::value;
+  EXPECT_LE(64, align);
+
+  // Every allocation path returns aligned data
+  S s1(17, static_cast< D >(3));
+  EXPECT_TRUE(isAligned(s1.data(), align));
+  S s2(s1);
+  EXPECT_TRUE(isAligned(s2.data(), align));
+  for (::std::size_t i = 0; i < s2.size(); ++i) {
+    EXPECT_EQ(static_cast< D >(3), s2[i]);
+  }
+  s2.resize(1000, static_cast< D >(5));
+  EXPECT_TRUE(isAligned(s2.data(), align));
+  for (::std::size_t i = 0; i < s2.size(); ++i) {
+    EXPECT_EQ(static_cast< D >(5), s2[i]);
+  }
+
+  // Storages outliving the one that allocated their data free it correctly
+  S s3(::std::move(s2));
+  S s4;
+  s4 = s3;
+  s3.resize(3);
+  EXPECT_EQ(1000, s4.size());
+  EXPECT_EQ(static_cast< D >(5), s4[999]);
+}
+
+TEST(AllocatorTest, alignedTest) {
+  alignedTest< AlignedDoubleStorage >();
+  alignedTest< AlignedFloatStorage >();
+  alignedTest< HugePageDoubleStorage >();
+  alignedTest< HugePageFloatStorage >();
+}
+
+TEST(AllocatorTest, alignmentTest) {
+  EXPECT_EQ(64, (AllocatorAlignment< AlignedAllocator< float > >::value));
+  EXPECT_EQ(4096,
+            (AllocatorAlignment< AlignedAllocator< float, 4096 > >::value));
+  EXPECT_LE(alignof(double),
+            AllocatorAlignment< ::std::allocator< double > >::value);
+
+  AlignedAllocator< double, 4096 > alloc;
+  double *p = alloc.allocate(3);
+  EXPECT_TRUE(isAligned(p, 4096));
+  alloc.deallocate(p, 3);
+
+  // Rebinding keeps the alignment
+  AlignedAllocator< ::std::complex< double >, 4096 > other(alloc);
+  EXPECT_TRUE(other == alloc);
+}
+
+TEST(AllocatorTest, hugePageTest) {
+  // Large allocations are mapped in whole huge pages
+  typedef HugePageAllocator< double > A;
+  ::std::size_t n = A::page() / sizeof(double) * 3 / 2;
+  HugePageDoubleStorage s(n, 1.0);
+  EXPECT_TRUE(isAligned(s.data(), 4096));
+  EXPECT_EQ(1.0, s[0]);
+  EXPECT_EQ(1.0, s[n - 1]);
+
+  // Growing and shrinking across the mapping threshold
+  s.resize(7, 2.0);
+  EXPECT_EQ(2.0, s[6]);
+  s.resize(n * 2, 3.0);
+  EXPECT_EQ(3.0, s[n * 2 - 1]);
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
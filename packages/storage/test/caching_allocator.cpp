@@ -0,0 +1,102 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/caching_allocator.hpp"
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+TEST(CachingAllocatorTest, sizeClassTest) {
+  EXPECT_EQ(64, cachedBytes(1));
+  EXPECT_EQ(64, cachedBytes(64));
+  EXPECT_EQ(80, cachedBytes(65));
+  EXPECT_EQ(128, cachedBytes(128));
+  EXPECT_EQ(160, cachedBytes(129));
+  EXPECT_EQ(1280, cachedBytes(1025));
+  for (::std::size_t bytes = 1; bytes < 100000; bytes += 37) {
+    EXPECT_LE(bytes, cachedBytes(bytes));
+    EXPECT_GE(bytes + bytes / 4 + 64, cachedBytes(bytes));
+  }
+}
+
+TEST(CachingAllocatorTest, reuseTest) {
+  emptyCache();
+  EXPECT_EQ(0, cacheSize());
+
+  // A freed block is handed back for the next request of its class
+  double *data = nullptr;
+  {
+    CachingDoubleStorage s(1000, 1.0);
+    data = s.data();
+  }
+  EXPECT_EQ(cachedBytes(1000 * sizeof(double)), cacheSize());
+  {
+    CachingDoubleStorage s(990);
+    EXPECT_EQ(data, s.data());
+    EXPECT_EQ(0, cacheSize());
+  }
+
+  // Nothing beyond the ceiling is kept
+  ::std::size_t ceiling = cacheCeiling();
+  emptyCache();
+  setCacheCeiling(0);
+  {
+    CachingDoubleStorage s(1000);
+  }
+  EXPECT_EQ(0, cacheSize());
+  setCacheCeiling(ceiling);
+}
+
+TEST(CachingAllocatorTest, threadTest) {
+  emptyCache();
+
+  // Blocks freed in one thread are shared with others through the pool
+  ::std::vector< ::std::thread > threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+        for (int i = 0; i < 1000; ++i) {
+          ::std::vector< CachingFloatStorage > v;
+          for (int j = 1; j < 10; ++j) {
+            v.emplace_back(j * 100, static_cast< float >(j));
+          }
+          for (int j = 1; j < 10; ++j) {
+            EXPECT_EQ(static_cast< float >(j), v[j - 1][j * 100 - 1]);
+          }
+        }
+      });
+  }
+  for (::std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_LT(0, cacheSize());
+  emptyCache();
+  EXPECT_EQ(0, cacheSize());
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,104 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/mapped.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/test/temporary_file.hpp"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+using test::temporaryFile;
+
+TEST(MappedTest, readTest) {
+  ::std::string path = temporaryFile();
+  {
+    ::std::ofstream file(path, ::std::ios::binary);
+    for (int i = 0; i < 1000; ++i) {
+      double value = i;
+      file.write(reinterpret_cast< const char* >(&value), sizeof(value));
+    }
+  }
+
+  DoubleStorage s = mapStorage< DoubleStorage >(path);
+  EXPECT_EQ(1000, s.size());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(static_cast< double >(i), s[i]);
+  }
+  advise(s, MapAdvice::kSequential);
+  advise(s, MapAdvice::kWillNeed);
+
+  // Offsets need not be page aligned
+  DoubleStorage t = mapStorage< DoubleStorage >(
+      path, MapMode::kReadOnly, 10, 600 * sizeof(double));
+  EXPECT_EQ(10, t.size());
+  EXPECT_EQ(600.0, t[0]);
+  EXPECT_EQ(609.0, t[9]);
+
+  // Copies own their data and outlive the mapping
+  DoubleStorage u(t);
+  t = DoubleStorage();
+  EXPECT_EQ(609.0, u[9]);
+
+  EXPECT_THROW(mapStorage< DoubleStorage >(path, MapMode::kReadOnly, 1001),
+               out_of_range);
+  EXPECT_THROW(mapStorage< DoubleStorage >(path + ".missing"), io_error);
+  EXPECT_THROW(mapStorage< DoubleStorage >(path, MapMode::kReadOnly, 10, 4),
+               invalid_argument);
+  ::std::remove(path.c_str());
+}
+
+TEST(MappedTest, writeTest) {
+  ::std::string path = temporaryFile();
+
+  // Read-write mappings create the file contents and write them back
+  {
+    FloatStorage s =
+        mapStorage< FloatStorage >(path, MapMode::kReadWrite, 5000);
+    EXPECT_EQ(5000, s.size());
+    for (int i = 0; i < 5000; ++i) {
+      s[i] = static_cast< float >(i * 2);
+    }
+    sync(s);
+  }
+  FloatStorage s = mapStorage< FloatStorage >(path);
+  EXPECT_EQ(5000, s.size());
+  EXPECT_EQ(9998.0f, s[4999]);
+
+  // Copy-on-write changes never reach the file
+  {
+    FloatStorage c = mapStorage< FloatStorage >(path, MapMode::kCopyOnWrite);
+    c[0] = -1.0f;
+    EXPECT_EQ(-1.0f, c[0]);
+  }
+  EXPECT_EQ(0.0f, s[0]);
+  ::std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,125 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/memory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+MemoryStats find(const ::std::vector< MemoryStats > &stats,
+                 const ::std::string &name) {
+  for (const MemoryStats &s : stats) {
+    if (s.name == name) {
+      return s;
+    }
+  }
+  return MemoryStats{name, 0, 0, 0, 0};
+}
+
+TEST(MemoryTest, typeTest) {
+  MemoryStats before = find(memoryStatsByType(), "double");
+  {
+    DoubleStorage s1(1000);
+    DoubleStorage s2(500);
+    MemoryStats during = find(memoryStatsByType(), "double");
+    EXPECT_EQ(before.live_bytes + 1500 * sizeof(double), during.live_bytes);
+    EXPECT_LE(during.live_bytes, during.peak_bytes);
+    EXPECT_EQ(before.allocations + 2, during.allocations);
+  }
+  MemoryStats after = find(memoryStatsByType(), "double");
+  EXPECT_EQ(before.live_bytes, after.live_bytes);
+  EXPECT_EQ(before.deallocations + 2, after.deallocations);
+  EXPECT_LE(before.live_bytes + 1500 * sizeof(double), after.peak_bytes);
+  resetMemoryPeak();
+  EXPECT_EQ(after.live_bytes, find(memoryStatsByType(), "double").peak_bytes);
+
+  // Allocations made while accounting is off are never counted
+  setMemoryAccounting(false);
+  FloatStorage s3(1000);
+  setMemoryAccounting(true);
+  MemoryStats floats = find(memoryStatsByType(), "float");
+  s3 = FloatStorage();
+  EXPECT_EQ(floats.live_bytes, find(memoryStatsByType(), "float").live_bytes);
+}
+
+TEST(MemoryTest, scopeTest) {
+  DoubleStorage s1;
+  {
+    MemoryScope outer("outer");
+    s1.resize(100);
+    {
+      MemoryScope inner("inner");
+      DoubleStorage s2(200);
+      EXPECT_EQ(200 * sizeof(double),
+                find(memoryStatsByTag(), "inner").live_bytes);
+    }
+  }
+  EXPECT_EQ(100 * sizeof(double),
+            find(memoryStatsByTag(), "outer").live_bytes);
+  EXPECT_EQ(0, find(memoryStatsByTag(), "inner").live_bytes);
+  EXPECT_EQ(200 * sizeof(double),
+            find(memoryStatsByTag(), "inner").peak_bytes);
+
+  // Memory is released to the tag it was allocated under
+  s1 = DoubleStorage(10);
+  EXPECT_EQ(0, find(memoryStatsByTag(), "outer").live_bytes);
+}
+
+TEST(MemoryTest, snapshotTest) {
+  ::std::size_t threshold = memoryTrackThreshold();
+  setMemoryTrackThreshold(1024);
+  DoubleStorage small(10);
+  DoubleStorage large(4096);
+  ::std::vector< MemoryBlock > blocks;
+  {
+    MemoryScope scope("snapshot");
+    DoubleStorage larger(8192);
+    blocks = memorySnapshot(2);
+    ASSERT_EQ(2, blocks.size());
+    EXPECT_EQ(larger.data(), blocks[0].data);
+    EXPECT_EQ(8192 * sizeof(double), blocks[0].bytes);
+    EXPECT_EQ("double", blocks[0].type);
+    EXPECT_EQ("snapshot", blocks[0].tag);
+    EXPECT_EQ(large.data(), blocks[1].data);
+    EXPECT_EQ("", blocks[1].tag);
+
+    const ::std::size_t shape[] = {64, 128};
+    memoryAnnotate(larger.data(), 8192 * sizeof(double), shape, 2);
+    blocks = memorySnapshot(1);
+    ASSERT_EQ(2, blocks[0].shape.size());
+    EXPECT_EQ(64, blocks[0].shape[0]);
+    EXPECT_EQ(128, blocks[0].shape[1]);
+  }
+  blocks = memorySnapshot();
+  ASSERT_EQ(1, blocks.size());
+  EXPECT_EQ(large.data(), blocks[0].data);
+  setMemoryTrackThreshold(threshold);
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
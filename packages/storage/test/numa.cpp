@@ -0,0 +1,74 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/numa.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+template < typename S >
+void numaTest(const typename S::allocator_type &alloc) {
+  typedef typename S::value_type D;
+
+  // Both small and mapped allocations hold their values
+  S small(100, static_cast< D >(1), alloc);
+  EXPECT_EQ(static_cast< D >(1), small[99]);
+  S large(1000000, static_cast< D >(2), alloc);
+  EXPECT_EQ(static_cast< D >(2), large[0]);
+  EXPECT_EQ(static_cast< D >(2), large[999999]);
+
+  large.fill(static_cast< D >(3));
+  EXPECT_EQ(static_cast< D >(3), large[500000]);
+  large.resize(10, static_cast< D >(4));
+  EXPECT_EQ(static_cast< D >(4), large[9]);
+}
+
+TEST(NumaTest, allocatorTest) {
+  EXPECT_LE(1, numaNodes());
+  numaTest< NumaDoubleStorage >(NumaAllocator< double >());
+  numaTest< NumaFloatStorage >(NumaAllocator< float >(NumaPolicy::kLocal));
+  numaTest< NumaDoubleStorage >(
+      NumaAllocator< double >(NumaPolicy::kBind, numaNodes() - 1));
+  numaTest< NumaDoubleStorage >(
+      NumaAllocator< double >(NumaPolicy::kBind, numaNodes()));
+
+  // Allocators compare equal only with the same placement
+  NumaAllocator< double > bind(NumaPolicy::kBind, 0);
+  EXPECT_TRUE(bind == NumaAllocator< float >(NumaPolicy::kBind, 0));
+  EXPECT_TRUE(bind != NumaAllocator< double >(NumaPolicy::kBind, 1));
+  EXPECT_TRUE(bind != NumaAllocator< double >(NumaPolicy::kInterleave));
+}
+
+TEST(NumaTest, placeTest) {
+  // Placement is best effort but never fails on a node that exists
+  ::std::vector< char > v(1 << 20);
+  numaPlace(v.data(), v.size(), NumaPolicy::kInterleave);
+  EXPECT_FALSE(numaPlace(v.data(), v.size(), NumaPolicy::kBind, numaNodes()));
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,120 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/shared_memory.hpp"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+
+#include "thunder/storage/shared_memory-inl.hpp"
+#include "thunder/storage/storage-inl.hpp"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+typedef ::std::array< char, 3 > Bytes3;
+
+::std::string segmentName(const ::std::string &suffix) {
+  return "/thunder_test_" + ::std::to_string(getpid()) + "_" + suffix;
+}
+
+// Runs in a forked process, so it reports through its exit status
+int readInChild(const ::std::string &weights, const ::std::string &reply) {
+  try {
+    DoubleStorage s = openSharedStorage< DoubleStorage >(weights);
+    DoubleStorage r = openSharedStorage< DoubleStorage >(
+        reply, MapMode::kReadWrite);
+    if (s.size() != 1000 || r.size() != 1) {
+      return 1;
+    }
+    double sum = 0;
+    for (DoubleStorage::size_type i = 0; i < s.size(); ++i) {
+      sum += s[i];
+    }
+    r[0] = sum;
+    return 0;
+  } catch (...) {
+    return 2;
+  }
+}
+
+TEST(SharedMemoryTest, processTest) {
+  ::std::string weights = segmentName("weights");
+  ::std::string reply = segmentName("reply");
+  removeSharedMemory(weights);
+  removeSharedMemory(reply);
+
+  DoubleStorage source(1000);
+  for (int i = 0; i < 1000; ++i) {
+    source[i] = i;
+  }
+  DoubleStorage published = publishStorage(weights, source);
+  DoubleStorage result = createSharedStorage< DoubleStorage >(reply, 1);
+  result[0] = 0;
+  EXPECT_THROW(createSharedStorage< DoubleStorage >(weights, 1), io_error);
+
+  pid_t pid = fork();
+  ASSERT_LE(0, pid);
+  if (pid == 0) {
+    _exit(readInChild(weights, reply));
+  }
+  int status = 0;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+  EXPECT_EQ(499500.0, result[0]);
+
+  // Mappings of the same segment share data without copying
+  DoubleStorage view = openSharedStorage< DoubleStorage >(
+      weights, MapMode::kReadWrite);
+  view[10] = -1;
+  EXPECT_EQ(-1.0, published[10]);
+
+  // Copy-on-write changes stay private
+  DoubleStorage private_view = openSharedStorage< DoubleStorage >(
+      weights, MapMode::kCopyOnWrite);
+  private_view[20] = -2;
+  EXPECT_EQ(20.0, published[20]);
+
+  // Element sizes must divide the segment size
+  EXPECT_THROW(openSharedStorage< Storage< Bytes3 > >(weights),
+               invalid_argument);
+
+  // The name goes away with the last mapping in any process
+  published = DoubleStorage();
+  view = DoubleStorage();
+  EXPECT_EQ(-1.0, private_view[10]);
+  private_view = DoubleStorage();
+  EXPECT_THROW(openSharedStorage< DoubleStorage >(weights), io_error);
+  result = DoubleStorage();
+  EXPECT_THROW(openSharedStorage< DoubleStorage >(reply), io_error);
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
@@ -0,0 +1,105 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/small_storage.hpp"
+
+#include <cstddef>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+TEST(SmallStorageTest, constructorTest) {
+  SmallStorage< ::std::size_t > default_storage;
+  EXPECT_EQ(0, default_storage.size());
+  EXPECT_TRUE(default_storage.isInline());
+
+  SmallStorage< ::std::size_t > value_storage(5, 3);
+  EXPECT_EQ(5, value_storage.size());
+  EXPECT_TRUE(value_storage.isInline());
+  for (::std::size_t i = 0; i < value_storage.size(); ++i) {
+    EXPECT_EQ(3, value_storage[i]);
+  }
+
+  SmallStorage< ::std::ptrdiff_t > init_storage({1, -2, 3});
+  EXPECT_EQ(3, init_storage.size());
+  EXPECT_EQ(-2, init_storage[1]);
+
+  // Sizes beyond the inline capacity go to the heap
+  SmallStorage< ::std::size_t > large_storage(20, 7);
+  EXPECT_FALSE(large_storage.isInline());
+  SmallStorage< ::std::size_t > large_copy(large_storage);
+  EXPECT_FALSE(large_copy.isInline());
+  EXPECT_NE(large_storage.data(), large_copy.data());
+  for (::std::size_t i = 0; i < large_copy.size(); ++i) {
+    EXPECT_EQ(7, large_copy[i]);
+  }
+  const ::std::size_t *large_data = large_storage.data();
+  SmallStorage< ::std::size_t > large_moved(::std::move(large_storage));
+  EXPECT_EQ(large_data, large_moved.data());
+  EXPECT_EQ(20, large_moved.size());
+
+  SmallStorage< ::std::size_t > small_copy(value_storage);
+  EXPECT_TRUE(small_copy.isInline());
+  EXPECT_NE(value_storage.data(), small_copy.data());
+  SmallStorage< ::std::size_t > small_moved(::std::move(small_copy));
+  EXPECT_TRUE(small_moved.isInline());
+  EXPECT_EQ(5, small_moved.size());
+  EXPECT_EQ(3, small_moved[4]);
+}
+
+TEST(SmallStorageTest, assignmentTest) {
+  SmallStorage< ::std::size_t > small_storage(3, 1);
+  SmallStorage< ::std::size_t > large_storage(12, 2);
+  small_storage = large_storage;
+  EXPECT_EQ(12, small_storage.size());
+  EXPECT_FALSE(small_storage.isInline());
+  EXPECT_EQ(2, small_storage[11]);
+  large_storage = SmallStorage< ::std::size_t >(4, 5);
+  EXPECT_EQ(4, large_storage.size());
+  EXPECT_EQ(5, large_storage[3]);
+  large_storage.resize(2, 9);
+  EXPECT_EQ(2, large_storage.size());
+  EXPECT_EQ(9, large_storage[1]);
+}
+
+TEST(SmallStorageTest, conversionTest) {
+  Storage< ::std::size_t > storage({4, 5, 6});
+  SmallStorage< ::std::size_t > small_storage = storage;
+  EXPECT_EQ(3, small_storage.size());
+  EXPECT_EQ(6, small_storage[2]);
+  small_storage[0] = 8;
+  Storage< ::std::size_t > converted = small_storage;
+  EXPECT_EQ(3, converted.size());
+  EXPECT_EQ(8, converted[0]);
+  EXPECT_EQ(4, storage[0]);
+  ::std::size_t sum = 0;
+  for (const ::std::size_t &value : small_storage) {
+    sum += value;
+  }
+  EXPECT_EQ(19, sum);
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
@@ -195,6 +195,14 @@ void copyTest() {
   for (int i = 0; i < 5; ++i) {
     EXPECT_EQ(static_cast< T >(i + 3), storage[i]);
   }
+
+  // Empty storages have no data to copy or fill
+  thunder::Storage< T > empty;
+  thunder::Storage< T > empty_copy(empty);
+  storage.copy(empty);
+  storage.fill(static_cast< T >(1));
+  EXPECT_EQ(0, empty_copy.size());
+  EXPECT_EQ(0, storage.size());
 }
 TEST_ALL_TYPES(copyTest);
 
@@ -211,6 +219,74 @@ void resizeTest() {
 }
 TEST_ALL_TYPES(resizeTest);
 
+template < typename T >
+void growTest() {
+  thunder::Storage< T > storage(3, (T)1);
+  EXPECT_EQ(3, storage.capacity());
+
+  // Reserve keeps the size and the content
+  storage.reserve(10);
+  EXPECT_EQ(3, storage.size());
+  EXPECT_EQ(10, storage.capacity());
+  typename thunder::Storage< T >::pointer data = storage.data();
+
+  // Growing within capacity does not reallocate
+  storage.grow(10);
+  EXPECT_EQ(data, storage.data());
+  for (int i = 3; i < 10; ++i) {
+    storage[i] = (T)i;
+  }
+
+  // Growing beyond capacity at least doubles it
+  storage.grow(11);
+  EXPECT_EQ(11, storage.size());
+  EXPECT_EQ(20, storage.capacity());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ((T)1, storage[i]);
+  }
+  for (int i = 3; i < 10; ++i) {
+    EXPECT_EQ((T)i, storage[i]);
+  }
+
+  storage.shrinkToFit();
+  EXPECT_EQ(11, storage.capacity());
+  EXPECT_EQ((T)9, storage[9]);
+}
+TEST_ALL_TYPES(growTest);
+
+template < typename T >
+void largeTest() {
+  // Large storages are copied and filled in parallel blocks
+  const int size = 300000;
+  thunder::Storage< T > s1(size, (T)0);
+  for (int i = 0; i < size; i += 1000) {
+    EXPECT_EQ((T)0, s1[i]);
+  }
+  s1.fill((T)7);
+  EXPECT_EQ((T)7, s1[0]);
+  EXPECT_EQ((T)7, s1[size - 1]);
+  for (int i = 0; i < size; ++i) {
+    s1[i] = (T)(i % 100);
+  }
+
+  thunder::Storage< T > s2(s1);
+  thunder::Storage< T > s3;
+  s3.copy(s1);
+  thunder::Storage< double > s4;
+  s4.copy(s1);
+  for (int i = 0; i < size; i += 7) {
+    EXPECT_EQ(s1[i], s2[i]);
+    EXPECT_EQ(s1[i], s3[i]);
+    EXPECT_EQ((double)(i % 100), s4[i]);
+  }
+}
+TEST(StorageTest, largeTest) {
+  largeTest< double >();
+  largeTest< float >();
+  largeTest< int >();
+  largeTest< unsigned char >();
+}
+
 template < typename T >
 void allocatorTest() {
   // Create an allocator
@@ -0,0 +1,122 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/storage.hpp"
+#include "thunder/storage/workspace.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace thunder {
+namespace storage {
+namespace {
+
+TEST(WorkspaceTest, allocateTest) {
+  Workspace w(1024);
+  EXPECT_EQ(1024, w.capacity());
+  EXPECT_EQ(0, w.used());
+
+  // Allocations are bumped one after another with the requested alignment
+  char *p1 = static_cast< char* >(w.allocate(10));
+  char *p2 = static_cast< char* >(w.allocate(10));
+  EXPECT_EQ(p1 + 64, p2);
+  EXPECT_EQ(0, reinterpret_cast< ::std::uintptr_t >(p2) % 64);
+  char *p3 = static_cast< char* >(w.allocate(10, 1));
+  EXPECT_EQ(p2 + 10, p3);
+  EXPECT_EQ(30, w.used());
+
+  // Overflowing the chunk adds another one, merged on reset
+  w.allocate(2000);
+  EXPECT_LT(1024, w.capacity());
+  ::std::size_t capacity = w.capacity();
+  w.reset();
+  EXPECT_EQ(0, w.used());
+  EXPECT_EQ(capacity, w.capacity());
+  w.allocate(2000);
+  EXPECT_EQ(capacity, w.capacity());
+}
+
+TEST(WorkspaceTest, scopeTest) {
+  Workspace w;
+  EXPECT_EQ(nullptr, Workspace::current());
+  {
+    WorkspaceScope scope(&w);
+    EXPECT_EQ(&w, Workspace::current());
+
+    // Storages created in the scope come from the workspace
+    WorkspaceDoubleStorage s1(128, 1.0);
+    WorkspaceDoubleStorage s2(128, 2.0);
+    EXPECT_EQ(&w, s1.allocator().workspace());
+    EXPECT_EQ(s1.data() + 128, s2.data());
+    EXPECT_EQ(256 * sizeof(double), w.used());
+
+    // Nested scopes of another workspace take over until they end
+    Workspace v;
+    {
+      WorkspaceScope inner(&v);
+      WorkspaceFloatStorage s3(10);
+      EXPECT_EQ(&v, s3.allocator().workspace());
+    }
+    EXPECT_EQ(0, v.used());
+    EXPECT_EQ(&w, Workspace::current());
+    EXPECT_EQ(256 * sizeof(double), w.used());
+  }
+  EXPECT_EQ(nullptr, Workspace::current());
+  EXPECT_EQ(0, w.used());
+
+  // Without a scope storages fall back to the heap
+  WorkspaceDoubleStorage s4(100, 4.0);
+  EXPECT_EQ(nullptr, s4.allocator().workspace());
+  EXPECT_EQ(4.0, s4[99]);
+}
+
+TEST(WorkspaceTest, escapeTest) {
+  Workspace w(4096);
+  WorkspaceDoubleStorage s1;
+  DoubleStorage s2;
+  {
+    WorkspaceScope scope(&w);
+    s1 = WorkspaceDoubleStorage(128, 1.0);
+    s2 = DoubleStorage::scratch(128);
+    s2.fill(2.0);
+    EXPECT_EQ(256 * sizeof(double), w.used());
+  }
+
+  // Escaped storages keep their chunk while the workspace takes a new one
+  {
+    WorkspaceScope scope(&w);
+    WorkspaceDoubleStorage s3(256, 3.0);
+    EXPECT_NE(s1.data(), s3.data());
+    EXPECT_NE(s2.data(), s3.data());
+  }
+  EXPECT_EQ(1.0, s1[127]);
+  EXPECT_EQ(2.0, s2[127]);
+  EXPECT_EQ(4096, w.capacity());
+
+  // Scratch storages come from the heap without a scope
+  DoubleStorage s4 = DoubleStorage::scratch(16);
+  EXPECT_EQ(16, s4.size());
+  EXPECT_EQ(0, w.used());
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace thunder
@@ -20,9 +20,15 @@
 #ifndef THUNDER_TENSOR_HPP_
 #define THUNDER_TENSOR_HPP_
 
+#include "thunder/tensor/builder.hpp"
+#include "thunder/tensor/fixed_tensor.hpp"
+#include "thunder/tensor/npy.hpp"
 #include "thunder/tensor/tensor.hpp"
+#include "thunder/tensor/tensor_file.hpp"
 
 #include <complex>
+#include <cstddef>
+#include <string>
 
 #include "thunder/storage.hpp"
 #include "thunder/serializer.hpp"
@@ -37,12 +43,29 @@ typedef Tensor< DoubleStorage > DoubleTensor;
 typedef Tensor< FloatStorage > FloatTensor;
 
 template < typename D = double,
-           typename A = ::std::allocator< ::std::complex< D > > >
+           typename A = storage::DefaultAllocator< ::std::complex< D > > >
 using ComplexTensor = Tensor< ComplexStorage< D, A > >;
-typedef ComplexTensor< double, ::std::allocator< ::std::complex< double > > >
-DoubleComplexTensor;
-typedef ComplexTensor< float, ::std::allocator< ::std::complex< float > > >
-FloatComplexTensor;
+typedef ComplexTensor< double > DoubleComplexTensor;
+typedef ComplexTensor< float > FloatComplexTensor;
+
+template < typename T = DoubleTensor >
+using TensorBuilder = tensor::TensorBuilder< T >;
+
+using tensor::TensorFile;
+using tensor::TensorFileSave;
+using tensor::TensorFileWriter;
+
+using tensor::saveNpy;
+using tensor::NpyFile;
+using tensor::NpzFile;
+using tensor::NpzWriter;
+
+// Fixed shape and fixed rank tensors are header-only. Include
+// thunder/tensor/fixed_tensor-inl.hpp to use them.
+template < typename S, ::std::size_t... Dims >
+using FixedTensor = tensor::FixedTensor< S, Dims... >;
+template < typename S, ::std::size_t N >
+using TensorN = tensor::TensorN< S, N >;
 
 }  // namespace thunder
 
@@ -60,6 +83,49 @@ extern template class Tensor< DoubleComplexStorage >;
 extern template class Tensor< FloatComplexStorage >;
 extern template class Tensor< SizeStorage >;
 
+// Tensor builder instantiation
+extern template class TensorBuilder< Tensor< DoubleStorage > >;
+extern template class TensorBuilder< Tensor< FloatStorage > >;
+extern template class TensorBuilder< Tensor< DoubleComplexStorage > >;
+extern template class TensorBuilder< Tensor< FloatComplexStorage > >;
+extern template class TensorBuilder< Tensor< SizeStorage > >;
+
+// Tensor file instantiation
+#define THUNDER_TENSOR_INSTANTIATE_FILE(S)                              \
+  extern template void TensorFileWriter::add(                           \
+      const ::std::string &name, const Tensor< S > &x);                 \
+  extern template Tensor< S > TensorFile::get(                          \
+      const ::std::string &name) const;                                 \
+  extern template Tensor< S > TensorFile::read(                         \
+      const ::std::string &name, ::std::size_t dim, ::std::size_t pos,  \
+      ::std::size_t size) const;
+
+THUNDER_TENSOR_INSTANTIATE_FILE(DoubleStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(FloatStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(DoubleComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(FloatComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(SizeStorage);
+
+#undef THUNDER_TENSOR_INSTANTIATE_FILE
+
+// NumPy file instantiation
+#define THUNDER_TENSOR_INSTANTIATE_NPY(S)                               \
+  extern template void saveNpy(                                         \
+      const ::std::string &path, const Tensor< S > &x);                 \
+  extern template Tensor< S > NpyFile::get() const;                     \
+  extern template void NpzWriter::add(                                  \
+      const ::std::string &name, const Tensor< S > &x);                 \
+  extern template Tensor< S > NpzFile::get(                             \
+      const ::std::string &name) const;
+
+THUNDER_TENSOR_INSTANTIATE_NPY(DoubleStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(FloatStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(DoubleComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(FloatComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(SizeStorage);
+
+#undef THUNDER_TENSOR_INSTANTIATE_NPY
+
 #define THUNDER_TENSOR_INSTANTIATE_UNARY(S)                             \
   extern template Tensor< S > operator+(                                \
       typename Tensor< S >::const_reference value, const Tensor< S > &x); \
@@ -214,6 +280,21 @@ THUNDER_TENSOR_EXPAND_BINARY_INCOMPATIBLE(
   extern template const Tensor< S1 >& Tensor< S1 >::copy(               \
       const Tensor< S2 > &x) const;                                     \
   extern template Tensor< S1 >& Tensor< S1 >::copy(const Tensor< S2 > &x); \
+  extern template const Tensor< S1 >& Tensor< S1 >::maskedFill(         \
+      const Tensor< S2 > &y,                                            \
+      typename Tensor< S1 >::const_reference value) const;              \
+  extern template const Tensor< S1 >& Tensor< S1 >::maskedAssign(       \
+      const Tensor< S2 > &y, const Tensor< S1 > &z) const;              \
+  extern template Tensor< S1 >& Tensor< S1 >::maskedFill(               \
+      const Tensor< S2 > &y,                                            \
+      typename Tensor< S1 >::const_reference value);                    \
+  extern template Tensor< S1 >& Tensor< S1 >::maskedAssign(             \
+      const Tensor< S2 > &y, const Tensor< S1 > &z);                    \
+  extern template Tensor< S1 > Tensor< S1 >::maskedFill(                \
+      const Tensor< S1 > &x, const Tensor< S2 > &y,                     \
+      typename Tensor< S1 >::const_reference value);                    \
+  extern template Tensor< S1 > Tensor< S1 >::maskedAssign(              \
+      const Tensor< S1 > &x, const Tensor< S2 > &y, const Tensor< S1 > &z);\
   extern template Tensor< S1 > Tensor< S1 >::polars(                    \
       typename Tensor< S2 >::const_reference r,                         \
       const Tensor< S2 > &theta,                                        \
@@ -269,6 +350,9 @@ namespace serializer {
   extern template void save(                            \
       StringBinarySerializer *s,                        \
       const ::thunder::tensor::Tensor< D > &t);         \
+  extern template void saveCompact(                     \
+      StringBinarySerializer *s,                        \
+      const ::thunder::tensor::Tensor< D > &t);         \
   extern template void StringBinarySerializer::save(    \
       const ::thunder::tensor::Tensor< D > &t);         \
   extern template void load(                            \
@@ -279,6 +363,9 @@ namespace serializer {
   extern template void save(                            \
       FileBinarySerializer *s,                          \
       const ::thunder::tensor::Tensor< D > &t);         \
+  extern template void saveCompact(                     \
+      FileBinarySerializer *s,                          \
+      const ::thunder::tensor::Tensor< D > &t);         \
   extern template void FileBinarySerializer::save(      \
       const ::thunder::tensor::Tensor< D > &t);         \
   extern template void load(                            \
@@ -289,6 +376,9 @@ namespace serializer {
   extern template void save(                            \
       StringTextSerializer *s,                          \
       const ::thunder::tensor::Tensor< D > &t);         \
+  extern template void saveCompact(                     \
+      StringTextSerializer *s,                          \
+      const ::thunder::tensor::Tensor< D > &t);         \
   extern template void StringTextSerializer::save(      \
       const ::thunder::tensor::Tensor< D > &t);         \
   extern template void load(                            \
@@ -299,6 +389,9 @@ namespace serializer {
   extern template void save(                            \
       FileTextSerializer *s,                            \
       const ::thunder::tensor::Tensor< D > &t);         \
+  extern template void saveCompact(                     \
+      FileTextSerializer *s,                            \
+      const ::thunder::tensor::Tensor< D > &t);         \
   extern template void FileTextSerializer::save(        \
       const ::thunder::tensor::Tensor< D > &t);         \
   extern template void load(                            \
@@ -0,0 +1,145 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_BUILDER_INL_HPP_
+#define THUNDER_TENSOR_BUILDER_INL_HPP_
+
+#include "thunder/tensor/builder.hpp"
+
+#include <memory>
+
+#include "thunder/exception.hpp"
+
+namespace thunder {
+namespace tensor {
+
+template < typename T >
+TensorBuilder< T >::TensorBuilder(
+    size_storage sz, size_type count, allocator_type alloc)
+    : row_size_(sz), row_length_(1), rows_(0),
+      storage_(::std::make_shared< storage_type >(alloc)) {
+  for (const size_type &size_x : row_size_) {
+    if (size_x == 0) {
+      throw invalid_argument("Size evaluates to zero.");
+    }
+    row_length_ *= size_x;
+  }
+  reserve(count);
+}
+
+template < typename T >
+TensorBuilder< T >& TensorBuilder< T >::append(const_reference value) {
+  if (row_size_.size() != 0) {
+    throw invalid_argument("Builder rows are not scalars.");
+  }
+  storage_->grow(rows_ + 1);
+  storage_->unshare();
+  (*storage_)[rows_] = value;
+  ++rows_;
+  return *this;
+}
+
+template < typename T >
+TensorBuilder< T >& TensorBuilder< T >::append(const T &x) {
+  if (x.dimension() != row_size_.size()) {
+    throw invalid_argument("Dimension mismatches.");
+  }
+  for (dim_type i = 0; i < row_size_.size(); ++i) {
+    if (x.size(i) != row_size_[i]) {
+      throw invalid_argument("Size mismatches.");
+    }
+  }
+  extend(x.size(), 1).copy(x);
+  return *this;
+}
+
+template < typename T >
+TensorBuilder< T >& TensorBuilder< T >::appendRows(const T &x) {
+  if (x.dimension() != row_size_.size() + 1) {
+    throw invalid_argument("Dimension mismatches.");
+  }
+  for (dim_type i = 0; i < row_size_.size(); ++i) {
+    if (x.size(i + 1) != row_size_[i]) {
+      throw invalid_argument("Size mismatches.");
+    }
+  }
+  extend(x.size(), x.size(0)).copy(x);
+  return *this;
+}
+
+template < typename T >
+void TensorBuilder< T >::reserve(size_type count) {
+  storage_->reserve(count * row_length_);
+}
+
+template < typename T >
+void TensorBuilder< T >::shrinkToFit() {
+  storage_->shrinkToFit();
+}
+
+template < typename T >
+void TensorBuilder< T >::clear() {
+  rows_ = 0;
+  storage_->grow(0);
+}
+
+template < typename T >
+typename TensorBuilder< T >::size_type TensorBuilder< T >::rows() const {
+  return rows_;
+}
+
+template < typename T >
+typename TensorBuilder< T >::size_type TensorBuilder< T >::capacity() const {
+  return storage_->capacity() / row_length_;
+}
+
+template < typename T >
+typename TensorBuilder< T >::size_storage
+TensorBuilder< T >::rowSize() const {
+  return row_size_;
+}
+
+template < typename T >
+typename TensorBuilder< T >::storage_pointer
+TensorBuilder< T >::storage() const {
+  return storage_;
+}
+
+template < typename T >
+T TensorBuilder< T >::tensor() const {
+  size_storage sz(row_size_.size() + 1);
+  sz[0] = rows_;
+  for (dim_type i = 0; i < row_size_.size(); ++i) {
+    sz[i + 1] = row_size_[i];
+  }
+  return T(sz, storage_);
+}
+
+template < typename T >
+T TensorBuilder< T >::extend(const size_storage &sz, size_type count) {
+  size_type offset = rows_ * row_length_;
+  storage_->grow(offset + count * row_length_);
+  rows_ += count;
+  return T(sz, storage_, offset);
+}
+
+}  // namespace tensor
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_BUILDER_INL_HPP_
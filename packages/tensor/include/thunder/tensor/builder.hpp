@@ -0,0 +1,86 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_BUILDER_HPP_
+#define THUNDER_TENSOR_BUILDER_HPP_
+
+#include "thunder/tensor/tensor.hpp"
+
+namespace thunder {
+namespace tensor {
+
+// Builds a tensor by appending rows along dimension 0. The rows live in a
+// single storage whose capacity grows geometrically, so appending costs
+// amortized constant time per row. Views returned by tensor() share that
+// storage and stay valid when it grows.
+template < typename T >
+class TensorBuilder {
+ public:
+  // Typedefs from tensor
+  typedef T tensor_type;
+  typedef typename T::storage_type storage_type;
+  typedef typename T::allocator_type allocator_type;
+  typedef typename T::value_type value_type;
+  typedef typename T::const_reference const_reference;
+  typedef typename T::size_type size_type;
+  typedef typename T::size_storage size_storage;
+  typedef typename T::storage_pointer storage_pointer;
+  typedef typename T::dim_type dim_type;
+
+  // Constructor for rows of size sz. Empty size builds a 1-D tensor.
+  explicit TensorBuilder(size_storage sz = size_storage(), size_type count = 0,
+                         allocator_type alloc = allocator_type());
+
+  // Append one row of a 1-D builder
+  TensorBuilder& append(const_reference value);
+  // Append one row of the row size
+  TensorBuilder& append(const T &x);
+  // Append all x.size(0) rows of x, whose remaining sizes are the row size
+  TensorBuilder& appendRows(const T &x);
+
+  // Make room for count rows in total
+  void reserve(size_type count);
+  // Release the capacity beyond the appended rows
+  void shrinkToFit();
+  // Drop all rows. Views handed out before will see rows appended later.
+  void clear();
+
+  // Property queries
+  size_type rows() const;
+  size_type capacity() const;
+  size_storage rowSize() const;
+  storage_pointer storage() const;
+
+  // View of the appended rows sharing the storage. Throws if there is none.
+  T tensor() const;
+
+ private:
+  // Grow the storage by count rows and return a view of the new rows
+  T extend(const size_storage &sz, size_type count);
+
+  size_storage row_size_;
+  size_type row_length_;
+  size_type rows_;
+  storage_pointer storage_;
+};
+
+}  // namespace tensor
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_BUILDER_HPP_
@@ -38,76 +38,27 @@ namespace math {
 // Transformations
 template < typename D, typename A, typename T1 >
 T1 extract(const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y) {
-  typedef Tensor< Storage < ::std::complex< D >, A > > T2;
-  if (x.dimension() < y.dimension()) {
-    throw out_of_range("Dimension exceeds limit.");
-  }
-  typename T1::dim_type y_dimension =
-      static_cast< typename T1::dim_type >(y.dimension());
-  for (typename T1::dim_type i = 0; i < y_dimension; ++i) {
-    if (x.size(i) != static_cast< typename T1::size_type >(y.size(i))) {
-      throw out_of_range("Size does not match.");
-    }
-  }
-  typename T1::size_storage sz(x.dimension() - y_dimension + 1);
-  for (typename T1::dim_type i = y_dimension; i < x.dimension(); ++i) {
-    sz[i - y_dimension + 1] = x.size(i);
-  }
-  // Get the size of returning tensor
-  sz[0] = 0;
-  if (y.isContiguous()) {
-    typename T2::size_type y_length = y.length();
-    typename T2::pointer y_data = y.data();
-    for (typename T2::size_type i = 0; i < y_length; ++i) {
-      if (static_cast< bool >(::std::real(y_data[i])) == true) {
-        ++sz[0];
-      }
-    }
-  } else {
-    for (typename T2::reference_iterator begin = y.reference_begin(),
-             end = y.reference_end(); begin != end; ++begin) {
-      if (static_cast< bool >(::std::real(*begin)) == true) {
-        ++sz[0];
-      }
-    }
-  }
+  return extractIf(x, y, [](const ::std::complex< D > &v) {
+      return static_cast< bool >(::std::real(v));
+    });
+}
 
-  // Create the new tensor and do the copy
-  T1 t(sz);
-  if (x.isContiguous() && y.isContiguous()) {
-    typename T2::size_type y_length = y.length();
-    typename T2::pointer y_data = y.data();
-    typename T1::difference_type x_step = x.stride(y_dimension - 1);
-    typename T1::size_type x_step_size = ::std::abs(x_step);
-    typename T1::difference_type x_step_increment = x_step > 0 ? 1 : -1;
-    typename T1::pointer t_data = t.data();
-    typename T1::pointer x_data = x.data();
-    typename T1::size_type current = 0;
-    for (typename T2::size_type i = 0; i < y_length; ++i) {
-      if (static_cast< bool >(::std::real(y_data[i])) == true) {
-        for (typename T1::size_type j = 0; j < x_step_size; ++j) {
-          t_data[current++] = x_data[i * x_step + j * x_step_increment];
-        }
-      }
-    }
-  } else {
-    typename T1::size_storage y_size(y.dimension());
-    for (typename T1::dim_type i = 0; i < y_size.size(); ++i) {
-      y_size[i] = y.size(i);
-    }
-    typename T1::size_type pos = 0;
-    IndexIterator< typename T1::size_storage > t_begin =
-        IndexIterator< typename T1::size_storage>::begin(y_size);
-    for (IndexIterator< typename T2::size_storage > begin =
-             IndexIterator< typename T2::size_storage >::begin(y.size()),
-             end = IndexIterator< typename T2::size_storage >::end(y.size());
-         begin != end; ++begin, ++t_begin) {
-      if (static_cast< bool >(::std::real(y[*begin]())) == true) {
-        t[pos++].copy(x[*t_begin]);
-      }
-    }
-  }
-  return t;
+template < typename D, typename A, typename T1 >
+const T1& maskedFill(
+    const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y,
+    typename T1::const_reference value) {
+  return maskedFillIf(x, y, value, [](const ::std::complex< D > &v) {
+      return static_cast< bool >(::std::real(v));
+    });
+}
+
+template < typename D, typename A, typename T1 >
+const T1& maskedAssign(
+    const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y,
+    const T1 &z) {
+  return maskedAssignIf(x, y, z, [](const ::std::complex< D > &v) {
+      return static_cast< bool >(::std::real(v));
+    });
 }
 
 template < typename D, typename A, typename T1 >
@@ -35,6 +35,14 @@ T1 extract(const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y);
 template < typename D, typename A, typename T1 >
 T1 shuffle(const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y);
 template < typename D, typename A, typename T1 >
+const T1& maskedFill(
+    const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y,
+    typename T1::const_reference value);
+template < typename D, typename A, typename T1 >
+const T1& maskedAssign(
+    const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y,
+    const T1 &z);
+template < typename D, typename A, typename T1 >
 T1 permute(const T1 &x, const Tensor< Storage< ::std::complex< D >, A > > &y,
            typename T1::dim_type d);
 template < typename D, typename A >
@@ -0,0 +1,491 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_FIXED_TENSOR_INL_HPP_
+#define THUNDER_TENSOR_FIXED_TENSOR_INL_HPP_
+
+#include "thunder/tensor/fixed_tensor.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "thunder/exception.hpp"
+#include "thunder/serializer.hpp"
+#include "thunder/tensor/tensor.hpp"
+
+namespace thunder {
+namespace tensor {
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >::FixedTensor(allocator_type alloc)
+    : storage_(::std::make_shared< S >(shape_type::length(), alloc)),
+      offset_(0) {}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >::FixedTensor(storage_pointer s, size_type os)
+    : offset_(os) {
+  ::std::swap(storage_, s);
+  if (storage_ == nullptr) {
+    throw invalid_argument("Storage is nullptr.");
+  }
+  if (offset_ + shape_type::length() > storage_->size()) {
+    throw out_of_range("Offset and size exceed storage size.");
+  }
+}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >::FixedTensor(const tensor_type &x)
+    : storage_(x.storage()), offset_(x.offset()) {
+  if (x.dimension() != shape_type::dimension()) {
+    throw out_of_range("Dimension mismatches.");
+  }
+  for (dim_type i = 0; i < shape_type::dimension(); ++i) {
+    if (x.size(i) != shape_type::size(i)) {
+      throw out_of_range("Size mismatches.");
+    }
+  }
+  if (!x.isContiguous()) {
+    throw contiguity_error("Fixed tensor requires contiguous data.");
+  }
+}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >::FixedTensor(const FixedTensor &y)
+    : storage_(y.storage_), offset_(y.offset_) {}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >::FixedTensor(FixedTensor &&y)
+    : storage_(::std::move(y.storage_)), offset_(y.offset_) {}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >::~FixedTensor() {}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... >& FixedTensor< S, Dims... >::operator=(
+    FixedTensor y) {
+  ::std::swap(storage_, y.storage_);
+  ::std::swap(offset_, y.offset_);
+  return *this;
+}
+
+template < typename S, ::std::size_t... Dims >
+constexpr typename FixedTensor< S, Dims... >::dim_type
+FixedTensor< S, Dims... >::dimension() {
+  return shape_type::dimension();
+}
+
+template < typename S, ::std::size_t... Dims >
+constexpr typename FixedTensor< S, Dims... >::size_type
+FixedTensor< S, Dims... >::length() {
+  return shape_type::length();
+}
+
+template < typename S, ::std::size_t... Dims >
+constexpr typename FixedTensor< S, Dims... >::size_type
+FixedTensor< S, Dims... >::size(dim_type dim) {
+  return shape_type::size(dim);
+}
+
+template < typename S, ::std::size_t... Dims >
+constexpr typename FixedTensor< S, Dims... >::difference_type
+FixedTensor< S, Dims... >::stride(dim_type dim) {
+  return static_cast< difference_type >(shape_type::stride(dim));
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::storage_pointer
+FixedTensor< S, Dims... >::storage() const {
+  return storage_;
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::size_type
+FixedTensor< S, Dims... >::offset() const {
+  return offset_;
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::pointer
+FixedTensor< S, Dims... >::data() const {
+  return storage_->data() + offset_;
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::allocator_type
+FixedTensor< S, Dims... >::allocator() const {
+  return storage_->allocator();
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::tensor_type
+FixedTensor< S, Dims... >::tensor() const {
+  return tensor_type(size_storage({Dims...}), storage_, offset_);
+}
+
+template < typename S, ::std::size_t... Dims >
+FixedTensor< S, Dims... > FixedTensor< S, Dims... >::clone() const {
+  return FixedTensor(allocator()).copy(*this);
+}
+
+template < typename S, ::std::size_t... Dims >
+template < typename... I >
+typename FixedTensor< S, Dims... >::reference
+FixedTensor< S, Dims... >::operator()(I... pos) const {
+  static_assert(sizeof...(I) == sizeof...(Dims),
+                "Number of positions must equal dimension.");
+  return data()[shape_type::offset(static_cast< ::std::size_t >(pos)...)];
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::reference
+FixedTensor< S, Dims... >::operator[](size_type pos) const {
+  return data()[pos];
+}
+
+#define THUNDER_TENSOR_FIXED_DEFINE_CONSTANT(NAME, EXPRESSION)          \
+  template < typename S, ::std::size_t... Dims >                        \
+  const FixedTensor< S, Dims... >& FixedTensor< S, Dims... >::NAME(     \
+      const_reference y) const {                                        \
+    pointer x_data = data();                                            \
+    Unroll< shape_type::length() >::apply([x_data, &y](::std::size_t i) { \
+        EXPRESSION;                                                     \
+      });                                                               \
+    return *this;                                                       \
+  }                                                                     \
+  template < typename S, ::std::size_t... Dims >                        \
+  FixedTensor< S, Dims... >& FixedTensor< S, Dims... >::NAME(           \
+      const_reference y) {                                              \
+    return const_cast< FixedTensor& >(                                  \
+        const_cast< const FixedTensor* >(this)->NAME(y));               \
+  }
+
+THUNDER_TENSOR_FIXED_DEFINE_CONSTANT(fill, x_data[i] = y);
+THUNDER_TENSOR_FIXED_DEFINE_CONSTANT(add, x_data[i] += y);
+THUNDER_TENSOR_FIXED_DEFINE_CONSTANT(sub, x_data[i] -= y);
+THUNDER_TENSOR_FIXED_DEFINE_CONSTANT(mul, x_data[i] *= y);
+THUNDER_TENSOR_FIXED_DEFINE_CONSTANT(div, x_data[i] /= y);
+
+#undef THUNDER_TENSOR_FIXED_DEFINE_CONSTANT
+
+#define THUNDER_TENSOR_FIXED_DEFINE_TENSOR(NAME, EXPRESSION)            \
+  template < typename S, ::std::size_t... Dims >                        \
+  const FixedTensor< S, Dims... >& FixedTensor< S, Dims... >::NAME(     \
+      const FixedTensor &y) const {                                     \
+    pointer x_data = data();                                            \
+    pointer y_data = y.data();                                          \
+    Unroll< shape_type::length() >::apply([x_data, y_data](::std::size_t i) { \
+        EXPRESSION;                                                     \
+      });                                                               \
+    return *this;                                                       \
+  }                                                                     \
+  template < typename S, ::std::size_t... Dims >                        \
+  FixedTensor< S, Dims... >& FixedTensor< S, Dims... >::NAME(           \
+      const FixedTensor &y) {                                           \
+    return const_cast< FixedTensor& >(                                  \
+        const_cast< const FixedTensor* >(this)->NAME(y));               \
+  }
+
+THUNDER_TENSOR_FIXED_DEFINE_TENSOR(copy, x_data[i] = y_data[i]);
+THUNDER_TENSOR_FIXED_DEFINE_TENSOR(add, x_data[i] += y_data[i]);
+THUNDER_TENSOR_FIXED_DEFINE_TENSOR(sub, x_data[i] -= y_data[i]);
+THUNDER_TENSOR_FIXED_DEFINE_TENSOR(mul, x_data[i] *= y_data[i]);
+THUNDER_TENSOR_FIXED_DEFINE_TENSOR(div, x_data[i] /= y_data[i]);
+
+#undef THUNDER_TENSOR_FIXED_DEFINE_TENSOR
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::value_type
+FixedTensor< S, Dims... >::sum() const {
+  value_type result = 0;
+  pointer x_data = data();
+  Unroll< shape_type::length() >::apply([x_data, &result](::std::size_t i) {
+      result += x_data[i];
+    });
+  return result;
+}
+
+template < typename S, ::std::size_t... Dims >
+typename FixedTensor< S, Dims... >::value_type
+FixedTensor< S, Dims... >::dot(const FixedTensor &y) const {
+  value_type result = 0;
+  pointer x_data = data();
+  pointer y_data = y.data();
+  Unroll< shape_type::length() >::apply(
+      [x_data, y_data, &result](::std::size_t i) {
+        result += x_data[i] * y_data[i];
+      });
+  return result;
+}
+
+template < typename S, ::std::size_t M, ::std::size_t N, ::std::size_t P >
+const FixedTensor< S, M, P >& mm(const FixedTensor< S, M, N > &x,
+                                 const FixedTensor< S, N, P > &y,
+                                 const FixedTensor< S, M, P > &r) {
+  typedef typename FixedTensor< S, M, P >::pointer pointer;
+  typedef typename FixedTensor< S, M, P >::value_type value_type;
+  pointer x_data = x.data();
+  pointer y_data = y.data();
+  pointer r_data = r.data();
+  Unroll< M * P >::apply([x_data, y_data, r_data](::std::size_t k) {
+      ::std::size_t i = k / P, j = k % P;
+      value_type result = 0;
+      Unroll< N >::apply([x_data, y_data, i, j, &result](::std::size_t l) {
+          result += x_data[i * N + l] * y_data[l * P + j];
+        });
+      r_data[k] = result;
+    });
+  return r;
+}
+
+template < typename S, ::std::size_t M, ::std::size_t N, ::std::size_t P >
+FixedTensor< S, M, P > mm(const FixedTensor< S, M, N > &x,
+                          const FixedTensor< S, N, P > &y) {
+  FixedTensor< S, M, P > r(x.allocator());
+  mm(x, y, r);
+  return r;
+}
+
+template < typename S, ::std::size_t M, ::std::size_t N >
+const FixedTensor< S, M >& mv(const FixedTensor< S, M, N > &x,
+                              const FixedTensor< S, N > &y,
+                              const FixedTensor< S, M > &r) {
+  typedef typename FixedTensor< S, M >::pointer pointer;
+  typedef typename FixedTensor< S, M >::value_type value_type;
+  pointer x_data = x.data();
+  pointer y_data = y.data();
+  pointer r_data = r.data();
+  Unroll< M >::apply([x_data, y_data, r_data](::std::size_t i) {
+      value_type result = 0;
+      Unroll< N >::apply([x_data, y_data, i, &result](::std::size_t j) {
+          result += x_data[i * N + j] * y_data[j];
+        });
+      r_data[i] = result;
+    });
+  return r;
+}
+
+template < typename S, ::std::size_t M, ::std::size_t N >
+FixedTensor< S, M > mv(const FixedTensor< S, M, N > &x,
+                       const FixedTensor< S, N > &y) {
+  FixedTensor< S, M > r(x.allocator());
+  mv(x, y, r);
+  return r;
+}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >::TensorN(const size_array &sz, allocator_type alloc)
+    : size_(sz), offset_(0) {
+  size_type length = 1;
+  for (dim_type i = N; i > 0; --i) {
+    if (size_[i - 1] == 0) {
+      throw invalid_argument("Size evaluates to zero.");
+    }
+    stride_[i - 1] = static_cast< difference_type >(length);
+    length *= size_[i - 1];
+  }
+  storage_ = ::std::make_shared< S >(length, alloc);
+}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >::TensorN(const tensor_type &x)
+    : storage_(x.storage()), offset_(x.offset()) {
+  if (x.dimension() != N) {
+    throw out_of_range("Dimension mismatches.");
+  }
+  for (dim_type i = 0; i < N; ++i) {
+    size_[i] = x.size(i);
+    stride_[i] = x.stride(i);
+  }
+}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >::TensorN(const TensorN &y)
+    : size_(y.size_), stride_(y.stride_), storage_(y.storage_),
+      offset_(y.offset_) {}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >::TensorN(TensorN &&y)
+    : size_(y.size_), stride_(y.stride_), storage_(::std::move(y.storage_)),
+      offset_(y.offset_) {}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >::~TensorN() {}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >& TensorN< S, N >::operator=(TensorN y) {
+  ::std::swap(size_, y.size_);
+  ::std::swap(stride_, y.stride_);
+  ::std::swap(storage_, y.storage_);
+  ::std::swap(offset_, y.offset_);
+  return *this;
+}
+
+template < typename S, ::std::size_t N >
+constexpr typename TensorN< S, N >::dim_type TensorN< S, N >::dimension() {
+  return N;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::size_type TensorN< S, N >::size(dim_type dim) const {
+  return size_[dim];
+}
+
+template < typename S, ::std::size_t N >
+const typename TensorN< S, N >::size_array& TensorN< S, N >::size() const {
+  return size_;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::size_type TensorN< S, N >::length() const {
+  size_type length = 1;
+  Unroll< N >::apply([this, &length](::std::size_t i) {
+      length *= size_[i];
+    });
+  return length;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::difference_type TensorN< S, N >::stride(
+    dim_type dim) const {
+  return stride_[dim];
+}
+
+template < typename S, ::std::size_t N >
+const typename TensorN< S, N >::stride_array&
+TensorN< S, N >::stride() const {
+  return stride_;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::storage_pointer TensorN< S, N >::storage() const {
+  return storage_;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::size_type TensorN< S, N >::offset() const {
+  return offset_;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::pointer TensorN< S, N >::data() const {
+  return storage_->data() + offset_;
+}
+
+template < typename S, ::std::size_t N >
+bool TensorN< S, N >::isContiguous() const {
+  difference_type expected = 1;
+  for (dim_type i = N; i > 0; --i) {
+    if (stride_[i - 1] != expected) {
+      return false;
+    }
+    expected *= static_cast< difference_type >(size_[i - 1]);
+  }
+  return true;
+}
+
+template < typename S, ::std::size_t N >
+typename TensorN< S, N >::tensor_type TensorN< S, N >::tensor() const {
+  size_storage sz(N);
+  stride_storage st(N);
+  for (dim_type i = 0; i < N; ++i) {
+    sz[i] = size_[i];
+    st[i] = stride_[i];
+  }
+  return tensor_type(sz, st, storage_, offset_);
+}
+
+template < typename S, ::std::size_t N >
+template < typename... I >
+typename TensorN< S, N >::reference TensorN< S, N >::operator()(
+    I... pos) const {
+  static_assert(sizeof...(I) == N,
+                "Number of positions must equal dimension.");
+  return (*storage_)[offset_ + position< 0 >(
+      static_cast< size_type >(pos)...)];
+}
+
+template < typename S, ::std::size_t N >
+const TensorN< S, N >& TensorN< S, N >::fill(const_reference y) const {
+  pointer x_data = data();
+  if (isContiguous()) {
+    size_type x_length = length();
+    for (size_type i = 0; i < x_length; ++i) {
+      x_data[i] = y;
+    }
+  } else {
+    tensor().fill(y);
+  }
+  return *this;
+}
+
+template < typename S, ::std::size_t N >
+TensorN< S, N >& TensorN< S, N >::fill(const_reference y) {
+  return const_cast< TensorN& >(const_cast< const TensorN* >(this)->fill(y));
+}
+
+template < typename S, ::std::size_t N >
+template < ::std::size_t K >
+typename TensorN< S, N >::difference_type TensorN< S, N >::position() const {
+  return 0;
+}
+
+template < typename S, ::std::size_t N >
+template < ::std::size_t K, typename... I >
+typename TensorN< S, N >::difference_type TensorN< S, N >::position(
+    size_type pos, I... pos_tail) const {
+  return static_cast< difference_type >(pos) * stride_[K] +
+      position< K + 1 >(pos_tail...);
+}
+
+}  // namespace tensor
+}  // namespace thunder
+
+namespace thunder {
+namespace serializer {
+
+template < typename C, typename S, ::std::size_t... Dims >
+void save(C *s, const ::thunder::tensor::FixedTensor< S, Dims... > &t) {
+  s->save(t.tensor());
+}
+
+template < typename C, typename S, ::std::size_t... Dims >
+void load(C *s, ::thunder::tensor::FixedTensor< S, Dims... > *t) {
+  ::thunder::tensor::Tensor< S > x;
+  s->load(&x);
+  *t = ::thunder::tensor::FixedTensor< S, Dims... >(x);
+}
+
+template < typename C, typename S, ::std::size_t N >
+void save(C *s, const ::thunder::tensor::TensorN< S, N > &t) {
+  s->save(t.tensor());
+}
+
+template < typename C, typename S, ::std::size_t N >
+void load(C *s, ::thunder::tensor::TensorN< S, N > *t) {
+  ::thunder::tensor::Tensor< S > x;
+  s->load(&x);
+  *t = ::thunder::tensor::TensorN< S, N >(x);
+}
+
+}  // namespace serializer
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_FIXED_TENSOR_INL_HPP_
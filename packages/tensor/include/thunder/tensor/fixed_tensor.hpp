@@ -0,0 +1,298 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_FIXED_TENSOR_HPP_
+#define THUNDER_TENSOR_FIXED_TENSOR_HPP_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include "thunder/tensor/tensor.hpp"
+
+namespace thunder {
+namespace tensor {
+
+// Compile-time row-major shape
+template < ::std::size_t... Dims >
+struct FixedShape;
+
+template <>
+struct FixedShape<> {
+  static constexpr ::std::size_t dimension() { return 0; }
+  static constexpr ::std::size_t length() { return 1; }
+  static constexpr ::std::size_t size(::std::size_t) { return 1; }
+  static constexpr ::std::size_t stride(::std::size_t) { return 1; }
+  static constexpr ::std::size_t offset() { return 0; }
+};
+
+template < ::std::size_t D0, ::std::size_t... Dims >
+struct FixedShape< D0, Dims... > {
+  typedef FixedShape< Dims... > tail_type;
+  static constexpr ::std::size_t dimension() {
+    return 1 + sizeof...(Dims);
+  }
+  static constexpr ::std::size_t length() {
+    return D0 * tail_type::length();
+  }
+  static constexpr ::std::size_t size(::std::size_t d) {
+    return d == 0 ? D0 : tail_type::size(d - 1);
+  }
+  static constexpr ::std::size_t stride(::std::size_t d) {
+    return d == 0 ? tail_type::length() : tail_type::stride(d - 1);
+  }
+  template < typename... I >
+  static constexpr ::std::size_t offset(::std::size_t pos, I... pos_tail) {
+    return pos * tail_type::length() + tail_type::offset(pos_tail...);
+  }
+};
+
+// Call f(i) for i in [0, N). Short loops are unrolled at compile time.
+template < ::std::size_t N, bool U = (N <= 64) >
+struct Unroll {
+  template < typename F >
+  static void apply(const F &f) {
+    Unroll< N - 1 >::apply(f);
+    f(N - 1);
+  }
+};
+
+template < bool U >
+struct Unroll< 0, U > {
+  template < typename F >
+  static void apply(const F &) {}
+};
+
+template < ::std::size_t N >
+struct Unroll< N, false > {
+  template < typename F >
+  static void apply(const F &f) {
+    for (::std::size_t i = 0; i < N; ++i) {
+      f(i);
+    }
+  }
+};
+
+// Contiguous tensor with shape fixed at compile time. It shares Storage with
+// Tensor, so both can view the same data without copying.
+template < typename S, ::std::size_t... Dims >
+class FixedTensor {
+ public:
+  // Typedefs from storage
+  typedef S storage_type;
+  typedef typename S::allocator_type allocator_type;
+  typedef typename S::value_type value_type;
+  typedef typename S::reference reference;
+  typedef typename S::const_reference const_reference;
+  typedef typename S::difference_type difference_type;
+  typedef typename S::size_type size_type;
+  typedef typename S::pointer pointer;
+  typedef typename S::const_pointer const_pointer;
+
+  // Typedefs for tensor
+  typedef FixedShape< Dims... > shape_type;
+  typedef Tensor< S > tensor_type;
+  typedef typename tensor_type::size_storage size_storage;
+  typedef typename tensor_type::stride_storage stride_storage;
+  typedef typename tensor_type::storage_pointer storage_pointer;
+  typedef typename tensor_type::dim_type dim_type;
+
+  // Constructors
+  explicit FixedTensor(allocator_type alloc = allocator_type());
+  explicit FixedTensor(storage_pointer s, size_type os = 0);
+  explicit FixedTensor(const tensor_type &x);
+  FixedTensor(const FixedTensor &y);
+  FixedTensor(FixedTensor &&y);
+
+  // Destructor
+  ~FixedTensor();
+
+  // Assignment operator (using copy and swap idiom)
+  FixedTensor& operator=(FixedTensor y);
+
+  // Compile-time property queries
+  static constexpr dim_type dimension();
+  static constexpr size_type length();
+  static constexpr size_type size(dim_type dim);
+  static constexpr difference_type stride(dim_type dim);
+
+  // Property queries
+  storage_pointer storage() const;
+  size_type offset() const;
+  pointer data() const;
+  allocator_type allocator() const;
+
+  // Zero-copy view as a dynamic tensor
+  tensor_type tensor() const;
+  // Deep copy
+  FixedTensor clone() const;
+
+  // Access by position in each dimension or by linear position
+  template < typename... I >
+  reference operator()(I... pos) const;
+  reference operator[](size_type pos) const;
+
+  // Unrolled element-wise operations with a constant
+  const FixedTensor& fill(const_reference y) const;
+  const FixedTensor& add(const_reference y) const;
+  const FixedTensor& sub(const_reference y) const;
+  const FixedTensor& mul(const_reference y) const;
+  const FixedTensor& div(const_reference y) const;
+
+  // Unrolled element-wise operations with another tensor
+  const FixedTensor& copy(const FixedTensor &y) const;
+  const FixedTensor& add(const FixedTensor &y) const;
+  const FixedTensor& sub(const FixedTensor &y) const;
+  const FixedTensor& mul(const FixedTensor &y) const;
+  const FixedTensor& div(const FixedTensor &y) const;
+
+  // Non-const element-wise operations are delegated using const_cast
+  FixedTensor& fill(const_reference y);
+  FixedTensor& add(const_reference y);
+  FixedTensor& sub(const_reference y);
+  FixedTensor& mul(const_reference y);
+  FixedTensor& div(const_reference y);
+  FixedTensor& copy(const FixedTensor &y);
+  FixedTensor& add(const FixedTensor &y);
+  FixedTensor& sub(const FixedTensor &y);
+  FixedTensor& mul(const FixedTensor &y);
+  FixedTensor& div(const FixedTensor &y);
+
+  // Unrolled reductions
+  value_type sum() const;
+  value_type dot(const FixedTensor &y) const;
+
+ private:
+  storage_pointer storage_;
+  size_type offset_;
+};
+
+// Matrix-matrix product r = x * y of fixed matrices
+template < typename S, ::std::size_t M, ::std::size_t N, ::std::size_t P >
+const FixedTensor< S, M, P >& mm(const FixedTensor< S, M, N > &x,
+                                 const FixedTensor< S, N, P > &y,
+                                 const FixedTensor< S, M, P > &r);
+template < typename S, ::std::size_t M, ::std::size_t N, ::std::size_t P >
+FixedTensor< S, M, P > mm(const FixedTensor< S, M, N > &x,
+                          const FixedTensor< S, N, P > &y);
+
+// Matrix-vector product r = x * y of fixed matrix and vector
+template < typename S, ::std::size_t M, ::std::size_t N >
+const FixedTensor< S, M >& mv(const FixedTensor< S, M, N > &x,
+                              const FixedTensor< S, N > &y,
+                              const FixedTensor< S, M > &r);
+template < typename S, ::std::size_t M, ::std::size_t N >
+FixedTensor< S, M > mv(const FixedTensor< S, M, N > &x,
+                       const FixedTensor< S, N > &y);
+
+// Tensor with rank fixed at compile time and sizes fixed at runtime. It
+// shares Storage with Tensor, so both can view the same data without copying.
+template < typename S, ::std::size_t N >
+class TensorN {
+ public:
+  // Typedefs from storage
+  typedef S storage_type;
+  typedef typename S::allocator_type allocator_type;
+  typedef typename S::value_type value_type;
+  typedef typename S::reference reference;
+  typedef typename S::const_reference const_reference;
+  typedef typename S::difference_type difference_type;
+  typedef typename S::size_type size_type;
+  typedef typename S::pointer pointer;
+  typedef typename S::const_pointer const_pointer;
+
+  // Typedefs for tensor
+  typedef Tensor< S > tensor_type;
+  typedef ::std::array< size_type, N > size_array;
+  typedef ::std::array< difference_type, N > stride_array;
+  typedef typename tensor_type::size_storage size_storage;
+  typedef typename tensor_type::stride_storage stride_storage;
+  typedef typename tensor_type::storage_pointer storage_pointer;
+  typedef typename tensor_type::dim_type dim_type;
+
+  // Constructors
+  explicit TensorN(const size_array &sz,
+                   allocator_type alloc = allocator_type());
+  explicit TensorN(const tensor_type &x);
+  TensorN(const TensorN &y);
+  TensorN(TensorN &&y);
+
+  // Destructor
+  ~TensorN();
+
+  // Assignment operator (using copy and swap idiom)
+  TensorN& operator=(TensorN y);
+
+  // Property queries
+  static constexpr dim_type dimension();
+  size_type size(dim_type dim) const;
+  const size_array& size() const;
+  size_type length() const;
+  difference_type stride(dim_type dim) const;
+  const stride_array& stride() const;
+  storage_pointer storage() const;
+  size_type offset() const;
+  pointer data() const;
+  bool isContiguous() const;
+
+  // Zero-copy view as a dynamic tensor
+  tensor_type tensor() const;
+
+  // Access by position in each dimension
+  template < typename... I >
+  reference operator()(I... pos) const;
+
+  // Element-wise operations with a constant
+  const TensorN& fill(const_reference y) const;
+  TensorN& fill(const_reference y);
+
+ private:
+  template < ::std::size_t K >
+  difference_type position() const;
+  template < ::std::size_t K, typename... I >
+  difference_type position(size_type pos, I... pos_tail) const;
+
+  size_array size_;
+  stride_array stride_;
+  storage_pointer storage_;
+  size_type offset_;
+};
+
+}  // namespace tensor
+}  // namespace thunder
+
+namespace thunder {
+namespace serializer {
+
+template < typename C, typename S, ::std::size_t... Dims >
+void save(C *s, const ::thunder::tensor::FixedTensor< S, Dims... > &t);
+
+template < typename C, typename S, ::std::size_t... Dims >
+void load(C *s, ::thunder::tensor::FixedTensor< S, Dims... > *t);
+
+template < typename C, typename S, ::std::size_t N >
+void save(C *s, const ::thunder::tensor::TensorN< S, N > &t);
+
+template < typename C, typename S, ::std::size_t N >
+void load(C *s, ::thunder::tensor::TensorN< S, N > *t);
+
+}  // namespace serializer
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_FIXED_TENSOR_HPP_
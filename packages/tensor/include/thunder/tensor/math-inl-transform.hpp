@@ -25,16 +25,59 @@
 
 #include <cmath>
 #include <complex>
+#include <cstddef>
 
 #include "thunder/exception.hpp"
+#include "thunder/parallel.hpp"
 #include "thunder/tensor/index_iterator.hpp"
 
 namespace thunder {
 namespace tensor {
 namespace math {
 
+// Walks the storage offsets of dimensions [a, b) of a tensor in row-major order
+template < typename T >
+class OffsetWalker {
+ public:
+  OffsetWalker(const T &x, typename T::dim_type a, typename T::dim_type b,
+               typename T::size_type start)
+      : x_(x), a_(a), index_(b - a), offset_(0) {
+    for (typename T::dim_type i = index_.size(); i > 0; --i) {
+      typename T::size_type sz = x_.size(a_ + i - 1);
+      index_[i - 1] = sz == 0 ? 0 : start % sz;
+      start = sz == 0 ? 0 : start / sz;
+      offset_ += static_cast< typename T::difference_type >(index_[i - 1]) *
+          x_.stride(a_ + i - 1);
+    }
+  }
+
+  typename T::difference_type offset() const {
+    return offset_;
+  }
+
+  void next() {
+    for (typename T::dim_type i = index_.size(); i > 0; --i) {
+      ++index_[i - 1];
+      offset_ += x_.stride(a_ + i - 1);
+      if (index_[i - 1] < x_.size(a_ + i - 1) || i == 1) {
+        return;
+      }
+      offset_ -= static_cast< typename T::difference_type >(index_[i - 1]) *
+          x_.stride(a_ + i - 1);
+      index_[i - 1] = 0;
+    }
+  }
+
+ private:
+  const T &x_;
+  typename T::dim_type a_;
+  typename T::size_storage index_;
+  typename T::difference_type offset_;
+};
+
+// Check that mask y matches the leading dimensions of x
 template < typename T1, typename T2 >
-T1 extract(const T1 &x, const T2 &y) {
+void checkMask(const T1 &x, const T2 &y) {
   if (x.dimension() < y.dimension()) {
     throw out_of_range("Dimension exceeds limit.");
   }
@@ -45,67 +88,216 @@ T1 extract(const T1 &x, const T2 &y) {
       throw out_of_range("Size does not match.");
     }
   }
-  typename T1::size_storage sz(x.dimension() - y_dimension + 1);
-  for (typename T1::dim_type i = y_dimension; i < x.dimension(); ++i) {
-    sz[i - y_dimension + 1] = x.size(i);
-  }
-  // Get the size of returning tensor
-  sz[0] = 0;
-  if (y.isContiguous()) {
-    typename T2::size_type y_length = y.length();
-    typename T2::pointer y_data = y.data();
-    for (typename T2::size_type i = 0; i < y_length; ++i) {
-      if (static_cast< bool >(y_data[i]) == true) {
-        ++sz[0];
-      }
-    }
-  } else {
-    for (typename T2::reference_iterator begin = y.reference_begin(),
-             end = y.reference_end(); begin != end; ++begin) {
-      if (static_cast< bool >(*begin) == true) {
-        ++sz[0];
+}
+
+// Count selected mask elements for each of k blocks. Afterwards first[b] is
+// the rank of the first selected element in block b and first[k] the total.
+template < typename T1, typename T2, typename P >
+void countMask(const T2 &y, const P &pred, typename T1::size_type k,
+               typename T1::size_storage *first) {
+  typename T2::size_type n = y.length();
+  typename T2::pointer y_data = y.data();
+  typename T1::size_storage &f = *first;
+  parallel::forEachBlock(n, k, [&](::std::size_t b, ::std::size_t begin,
+                                   ::std::size_t end) {
+      typename T1::size_type count = 0;
+      OffsetWalker< T2 > y_walker(y, 0, y.dimension(), begin);
+      for (::std::size_t i = begin; i < end; ++i, y_walker.next()) {
+        if (pred(y_data[y_walker.offset()])) {
+          ++count;
+        }
       }
-    }
+      f[b + 1] = count;
+    });
+  f[0] = 0;
+  for (typename T1::size_type b = 0; b < k; ++b) {
+    f[b + 1] += f[b];
   }
+}
 
-  // Create the new tensor and do the copy
-  T1 t(sz, x.allocator());
-  if (x.isContiguous() && y.isContiguous()) {
-    typename T2::size_type y_length = y.length();
-    typename T2::pointer y_data = y.data();
-    typename T1::difference_type x_step = x.stride(y_dimension - 1);
-    typename T1::size_type x_step_size = ::std::abs(x_step);
-    typename T1::difference_type x_step_increment = x_step > 0 ? 1 : -1;
-    typename T1::pointer t_data = t.data();
-    typename T1::pointer x_data = x.data();
-    typename T1::size_type current = 0;
-    for (typename T2::size_type i = 0; i < y_length; ++i) {
-      if (static_cast< bool >(y_data[i]) == true) {
-        for (typename T1::size_type j = 0; j < x_step_size; ++j) {
-          t_data[current++] = x_data[i * x_step + j * x_step_increment];
+// Call func(rank, offset) for each selected row of x in k parallel blocks
+template < typename T1, typename T2, typename P, typename F >
+void visitMask(const T1 &x, const T2 &y, const P &pred,
+               typename T1::size_type k,
+               const typename T1::size_storage &first, const F &func) {
+  typename T2::size_type n = y.length();
+  typename T2::pointer y_data = y.data();
+  typename T1::dim_type y_dimension = y.dimension();
+  parallel::forEachBlock(n, k, [&](::std::size_t b, ::std::size_t begin,
+                                   ::std::size_t end) {
+      typename T1::size_type rank = first[b];
+      OffsetWalker< T2 > y_walker(y, 0, y_dimension, begin);
+      OffsetWalker< T1 > x_walker(x, 0, y_dimension, begin);
+      for (::std::size_t i = begin; i < end;
+           ++i, y_walker.next(), x_walker.next()) {
+        if (pred(y_data[y_walker.offset()])) {
+          func(rank++, x_walker.offset());
         }
       }
+    });
+}
+
+// Call func(reference, i) for the elements of dimensions [a, dimension()) of x
+// starting at data, where i counts the elements visited in row-major order
+template < typename T, typename F >
+void visitRow(const T &x, typename T::dim_type a, typename T::pointer data,
+              typename T::size_type *i, const F &func) {
+  if (a >= x.dimension()) {
+    func(data[0], (*i)++);
+  } else if (a == x.dimension() - 1) {
+    typename T::difference_type step = x.stride(a);
+    for (typename T::size_type j = 0; j < x.size(a); ++j) {
+      func(data[j * step], (*i)++);
     }
   } else {
-    typename T1::size_storage y_size(y.dimension());
-    for (typename T1::dim_type i = 0; i < y_size.size(); ++i) {
-      y_size[i] = y.size(i);
+    for (typename T::size_type j = 0; j < x.size(a); ++j) {
+      visitRow(x, a + 1, data + j * x.stride(a), i, func);
     }
-    typename T1::size_type pos = 0;
-    IndexIterator< typename T1::size_storage > t_begin =
-        IndexIterator< typename T1::size_storage>::begin(y_size);
-    for (IndexIterator< typename T2::size_storage > begin =
-             IndexIterator< typename T2::size_storage >::begin(y.size()),
-             end = IndexIterator< typename T2::size_storage >::end(y.size());
-         begin != end; ++begin, ++t_begin) {
-      if (static_cast< bool >(y[*begin]()) == true) {
-        t[pos++].copy(x[*t_begin]);
-      }
+  }
+}
+
+// Call func(reference, i) for the row of x at offset with the given length
+template < typename T, typename F >
+void visitRow(const T &x, typename T::dim_type a,
+              typename T::difference_type offset, typename T::size_type length,
+              bool contiguous, const F &func) {
+  typename T::pointer x_data = x.data() + offset;
+  if (contiguous) {
+    for (typename T::size_type i = 0; i < length; ++i) {
+      func(x_data[i], i);
     }
+  } else {
+    typename T::size_type i = 0;
+    visitRow(x, a, x_data, &i, func);
   }
+}
+
+// Whether dimensions [a, dimension()) of x are contiguous
+template < typename T >
+bool rowContiguity(const T &x, typename T::dim_type a) {
+  return a >= x.dimension() || (x.stride(x.dimension() - 1) == 1 &&
+                                x.partialContiguity(a, x.dimension() - 1));
+}
+
+// Number of mask elements processed by one parallel block at least
+const ::std::size_t mask_grain = 32768;
+
+template < typename T1, typename T2, typename P >
+T1 extractIf(const T1 &x, const T2 &y, const P &pred) {
+  checkMask(x, y);
+  typename T1::dim_type y_dimension =
+      static_cast< typename T1::dim_type >(y.dimension());
+  typename T1::size_storage sz(x.dimension() - y_dimension + 1);
+  typename T1::size_type row = 1;
+  for (typename T1::dim_type i = y_dimension; i < x.dimension(); ++i) {
+    sz[i - y_dimension + 1] = x.size(i);
+    row *= x.size(i);
+  }
+
+  // Count selected rows per block, then compact each block independently
+  typename T1::size_type k = parallel::blocks(y.length(), mask_grain);
+  typename T1::size_storage first(k + 1);
+  countMask< T1 >(y, pred, k, &first);
+  sz[0] = first[k];
+  T1 t(sz, x.allocator());
+  typename T1::pointer t_data = t.data();
+  bool contiguous = rowContiguity(x, y_dimension);
+  visitMask(x, y, pred, k, first, [&](typename T1::size_type rank,
+                                      typename T1::difference_type offset) {
+      typename T1::pointer t_row = t_data + rank * row;
+      visitRow(x, y_dimension, offset, row, contiguous, [t_row](
+          typename T1::reference v, typename T1::size_type i) {
+          t_row[i] = v;
+        });
+    });
   return t;
 }
 
+template < typename T1, typename T2, typename P >
+const T1& maskedFillIf(const T1 &x, const T2 &y,
+                       typename T1::const_reference value, const P &pred) {
+  checkMask(x, y);
+  typename T1::dim_type y_dimension =
+      static_cast< typename T1::dim_type >(y.dimension());
+  typename T1::size_type row = 1;
+  for (typename T1::dim_type i = y_dimension; i < x.dimension(); ++i) {
+    row *= x.size(i);
+  }
+
+  // Ranks are not needed so a single pass suffices
+  typename T1::size_type k = parallel::blocks(y.length(), mask_grain);
+  typename T1::size_storage first(k + 1, 0);
+  bool contiguous = rowContiguity(x, y_dimension);
+  visitMask(x, y, pred, k, first, [&](typename T1::size_type,
+                                      typename T1::difference_type offset) {
+      visitRow(x, y_dimension, offset, row, contiguous, [&value](
+          typename T1::reference v, typename T1::size_type) {
+          v = value;
+        });
+    });
+  return x;
+}
+
+template < typename T1, typename T2, typename P >
+const T1& maskedAssignIf(const T1 &x, const T2 &y, const T1 &z,
+                         const P &pred) {
+  checkMask(x, y);
+  typename T1::dim_type y_dimension =
+      static_cast< typename T1::dim_type >(y.dimension());
+  typename T1::size_type row = 1;
+  for (typename T1::dim_type i = y_dimension; i < x.dimension(); ++i) {
+    row *= x.size(i);
+  }
+
+  typename T1::size_type k = parallel::blocks(y.length(), mask_grain);
+  typename T1::size_storage first(k + 1);
+  countMask< T1 >(y, pred, k, &first);
+  if (z.dimension() != x.dimension() - y_dimension + 1 ||
+      z.size(0) != first[k]) {
+    throw out_of_range("Size does not match.");
+  }
+  for (typename T1::dim_type i = y_dimension; i < x.dimension(); ++i) {
+    if (z.size(i - y_dimension + 1) != x.size(i)) {
+      throw out_of_range("Size does not match.");
+    }
+  }
+  T1 source = z;
+  source.contiguous();
+  typename T1::pointer z_data = source.data();
+  bool contiguous = rowContiguity(x, y_dimension);
+  visitMask(x, y, pred, k, first, [&](typename T1::size_type rank,
+                                      typename T1::difference_type offset) {
+      typename T1::pointer z_row = z_data + rank * row;
+      visitRow(x, y_dimension, offset, row, contiguous, [z_row](
+          typename T1::reference v, typename T1::size_type i) {
+          v = z_row[i];
+        });
+    });
+  return x;
+}
+
+template < typename T1, typename T2 >
+T1 extract(const T1 &x, const T2 &y) {
+  return extractIf(x, y, [](typename T2::const_reference v) {
+      return static_cast< bool >(v);
+    });
+}
+
+template < typename T1, typename T2 >
+const T1& maskedFill(const T1 &x, const T2 &y,
+                     typename T1::const_reference value) {
+  return maskedFillIf(x, y, value, [](typename T2::const_reference v) {
+      return static_cast< bool >(v);
+    });
+}
+
+template < typename T1, typename T2 >
+const T1& maskedAssign(const T1 &x, const T2 &y, const T1 &z) {
+  return maskedAssignIf(x, y, z, [](typename T2::const_reference v) {
+      return static_cast< bool >(v);
+    });
+}
+
 template < typename T1, typename T2 >
 T1 shuffle(const T1 &x, const T2 &y) {
   if (static_cast< typename T1::dim_type >(
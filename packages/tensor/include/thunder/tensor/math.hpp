@@ -34,6 +34,19 @@ template < typename T1, typename T2 >
 T1 extract(const T1 &x, const T2 &y);
 template < typename T1, typename T2 >
 T1 shuffle(const T1 &x, const T2 &y);
+template < typename T1, typename T2, typename P >
+T1 extractIf(const T1 &x, const T2 &y, const P &pred);
+template < typename T1, typename T2 >
+const T1& maskedFill(const T1 &x, const T2 &y,
+                     typename T1::const_reference value);
+template < typename T1, typename T2, typename P >
+const T1& maskedFillIf(const T1 &x, const T2 &y,
+                       typename T1::const_reference value, const P &pred);
+template < typename T1, typename T2 >
+const T1& maskedAssign(const T1 &x, const T2 &y, const T1 &z);
+template < typename T1, typename T2, typename P >
+const T1& maskedAssignIf(const T1 &x, const T2 &y, const T1 &z,
+                         const P &pred);
 template < typename T1, typename T2 >
 T1 permute(const T1 &x, const T2 &y, typename T1::dim_type d);
 template < typename T1, typename T2 >
@@ -0,0 +1,144 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_NPY_INL_HPP_
+#define THUNDER_TENSOR_NPY_INL_HPP_
+
+#include "thunder/tensor/npy.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+#include "thunder/tensor/tensor_file.hpp"
+
+namespace thunder {
+namespace tensor {
+
+// Whether x is contiguous in column-major order
+template < typename T >
+bool isFortranContiguous(const T &x) {
+  typename T::difference_type stride = 1;
+  for (typename T::dim_type i = 0; i < x.dimension(); ++i) {
+    if (x.size(i) != 1 && x.stride(i) != stride) {
+      return false;
+    }
+    stride *= x.size(i);
+  }
+  return true;
+}
+
+// Describe y, which is contiguous in C or Fortran order, with the strides
+// of that order
+template < typename T >
+TensorFileEntry npyEntry(const ::std::string &name, const T &y) {
+  typedef typename T::value_type value_type;
+  TensorFileEntry entry;
+  entry.name = name;
+  entry.type = DataTypeOf< value_type >::value;
+  entry.size.resize(y.dimension());
+  entry.stride.resize(y.dimension());
+  bool fortran = !y.isContiguous();
+  ::std::ptrdiff_t stride = 1;
+  for (typename T::dim_type k = 0; k < y.dimension(); ++k) {
+    typename T::dim_type i = fortran ? k : y.dimension() - k - 1;
+    entry.size[i] = y.size(i);
+    entry.stride[i] = stride;
+    stride *= static_cast< ::std::ptrdiff_t >(y.size(i));
+  }
+  entry.offset = 0;
+  entry.bytes = y.length() * sizeof(value_type);
+  return entry;
+}
+
+// Tensor viewing the data of e in mapping, or a copy of them if they are not
+// aligned for the element type
+template < typename T >
+T npyTensor(const ::std::shared_ptr< char > &mapping,
+            const TensorFileEntry &e) {
+  typedef typename T::storage_type storage_type;
+  typedef typename T::value_type value_type;
+  typedef typename storage_type::pointer pointer;
+  typedef typename storage_type::shared_pointer shared_pointer;
+  typedef typename storage_type::allocator_type allocator_type;
+
+  if (e.type != DataTypeOf< value_type >::value) {
+    throw invalid_argument("Array " + e.name + " has a different data type.");
+  }
+  typename T::size_storage size(e.size.size());
+  typename T::stride_storage stride(e.stride.size());
+  for (::std::size_t i = 0; i < e.size.size(); ++i) {
+    size[i] = e.size[i];
+    stride[i] = e.stride[i];
+  }
+  ::std::size_t length = e.bytes / sizeof(value_type);
+  char *data = mapping.get() + e.offset;
+  if (reinterpret_cast< ::std::uintptr_t >(data) % alignof(value_type) == 0) {
+    return T(size, stride, ::std::make_shared< storage_type >(
+        shared_pointer(mapping, reinterpret_cast< pointer >(data)), length,
+        allocator_type()));
+  }
+  typename T::storage_pointer storage =
+      ::std::make_shared< storage_type >(length);
+  ::std::memcpy(storage->data(), data, e.bytes);
+  return T(size, stride, storage);
+}
+
+template < typename T >
+void saveNpy(const ::std::string &path, const T &x) {
+  if (x.isContiguous() || isFortranContiguous(x)) {
+    saveNpy(path, npyEntry("", x), reinterpret_cast< const char* >(x.data()));
+    return;
+  }
+  T y(x.size(), x.allocator());
+  y.copy(x);
+  saveNpy(path, npyEntry("", y), reinterpret_cast< const char* >(y.data()));
+}
+
+template < typename T >
+T NpyFile::get() const {
+  return npyTensor< T >(mapping_, entry_);
+}
+
+template < typename T >
+void NpzWriter::add(const ::std::string &name, const T &x) {
+  T y = x.isContiguous() || isFortranContiguous(x) ? x.lazyClone() : x;
+  if (!y.isContiguous() && !isFortranContiguous(y)) {
+    y.contiguous();
+  }
+  TensorFileEntry entry = npyEntry(name, y);
+
+  // Aliasing the storage keeps the snapshot alive until it is written
+  add(::std::move(entry), ::std::shared_ptr< const char >(
+      y.storage(), reinterpret_cast< const char* >(y.data())));
+}
+
+template < typename T >
+T NpzFile::get(const ::std::string &name) const {
+  return npyTensor< T >(mapping_, entry(name));
+}
+
+}  // namespace tensor
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_NPY_INL_HPP_
@@ -0,0 +1,119 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_NPY_HPP_
+#define THUNDER_TENSOR_NPY_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "thunder/storage.hpp"
+#include "thunder/tensor/tensor_file.hpp"
+
+namespace thunder {
+namespace tensor {
+
+// NumPy .npy files and uncompressed .npz archives of them, for the element
+// types of tensor files: float32, float64, complex64, complex128 and the
+// unsigned integer of the size of size_t.
+//
+// Arrays in C order load with row-major strides and arrays in Fortran order
+// with column-major strides, so neither is transposed or copied. Tensors that
+// are contiguous in either order are written as they are, and others are
+// copied to C order. Files are read by mapping them, and tensors alias the
+// mapping. Archive members are written with their data aligned to 64 bytes
+// in the archive, so that they can be mapped as well.
+
+// Write x as a .npy file
+template < typename T >
+void saveNpy(const ::std::string &path, const T &x);
+// Write e.bytes bytes of data laid out as described by e
+void saveNpy(const ::std::string &path, const TensorFileEntry &e,
+             const char *data);
+
+// A mapped .npy file
+class NpyFile {
+ public:
+  explicit NpyFile(const ::std::string &path,
+                   MapMode mode = MapMode::kReadOnly);
+
+  // Description of the array, with an empty name and its data offset in
+  // the file
+  const TensorFileEntry& entry() const;
+
+  // Tensor whose storage aliases the mapping. It keeps the mapping alive.
+  // Data that are not aligned for the element type are copied instead.
+  template < typename T >
+  T get() const;
+
+ private:
+  ::std::shared_ptr< char > mapping_;
+  ::std::size_t bytes_;
+  TensorFileEntry entry_;
+};
+
+// Collects named tensors and writes them as an uncompressed .npz archive.
+// Adding a tensor takes a snapshot of it as TensorFileWriter does.
+class NpzWriter {
+ public:
+  NpzWriter();
+
+  template < typename T >
+  void add(const ::std::string &name, const T &x);
+  void clear();
+  // Write all tensors added so far to path, each as the member name.npy
+  void save(const ::std::string &path) const;
+
+ private:
+  void add(TensorFileEntry entry, ::std::shared_ptr< const char > data);
+
+  ::std::vector< TensorFileEntry > entries_;
+  ::std::vector< ::std::shared_ptr< const char > > data_;
+};
+
+// A mapped .npz archive. Members must be stored without compression, as
+// numpy.savez writes them.
+class NpzFile {
+ public:
+  explicit NpzFile(const ::std::string &path,
+                   MapMode mode = MapMode::kReadOnly);
+
+  // Arrays in the order of the archive, named without the .npy suffix
+  const ::std::vector< TensorFileEntry >& entries() const;
+  bool contains(const ::std::string &name) const;
+  const TensorFileEntry& entry(const ::std::string &name) const;
+
+  // Tensor whose storage aliases the mapping, as for NpyFile::get
+  template < typename T >
+  T get(const ::std::string &name) const;
+
+ private:
+  ::std::shared_ptr< char > mapping_;
+  ::std::size_t bytes_;
+  ::std::vector< TensorFileEntry > entries_;
+  ::std::unordered_map< ::std::string, ::std::size_t > index_;
+};
+
+}  // namespace tensor
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_NPY_HPP_
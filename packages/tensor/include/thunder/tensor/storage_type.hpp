@@ -22,6 +22,9 @@
 
 #include "thunder/storage.hpp"
 
+#include <complex>
+#include <cstddef>
+
 namespace thunder {
 namespace tensor {
 
@@ -40,6 +43,14 @@ class StorageType<
   typedef Storage< D, A< D > > real_storage;
 };
 
+// Aligned allocators carry their alignment as a second template parameter
+template < typename D, ::std::size_t N >
+class StorageType< Storage< ::std::complex< D >,
+                            AlignedAllocator< ::std::complex< D >, N > > > {
+ public:
+  typedef Storage< D, AlignedAllocator< D, N > > real_storage;
+};
+
 }  // namespace tensor
 }  // namespace thunder
 
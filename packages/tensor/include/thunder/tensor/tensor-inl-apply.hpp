@@ -58,6 +58,7 @@ const Tensor< S >& Tensor< S >::apply(
 template< typename S >
 Tensor< S >& Tensor< S >::apply(
     const ::std::function< value_type(value_type) > &lambda) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->apply(lambda));
 }
@@ -65,6 +66,7 @@ Tensor< S >& Tensor< S >::apply(
 template< typename S >
 Tensor< S >& Tensor< S >::apply(
     const ::std::function< value_type(const value_type&) > &lambda) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->apply(lambda));
 }
@@ -72,6 +74,7 @@ Tensor< S >& Tensor< S >::apply(
 template< typename S >
 Tensor< S >& Tensor< S >::apply(
     const ::std::function< void(value_type&) > &lambda) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->apply(lambda));
 }
@@ -79,6 +82,7 @@ Tensor< S >& Tensor< S >::apply(
 template< typename S >
 Tensor< S >& Tensor< S >::apply(
     const ::std::function< void(value_type*) > &lambda) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->apply(lambda));
 }
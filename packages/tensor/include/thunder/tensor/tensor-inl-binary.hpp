@@ -37,6 +37,7 @@ namespace tensor {
   }                                                                     \
   template < typename S >                                               \
   Tensor< S >& Tensor< S >::func(const_reference y) {                   \
+    unshare();                                                          \
     return const_cast< Tensor& >(                                       \
         const_cast< const Tensor* >(this)->func(y));                    \
   }                                                                     \
@@ -50,6 +51,7 @@ namespace tensor {
   }                                                                     \
   template < typename S >                                               \
   Tensor< S >& Tensor< S >::func(const Tensor &y) {                     \
+    unshare();                                                          \
     return const_cast< Tensor& >(                                       \
         const_cast< const Tensor* >(this)->func(y));                    \
   }                                                                     \
@@ -91,6 +93,7 @@ const Tensor< S >& Tensor< S >::fill(const_reference y) const {
 }
 template < typename S >
 Tensor< S >& Tensor< S >::fill(const_reference y) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->fill(y));
 }
 template < typename S >
@@ -106,9 +109,49 @@ const Tensor< S >& Tensor< S >::copy(const T &y) const {
 template < typename S >
 template < typename T >
 Tensor< S >& Tensor< S >::copy(const T &y) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor *>(this)->copy(y));
 }
 
+template < typename S >
+template < typename T >
+const Tensor< S >& Tensor< S >::maskedFill(
+    const T &y, const_reference value) const {
+  return math::maskedFill(*this, y, value);
+}
+template < typename S >
+template < typename T >
+const Tensor< S >& Tensor< S >::maskedAssign(
+    const T &y, const Tensor &z) const {
+  return math::maskedAssign(*this, y, z);
+}
+template < typename S >
+template < typename T >
+Tensor< S >& Tensor< S >::maskedFill(const T &y, const_reference value) {
+  unshare();
+  return const_cast< Tensor& >(
+      const_cast< const Tensor* >(this)->maskedFill(y, value));
+}
+template < typename S >
+template < typename T >
+Tensor< S >& Tensor< S >::maskedAssign(const T &y, const Tensor &z) {
+  unshare();
+  return const_cast< Tensor& >(
+      const_cast< const Tensor* >(this)->maskedAssign(y, z));
+}
+template < typename S >
+template < typename T >
+Tensor< S > Tensor< S >::maskedFill(
+    const Tensor &x, const T &y, const_reference value) {
+  return x.clone().maskedFill(y, value);
+}
+template < typename S >
+template < typename T >
+Tensor< S > Tensor< S >::maskedAssign(
+    const Tensor &x, const T &y, const Tensor &z) {
+  return x.clone().maskedAssign(y, z);
+}
+
 }  // namespace tensor
 }  // namespace thunder
 
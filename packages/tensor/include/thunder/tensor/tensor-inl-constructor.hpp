@@ -39,7 +39,7 @@ Tensor< S >::Tensor(allocator_type alloc)
 template < typename S >
 Tensor< S >::Tensor(size_storage sz, allocator_type alloc)
     : stride_(sz.size()), offset_(0) {
-  ::std::swap(size_, sz);
+  size_ = sz;
   if (size_.size() == 0) {
     throw invalid_argument("Size is empty.");
   }
@@ -51,6 +51,7 @@ Tensor< S >::Tensor(size_storage sz, allocator_type alloc)
     storage_size *= size_x;
   }
   storage_ = ::std::make_shared< S >(storage_size, alloc);
+  annotateMemory();
   stride_[stride_.size() - 1] = 1;
   for (dim_type i = stride_.size() - 1; i > 0; --i) {
     stride_[i - 1] = size_[i] * stride_[i];
@@ -91,7 +92,7 @@ Tensor< S >::Tensor(storage_pointer s, size_type os)
 template < typename S >
 Tensor< S >::Tensor(size_storage sz, storage_pointer s, size_type os)
     : stride_(sz.size()), offset_(os) {
-  ::std::swap(size_, sz);
+  size_ = sz;
   ::std::swap(storage_, s);
   if (storage_ == nullptr) {
     throw invalid_argument("Storage is nullptr.");
@@ -117,8 +118,8 @@ Tensor< S >::Tensor(size_storage sz, storage_pointer s, size_type os)
 
 template< typename S >
 Tensor< S >::Tensor(size_storage sz, stride_storage st, allocator_type alloc) {
-  ::std::swap(size_, sz);
-  ::std::swap(stride_, st);
+  size_ = sz;
+  stride_ = st;
   if (size_.size() == 0) {
     throw invalid_argument("Size is empty.");
   }
@@ -143,14 +144,19 @@ Tensor< S >::Tensor(size_storage sz, stride_storage st, allocator_type alloc) {
   }
   storage_ = ::std::make_shared< S >(max_offset - min_offset + 1, alloc);
   offset_ = -min_offset;
+  annotateMemory();
 }
 
 template< typename S >
 Tensor< S >::Tensor(size_storage sz, stride_storage st, storage_pointer s,
-                    size_type os) : offset_(os) {
-  ::std::swap(size_, sz);
-  ::std::swap(stride_, st);
-  ::std::swap(storage_, s);
+                    size_type os)
+    : Tensor(s, os, small_size_storage(sz), small_stride_storage(st)) {}
+
+template< typename S >
+Tensor< S >::Tensor(const storage_pointer &s, size_type os,
+                    const small_size_storage &sz,
+                    const small_stride_storage &st)
+    : size_(sz), stride_(st), storage_(s), offset_(os) {
   if (storage_ == nullptr) {
     throw invalid_argument("Storage is nullptr.");
   }
@@ -182,6 +188,22 @@ Tensor< S >::Tensor(size_storage sz, stride_storage st, storage_pointer s,
   }
 }
 
+template< typename S >
+void Tensor< S >::annotateMemory() const {
+  ::thunder::storage::memoryAnnotate(
+      storage_->data(), storage_->size() * sizeof(value_type), size_.data(),
+      size_.size());
+}
+
+template< typename S >
+Tensor< S > Tensor< S >::scratch(size_storage sz, allocator_type alloc) {
+  size_type length = 1;
+  for (const size_type &size_x : sz) {
+    length *= size_x;
+  }
+  return Tensor(sz, ::std::make_shared< S >(S::scratch(length, alloc)));
+}
+
 template < typename S >
 Tensor< S >::Tensor(const Tensor &y)
     : size_(y.size_), stride_(y.stride_), storage_(y.storage_),
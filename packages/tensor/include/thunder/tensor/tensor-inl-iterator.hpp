@@ -27,6 +27,7 @@
 #include <utility>
 
 #include "thunder/exception.hpp"
+#include "thunder/parallel/parallel-inl.hpp"
 
 namespace thunder {
 namespace tensor {
@@ -124,9 +125,7 @@ Tensor< S >::reference_iterator::reference_iterator(const Tensor &x)
 
 template < typename S >
 Tensor< S >::reference_iterator::reference_iterator(
-const Tensor &x, size_storage pos) : tensor_(&x) {
-  ::std::swap(position_, pos);
-}
+const Tensor &x, size_storage pos) : tensor_(&x), position_(pos) {}
 
 template < typename S >
 Tensor< S >::reference_iterator::reference_iterator(
@@ -246,6 +245,232 @@ typename Tensor< S >::reference_iterator Tensor< S >::reference_end(
   return x.reference_end();
 }
 
+template < typename S >
+Tensor< S >::slice::slice(pointer data, dim_type dim, const size_type *sz,
+                          const difference_type *st)
+    : data_(data), dimension_(dim), size_(sz), stride_(st) {}
+
+template < typename S >
+typename Tensor< S >::pointer Tensor< S >::slice::data() const {
+  return data_;
+}
+
+template < typename S >
+typename Tensor< S >::dim_type Tensor< S >::slice::dimension() const {
+  return dimension_;
+}
+
+template < typename S >
+typename Tensor< S >::size_type Tensor< S >::slice::size(dim_type dim) const {
+  return size_[dim];
+}
+
+template < typename S >
+typename Tensor< S >::difference_type Tensor< S >::slice::stride(
+    dim_type dim) const {
+  return stride_[dim];
+}
+
+template < typename S >
+typename Tensor< S >::size_type Tensor< S >::slice::length() const {
+  size_type len = 1;
+  for (dim_type i = 0; i < dimension_; ++i) {
+    len *= size_[i];
+  }
+  return len;
+}
+
+template < typename S >
+bool Tensor< S >::slice::isContiguous() const {
+  difference_type expected = 1;
+  for (dim_type i = dimension_; i > 0; --i) {
+    if (size_[i - 1] != 1 && stride_[i - 1] != expected) {
+      return false;
+    }
+    expected *= static_cast< difference_type >(size_[i - 1]);
+  }
+  return true;
+}
+
+template < typename S >
+typename Tensor< S >::reference Tensor< S >::slice::operator[](
+    size_type pos) const {
+  if (dimension_ == 0) {
+    return data_[pos];
+  }
+  return data_[static_cast< difference_type >(pos) * stride_[0]];
+}
+
+template < typename S >
+typename Tensor< S >::slice Tensor< S >::slice::select(size_type pos) const {
+  return slice(data_ + static_cast< difference_type >(pos) * stride_[0],
+               dimension_ - 1, size_ + 1, stride_ + 1);
+}
+
+template < typename S >
+Tensor< S >::slice_iterator::slice_iterator(const Tensor &x, dim_type dim,
+                                            size_type pos)
+    : tensor_(&x), dimension_(dim), position_(pos), step_(0),
+      size_(x.size_.size() > 0 ? x.size_.size() - 1 : 0),
+      stride_(x.size_.size() > 0 ? x.size_.size() - 1 : 0),
+      current_(nullptr, 0, nullptr, nullptr) {
+  if (dim >= x.size_.size()) {
+    throw out_of_range("Dimension exceeds limit.");
+  }
+  for (dim_type i = 0, j = 0; i < x.size_.size(); ++i) {
+    if (i != dim) {
+      size_[j] = x.size_[i];
+      stride_[j] = x.stride_[i];
+      ++j;
+    }
+  }
+  step_ = x.stride_[dim];
+  current_ = slice(x.data() + static_cast< difference_type >(pos) * step_,
+                   size_.size(), size_.data(), stride_.data());
+}
+
+template < typename S >
+Tensor< S >::slice_iterator::slice_iterator(const slice_iterator &it)
+    : tensor_(it.tensor_), dimension_(it.dimension_), position_(it.position_),
+      step_(it.step_), size_(it.size_), stride_(it.stride_),
+      current_(it.current_.data(), size_.size(), size_.data(),
+               stride_.data()) {}
+
+template < typename S >
+Tensor< S >::slice_iterator::~slice_iterator() {}
+
+template < typename S >
+typename Tensor< S >::slice_iterator& Tensor< S >::slice_iterator::operator=(
+    const slice_iterator &it) {
+  tensor_ = it.tensor_;
+  dimension_ = it.dimension_;
+  position_ = it.position_;
+  step_ = it.step_;
+  size_ = it.size_;
+  stride_ = it.stride_;
+  current_ = slice(it.current_.data(), size_.size(), size_.data(),
+                   stride_.data());
+  return *this;
+}
+
+template < typename S >
+bool Tensor< S >::slice_iterator::operator==(const slice_iterator& it) const {
+  return tensor_ == it.tensor_ && dimension_ == it.dimension_ &&
+      position_ == it.position_;
+}
+
+template < typename S >
+bool Tensor< S >::slice_iterator::operator!=(const slice_iterator& it) const {
+  return !(*this == it);
+}
+
+template < typename S >
+typename Tensor< S >::slice_iterator&
+Tensor< S >::slice_iterator::operator++() {
+  ++position_;
+  current_ = slice(current_.data() + step_, size_.size(), size_.data(),
+                   stride_.data());
+  return *this;
+}
+
+template < typename S >
+typename Tensor< S >::slice_iterator
+Tensor< S >::slice_iterator::operator++(int) {
+  slice_iterator it(*this);
+  ++(*this);
+  return it;
+}
+
+template < typename S >
+const typename Tensor< S >::slice&
+Tensor< S >::slice_iterator::operator*() const {
+  return current_;
+}
+
+template < typename S >
+const typename Tensor< S >::slice*
+Tensor< S >::slice_iterator::operator->() const {
+  return &current_;
+}
+
+template < typename S >
+typename Tensor< S >::size_type
+Tensor< S >::slice_iterator::position() const {
+  return position_;
+}
+
+template < typename S >
+typename Tensor< S >::slice_iterator Tensor< S >::slice_begin(
+    dim_type dim) const {
+  return slice_iterator(*this, dim);
+}
+
+template < typename S >
+typename Tensor< S >::slice_iterator Tensor< S >::slice_end(
+    dim_type dim) const {
+  if (dim >= size_.size()) {
+    throw out_of_range("Dimension exceeds limit.");
+  }
+  return slice_iterator(*this, dim, size_[dim]);
+}
+
+template < typename S >
+typename Tensor< S >::slice_iterator Tensor< S >::slice_begin(
+    const Tensor &x, dim_type dim) {
+  return x.slice_begin(dim);
+}
+
+template < typename S >
+typename Tensor< S >::slice_iterator Tensor< S >::slice_end(
+    const Tensor &x, dim_type dim) {
+  return x.slice_end(dim);
+}
+
+template < typename S >
+template < typename F >
+const Tensor< S >& Tensor< S >::parallelForEachSlice(
+    dim_type dim, const F &lambda) const {
+  // Number of elements handed to one parallel block at least
+  const size_type grain = 32768;
+
+  if (dim >= size_.size()) {
+    throw out_of_range("Dimension exceeds limit.");
+  }
+
+  // Shape arrays are built once and shared read-only by all workers
+  small_size_storage sz(size_.size() - 1);
+  small_stride_storage st(size_.size() - 1);
+  size_type length = 1;
+  for (dim_type i = 0, j = 0; i < size_.size(); ++i) {
+    if (i != dim) {
+      sz[j] = size_[i];
+      st[j] = stride_[i];
+      length *= size_[i];
+      ++j;
+    }
+  }
+
+  pointer base = data();
+  difference_type step = stride_[dim];
+  parallel::forRange(
+      size_[dim], length < grain ? grain / (length > 0 ? length : 1) : 1,
+      [&](size_type begin, size_type end) {
+        for (size_type i = begin; i < end; ++i) {
+          lambda(slice(base + static_cast< difference_type >(i) * step,
+                       sz.size(), sz.data(), st.data()), i);
+        }
+      });
+  return *this;
+}
+
+template < typename S >
+template < typename F >
+Tensor< S >& Tensor< S >::parallelForEachSlice(dim_type dim, const F &lambda) {
+  unshare();
+  return const_cast< Tensor& >(
+      const_cast< const Tensor* >(this)->parallelForEachSlice(dim, lambda));
+}
+
 }  // namespace tensor
 }  // namespace thunder
 
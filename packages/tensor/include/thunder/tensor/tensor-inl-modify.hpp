@@ -107,8 +107,8 @@ Tensor< S >& Tensor< S >::set(
       max_offset >= static_cast< difference_type >(s->size())) {
     throw out_of_range("Offset, size and stride exceed storage size.");
   }
-  ::std::swap(size_, sz);
-  ::std::swap(stride_, st);
+  size_ = sz;
+  stride_ = st;
   ::std::swap(storage_, s);
   ::std::swap(offset_, os);
   return *this;
@@ -184,8 +184,9 @@ Tensor< S >& Tensor< S >::resize(size_storage sz, stride_storage st) {
     storage_ = ::std::make_shared< S >(
         max_offset - min_offset + 1, allocator());
     offset_ = -min_offset;
-    ::std::swap(size_, sz);
-    ::std::swap(stride_, st);
+    size_ = sz;
+    stride_ = st;
+    annotateMemory();
   }
   return *this;
 }
@@ -193,7 +194,7 @@ Tensor< S >& Tensor< S >::resize(size_storage sz, stride_storage st) {
 template < typename S >
 Tensor< S >& Tensor< S >::contiguous() {
   if (!isContiguous()) {
-    Tensor< S > t(size_, allocator());
+    Tensor< S > t = scratch(size_, allocator());
     t.copy(*this);
     ::std::swap(size_, t.size_);
     ::std::swap(stride_, t.stride_);
@@ -207,8 +208,8 @@ template < typename S >
 Tensor< S >& Tensor< S >::squeeze() {
   for (dim_type i = 0; i < size_.size() && size_.size() > 1; ++i) {
     if (size_[i] == 1) {
-      size_storage sz(size_.size() - 1);
-      stride_storage st(stride_.size() - 1);
+      small_size_storage sz(size_.size() - 1);
+      small_stride_storage st(stride_.size() - 1);
       for (dim_type j = 0; j < i; ++j) {
         sz[j] = size_[j];
         st[j] = stride_[j];
@@ -237,6 +238,13 @@ Tensor< S >& Tensor< S >::unique() {
   return *this;
 }
 
+template < typename S >
+Tensor< S >& Tensor< S >::unshare() {
+  // The storage object is kept so that other views of it see the private copy
+  storage_->unshare();
+  return *this;
+}
+
 template < typename S >
 Tensor< S >& Tensor< S >::set(Tensor *x, const Tensor &y) {
   return x->set(y);
@@ -308,6 +316,11 @@ Tensor< S >& Tensor< S >::unique(Tensor *x) {
   return x->unique();
 }
 
+template < typename S >
+Tensor< S >& Tensor< S >::unshare(Tensor *x) {
+  return x->unshare();
+}
+
 }  // namespace tensor
 }  // namespace thunder
 
@@ -54,7 +54,7 @@ typename Tensor< S >::dim_type Tensor< S >::dimension() const {
 }
 
 template < typename S >
-typename Tensor< S >::size_storage Tensor< S >::size() const {
+const typename Tensor< S >::small_size_storage& Tensor< S >::size() const {
   return size_;
 }
 
@@ -76,7 +76,8 @@ typename Tensor< S >::size_type Tensor< S >::length() const {
 }
 
 template < typename S >
-typename Tensor< S >::stride_storage Tensor< S >::stride() const {
+const typename Tensor< S >::small_stride_storage&
+Tensor< S >::stride() const {
   return stride_;
 }
 
@@ -205,13 +206,88 @@ bool Tensor< S >::isUnique() const {
   return storage_.unique();
 }
 
+template < typename S >
+bool Tensor< S >::isShared() const {
+  return storage_->isShared();
+}
+
+template < typename S >
+bool Tensor< S >::isReshapable(const size_storage &sz,
+                               stride_storage *st) const {
+  size_type t_length = 1;
+  for (dim_type i = 0; i < sz.size(); ++i) {
+    t_length *= sz[i];
+  }
+  if (t_length != length()) {
+    return false;
+  }
+  stride_storage t_stride(sz.size());
+  if (t_length == 0 || sz.size() == 0) {
+    // Any strides work for an empty tensor
+    if (sz.size() > 0) {
+      t_stride[sz.size() - 1] = 1;
+      for (dim_type i = sz.size() - 1; i > 0; --i) {
+        t_stride[i - 1] = sz[i] * t_stride[i];
+      }
+    }
+  } else {
+    // Dimensions of size 1 do not constrain the layout
+    size_storage x_size(size_.size());
+    stride_storage x_stride(stride_.size());
+    dim_type x_dimension = 0;
+    for (dim_type i = 0; i < size_.size(); ++i) {
+      if (size_[i] != 1) {
+        x_size[x_dimension] = size_[i];
+        x_stride[x_dimension] = stride_[i];
+        ++x_dimension;
+      }
+    }
+    // Match groups of old and new dimensions having the same length. Each
+    // old group must be contiguous within itself to be viewed as new group.
+    dim_type xi = 0, xj = 1, ti = 0, tj = 1;
+    while (ti < sz.size() && xi < x_dimension) {
+      size_type t_product = sz[ti];
+      size_type x_product = x_size[xi];
+      while (t_product != x_product) {
+        if (t_product < x_product) {
+          t_product *= sz[tj++];
+        } else {
+          x_product *= x_size[xj++];
+        }
+      }
+      for (dim_type k = xi; k < xj - 1; ++k) {
+        if (x_stride[k] !=
+            x_stride[k + 1] * static_cast< difference_type >(x_size[k + 1])) {
+          return false;
+        }
+      }
+      t_stride[tj - 1] = x_stride[xj - 1];
+      for (dim_type k = tj - 1; k > ti; --k) {
+        t_stride[k - 1] = t_stride[k] * static_cast< difference_type >(sz[k]);
+      }
+      ti = tj++;
+      xi = xj++;
+    }
+    // Remaining new dimensions have size 1
+    difference_type last = ti > 0 ? t_stride[ti - 1] : 1;
+    for (dim_type k = ti; k < sz.size(); ++k) {
+      t_stride[k] = last;
+    }
+  }
+  if (st != nullptr) {
+    *st = t_stride;
+  }
+  return true;
+}
+
 template < typename S >
 typename Tensor< S >::dim_type Tensor< S >::dimension(const Tensor &x) {
   return x.dimension();
 }
 
 template < typename S >
-typename Tensor< S >::size_storage Tensor< S >::size(const Tensor &x) {
+const typename Tensor< S >::small_size_storage& Tensor< S >::size(
+    const Tensor &x) {
   return x.size();
 }
 
@@ -227,7 +303,8 @@ typename Tensor< S >::size_type Tensor< S >::length(const Tensor &x) {
 }
 
 template < typename S >
-typename Tensor< S >::stride_storage Tensor< S >::stride(const Tensor &x) {
+const typename Tensor< S >::small_stride_storage& Tensor< S >::stride(
+    const Tensor &x) {
   return x.stride();
 }
 
@@ -308,6 +385,17 @@ bool Tensor< S >::isUnique(const Tensor &x) {
   return x.isUnique();
 }
 
+template < typename S >
+bool Tensor< S >::isShared(const Tensor &x) {
+  return x.isShared();
+}
+
+template < typename S >
+bool Tensor< S >::isReshapable(const Tensor &x, const size_storage &sz,
+                               stride_storage *st) {
+  return x.isReshapable(sz, st);
+}
+
 }  // namespace tensor
 }  // namespace thunder
 
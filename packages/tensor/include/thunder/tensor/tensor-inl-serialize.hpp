@@ -24,6 +24,7 @@
 #include "thunder/tensor/tensor-inl.hpp"
 
 #include <memory>
+#include <utility>
 
 #include "thunder/serializer.hpp"
 
@@ -32,12 +33,24 @@ namespace serializer {
 
 template < typename C, typename S >
 void save(C *s, const tensor::Tensor< S > &t) {
-  s->save(t.size());
-  s->save(t.stride());
+  typedef tensor::Tensor< S > T;
+  s->save(typename T::size_storage(t.size()));
+  s->save(typename T::stride_storage(t.stride()));
   s->save(t.storage());
   s->save(t.offset());
 }
 
+// Compact records have an empty stride, which no saved tensor has otherwise
+template < typename C, typename S >
+void saveCompact(C *s, const tensor::Tensor< S > &t) {
+  typedef tensor::Tensor< S > T;
+  T x = t;
+  x.contiguous();
+  s->save(typename T::size_storage(x.size()));
+  s->save(typename T::stride_storage());
+  s->saveArray(x.data(), x.length());
+}
+
 template < typename C, typename S >
 void load(C *s, tensor::Tensor< S > *t) {
   typedef tensor::Tensor< S > T;
@@ -46,6 +59,12 @@ void load(C *s, tensor::Tensor< S > *t) {
   s->load(&size);
   typename T::stride_storage stride;
   s->load(&stride);
+  if (stride.size() == 0) {
+    T x(size);
+    s->loadArray(x.data(), x.length());
+    *t = ::std::move(x);
+    return;
+  }
   typename T::storage_pointer storage;
   s->load(&storage);
   typename T::size_type offset;
@@ -44,12 +44,14 @@ const Tensor< S >& Tensor< S >::sort(
 
 template < typename S >
 Tensor< S >& Tensor< S >::sort(dim_type d, bool r) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->sort(d, r));
 }
 
 template < typename S >
 Tensor< S >& Tensor< S >::sort(
     dim_type d, Tensor< size_storage > *pos, bool r) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->sort(d, pos, r));
 }
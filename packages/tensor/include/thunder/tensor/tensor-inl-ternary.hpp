@@ -52,6 +52,7 @@ template < typename S >
 template < typename TR >
 Tensor< S >& Tensor< S >::polar(
     typename TR::const_reference r, const TR& theta) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->polar(r, theta));
 }
@@ -59,12 +60,14 @@ template < typename S >
 template < typename TR >
 Tensor< S >& Tensor< S >::polar(
     const TR& r, typename TR::const_reference theta) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->polar(r, theta));
 }
 template < typename S >
 template < typename TR >
 Tensor< S >& Tensor< S >::polar(const TR& r, const TR& theta) {
+  unshare();
   return const_cast< Tensor& >(
       const_cast< const Tensor* >(this)->polar(r, theta));
 }
@@ -111,18 +114,22 @@ const Tensor< S >& Tensor< S >::polar(
 
 template < typename S >
 Tensor< S >& Tensor< S >::polar(const_reference y, const_reference z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->polar(y, z));
 }
 template < typename S >
 Tensor< S >& Tensor< S >::polar(const Tensor &y, const_reference z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->polar(y, z));
 }
 template < typename S >
 Tensor< S >& Tensor< S >::polar(const_reference y, const Tensor &z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->polar(y, z));
 }
 template < typename S >
 Tensor< S >& Tensor< S >::polar(const Tensor &y, const Tensor &z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->polar(y, z));
 }
 
@@ -167,18 +174,22 @@ const Tensor< S >& Tensor< S >::fma(const Tensor &y, const Tensor &z) const {
 
 template < typename S >
 Tensor< S >& Tensor< S >::fma(const_reference y, const_reference z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->fma(y, z));
 }
 template < typename S >
 Tensor< S >& Tensor< S >::fma(const Tensor &y, const_reference z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->fma(y, z));
 }
 template < typename S >
 Tensor< S >& Tensor< S >::fma(const_reference y, const Tensor &z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->fma(y, z));
 }
 template < typename S >
 Tensor< S >& Tensor< S >::fma(const Tensor &y, const Tensor &z) {
+  unshare();
   return const_cast< Tensor& >(const_cast< const Tensor* >(this)->fma(y, z));
 }
 
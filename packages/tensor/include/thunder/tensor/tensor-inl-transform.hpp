@@ -23,6 +23,7 @@
 #include "thunder/tensor/tensor.hpp"
 #include "thunder/tensor/tensor-inl.hpp"
 
+#include <memory>
 #include <utility>
 
 #include "thunder/exception.hpp"
@@ -181,9 +182,9 @@ Tensor< S > Tensor< S >::narrow(dim_type dim, size_type pos,
   if (pos + size > size_[dim]) {
     throw out_of_range("Position and size exceed limit.");
   }
-  size_storage sz = size_;
+  small_size_storage sz = size_;
   sz[dim] = size;
-  return Tensor(sz, stride_, storage_, offset_ + pos * stride_[dim]);
+  return Tensor(storage_, offset_ + pos * stride_[dim], sz, stride_);
 }
 
 template < typename S >
@@ -195,12 +196,12 @@ Tensor< S > Tensor< S >::select(dim_type dim, size_type pos) const {
     throw out_of_range("Position exceed limit.");
   }
   if (size_.size() == 1) {
-    size_storage sz(1, 1);
-    stride_storage st(1, 1);
-    return Tensor(sz, st, storage_, offset_ + pos * stride_[dim]);
+    small_size_storage sz(1, 1);
+    small_stride_storage st(1, 1);
+    return Tensor(storage_, offset_ + pos * stride_[dim], sz, st);
   } else {
-    size_storage sz(size_.size() - 1);
-    stride_storage st(stride_.size() - 1);
+    small_size_storage sz(size_.size() - 1);
+    small_stride_storage st(stride_.size() - 1);
     for (dim_type i = 0; i < dim; ++i) {
       sz[i] = size_[i];
       st[i] = stride_[i];
@@ -209,7 +210,7 @@ Tensor< S > Tensor< S >::select(dim_type dim, size_type pos) const {
       sz[i - 1] = size_[i];
       st[i - 1] = stride_[i];
     }
-    return Tensor(sz, st, storage_, offset_ + pos * stride_[dim]);
+    return Tensor(storage_, offset_ + pos * stride_[dim], sz, st);
   }
 }
 
@@ -248,11 +249,11 @@ Tensor< S > Tensor< S >::view(size_storage sz, stride_storage st,
 
 template < typename S >
 Tensor< S > Tensor< S >::transpose(dim_type dim0, dim_type dim1) const {
-  size_storage sz(size_);
-  stride_storage st(stride_);
+  small_size_storage sz(size_);
+  small_stride_storage st(stride_);
   ::std::swap(sz[dim0], sz[dim1]);
   ::std::swap(st[dim0], st[dim1]);
-  return Tensor(sz, st, storage_, offset_);
+  return Tensor(storage_, offset_, sz, st);
 }
 
 template < typename S >
@@ -264,8 +265,8 @@ Tensor< S > Tensor< S >::unfold(dim_type dim, size_type size,
   if (size > size_[dim]) {
     throw out_of_range("Size exceeds limit.");
   }
-  size_storage sz(size_.size() + 1);
-  stride_storage st(stride_.size() + 1);
+  small_size_storage sz(size_.size() + 1);
+  small_stride_storage st(stride_.size() + 1);
   for (dim_type i = 0; i < dim; ++i) {
     sz[i] = size_[i];
     st[i] = stride_[i];
@@ -278,14 +279,31 @@ Tensor< S > Tensor< S >::unfold(dim_type dim, size_type size,
     sz[i] = size_[i - 1];
     st[i] = stride_[i - 1];
   }
-  return Tensor(sz, st, storage_, offset_);
+  return Tensor(storage_, offset_, sz, st);
 }
 
 template < typename S >
 Tensor< S > Tensor< S >::clone() const {
+  // Lazy clones copy the whole storage when written, so views into a larger
+  // storage are always cloned eagerly
+  if (copyOnWrite() && length() == storage_->size()) {
+    return lazyClone();
+  }
+  // Contiguous tensors spanning their storage use the storage bulk copy
+  if (isContiguous() && length() == storage_->size()) {
+    Tensor t(::std::make_shared< S >(*storage_), offset_, size_, stride_);
+    t.annotateMemory();
+    return t;
+  }
   return Tensor(size_, stride_, allocator()).copy(*this);
 }
 
+template < typename S >
+Tensor< S > Tensor< S >::lazyClone() const {
+  return Tensor(::std::make_shared< S >(storage_->lazyCopy()), offset_, size_,
+                stride_);
+}
+
 template < typename S >
 Tensor< S > Tensor< S >::cat(const Tensor &y, dim_type dim) const {
   if (size_.size() != y.dimension()) {
@@ -306,7 +324,7 @@ Tensor< S > Tensor< S >::cat(const Tensor &y, dim_type dim) const {
   }
   size_storage sz(size_);
   sz[dim] = size_[dim] + y.size(dim);
-  Tensor t(sz, allocator());
+  Tensor t = scratch(sz, allocator());
   t.narrow(dim, 0, size_[dim]).copy(*this);
   t.narrow(dim, size_[dim], y.size(dim)).copy(y);
   return t;
@@ -314,87 +332,60 @@ Tensor< S > Tensor< S >::cat(const Tensor &y, dim_type dim) const {
 
 template < typename S >
 Tensor< S > Tensor< S >::reshape(size_type sz0) const {
-  if (!partialContiguity(0, size_.size() - 1)) {
-    throw contiguity_error(
-        "Reshaping is impossible because of non-contiguity.");
-  }
-  if (sz0 != length()) {
-    throw out_of_range("Length mismatches.");
-  }
-  return Tensor(
-      size_storage({sz0}), stride_storage({stride_[stride_.size() - 1]}),
-      storage_, offset_);
+  return reshape(size_storage({sz0}));
 }
 
 template < typename S >
 Tensor< S > Tensor< S >::reshape(size_type sz0, size_type sz1) const {
-  if (!partialContiguity(0, size_.size() - 1)) {
-    throw contiguity_error(
-        "Reshaping is impossible because of non-contiguity.");
-  }
-  if (sz0 * sz1 != length()) {
-    throw out_of_range("Length mismatches.");
-  }
-  stride_storage st(2);
-  st[1] = stride_[stride_.size() - 1];
-  st[0] = sz1 * st[1];
-  return Tensor(size_storage({sz0, sz1}), st, storage_, offset_);
+  return reshape(size_storage({sz0, sz1}));
 }
 
 template < typename S >
 Tensor< S > Tensor< S >::reshape(size_type sz0, size_type sz1,
                                  size_type sz2) const {
-  if (!partialContiguity(0, size_.size() - 1)) {
-    throw contiguity_error(
-        "Reshaping is impossible because of non-contiguity.");
-  }
-  if (sz0 * sz1 * sz2 != length()) {
-    throw out_of_range("Length mismatches.");
-  }
-  stride_storage st(3);
-  st[2] = stride_[stride_.size() - 1];
-  st[1] = sz2 * st[2];
-  st[0] = sz1 * st[1];
-  return Tensor(size_storage({sz0, sz1, sz2}), st, storage_, offset_);
+  return reshape(size_storage({sz0, sz1, sz2}));
 }
 
 template < typename S >
 Tensor< S > Tensor< S >::reshape(size_type sz0, size_type sz1, size_type sz2,
                                  size_type sz3) const {
-  if (!partialContiguity(0, size_.size() - 1)) {
-    throw contiguity_error(
-        "Reshaping is impossible because of non-contiguity.");
-  }
-  if (sz0 * sz1 * sz2 * sz3 != length()) {
-    throw out_of_range("Length mismatches.");
-  }
-  stride_storage st(4);
-  st[3] = stride_[stride_.size() - 1];
-  st[2] = sz3 * st[3];
-  st[1] = sz2 * st[2];
-  st[0] = sz1 * st[1];
-  return Tensor(size_storage({sz0, sz1, sz2, sz3}), st, storage_, offset_);
+  return reshape(size_storage({sz0, sz1, sz2, sz3}));
 }
 
 template < typename S >
 Tensor< S > Tensor< S >::reshape(size_storage sz) const {
-  if (!partialContiguity(0, size_.size() - 1)) {
+  stride_storage st;
+  if (!isReshapable(sz, &st)) {
+    size_type t_length = 1;
+    for (dim_type i = 0; i < sz.size(); ++i) {
+      t_length *= sz[i];
+    }
+    if (t_length != length()) {
+      throw out_of_range("Length mismatches.");
+    }
     throw contiguity_error(
         "Reshaping is impossible because of non-contiguity.");
   }
-  size_type t_length = 1;
-  for (dim_type i = 0; i < sz.size(); ++i) {
-    t_length *= sz[i];
-  }
-  if (t_length != length()) {
-    throw out_of_range("Length mismatches.");
+  return Tensor(sz, st, storage_, offset_);
+}
+
+template < typename S >
+Tensor< S > Tensor< S >::reshape(size_storage sz, bool *copied) const {
+  stride_storage st;
+  if (isReshapable(sz, &st)) {
+    if (copied != nullptr) {
+      *copied = false;
+    }
+    return Tensor(sz, st, storage_, offset_);
   }
-  stride_storage st(sz.size());
-  st[st.size() - 1] = stride_[stride_.size() - 1];
-  for (dim_type i = st.size() - 1; i > 0; --i) {
-    st[i - 1] = sz[i] * st[i];
+  // Reshaping a contiguous copy always succeeds if the lengths match
+  Tensor t = scratch(size_, allocator());
+  t.copy(*this);
+  Tensor r = t.reshape(sz);
+  if (copied != nullptr) {
+    *copied = true;
   }
-  return Tensor(sz, st, storage_, offset_);
+  return r;
 }
 
 template < typename S >
@@ -468,6 +459,11 @@ Tensor< S > Tensor< S >::clone(const Tensor& x) {
   return x.clone();
 }
 
+template < typename S >
+Tensor< S > Tensor< S >::lazyClone(const Tensor& x) {
+  return x.lazyClone();
+}
+
 template < typename S >
 Tensor< S > Tensor< S >::cat(const Tensor &x, const Tensor &y, dim_type dim) {
   return x.cat(y, dim);
@@ -501,6 +497,12 @@ Tensor< S > Tensor< S >::reshape(const Tensor &x, size_storage sz) {
   return x.reshape(sz);
 }
 
+template < typename S >
+Tensor< S > Tensor< S >::reshape(const Tensor &x, size_storage sz,
+                                 bool *copied) {
+  return x.reshape(sz, copied);
+}
+
 template < typename S >
 typename Tensor< S >::real_tensor Tensor< S >::viewReal(const Tensor &x) {
   return x.viewReal();
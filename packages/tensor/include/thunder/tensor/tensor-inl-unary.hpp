@@ -37,6 +37,7 @@ namespace tensor {
   }                                                                     \
   template < typename S >                                               \
   Tensor< S >& Tensor< S >::func() {                                    \
+    unshare();                                                          \
     return const_cast< Tensor& >(                                       \
         const_cast< const Tensor* >(this)->func());                     \
   }                                                                     \
@@ -34,6 +34,13 @@ namespace tensor {
 template < typename S = DoubleStorage >
 class Tensor;
 
+// Copy-on-write mode. When enabled, clone() of a tensor spanning its whole
+// storage returns a lazyClone() that shares the storage until either side is
+// modified through a non-const tensor operation. Writes through references,
+// raw pointers or const tensors do not trigger the copy.
+bool copyOnWrite();
+void setCopyOnWrite(bool enable);
+
 template < typename S >
 Tensor< S > operator+(
     typename Tensor< S >::const_reference value, const Tensor< S > &x);
@@ -79,6 +86,10 @@ class Tensor {
   typedef ::std::shared_ptr< S > storage_pointer;
   typedef typename size_storage::size_type dim_type;
 
+  // Typedefs for shape metadata kept inline for small dimensions
+  typedef SmallStorage< size_type > small_size_storage;
+  typedef SmallStorage< difference_type > small_stride_storage;
+
   // Typedefs for complex number handling
   typedef typename StorageType< S >::real_storage real_storage;
   typedef Tensor< real_storage > real_tensor;
@@ -121,10 +132,12 @@ class Tensor {
 
   // Property queries
   dim_type dimension() const;
-  size_storage size() const;
+  // Sizes and strides are returned as kept inline, which converts to
+  // size_storage and stride_storage
+  const small_size_storage& size() const;
   size_type size(dim_type dim) const;
   size_type length() const;
-  stride_storage stride() const;
+  const small_stride_storage& stride() const;
   difference_type stride(dim_type dim) const;
   storage_pointer storage() const;
   size_type offset() const;
@@ -140,13 +153,15 @@ class Tensor {
   bool isContiguous() const;
   bool partialContiguity(dim_type a, dim_type b) const;
   bool isUnique() const;
+  bool isShared() const;
+  bool isReshapable(const size_storage &sz, stride_storage *st = nullptr) const;
 
   // Static property queries are delegated
   static dim_type dimension(const Tensor &x);
-  static size_storage size(const Tensor &x);
+  static const small_size_storage& size(const Tensor &x);
   static size_type size(const Tensor &x, dim_type dim);
   static size_type length(const Tensor &x);
-  static stride_storage stride(const Tensor &x);
+  static const small_stride_storage& stride(const Tensor &x);
   static difference_type stride(const Tensor &x, dim_type dim);
   static storage_pointer storage(const Tensor &x);
   static size_type offset(const Tensor &x);
@@ -163,6 +178,9 @@ class Tensor {
   static bool isContiguous(const Tensor &x);
   static bool partialContiguity(const Tensor &x, dim_type a, dim_type b);
   static bool isUnique(const Tensor &x);
+  static bool isShared(const Tensor &x);
+  static bool isReshapable(const Tensor &x, const size_storage &sz,
+                           stride_storage *st = nullptr);
 
   // Assignment operators
   Tensor& operator=(Tensor y);
@@ -201,6 +219,24 @@ class Tensor {
   static reference_iterator reference_begin(const Tensor &x);
   static reference_iterator reference_end(const Tensor &x);
 
+  // Slice iterators yielding non-owning views along a dimension
+  class slice;
+  class slice_iterator;
+  slice_iterator slice_begin(dim_type dim = 0) const;
+  slice_iterator slice_end(dim_type dim = 0) const;
+
+  // Static slice iterator functions are delegated
+  static slice_iterator slice_begin(const Tensor &x, dim_type dim = 0);
+  static slice_iterator slice_end(const Tensor &x, dim_type dim = 0);
+
+  // Call lambda(slice, position) for slices along dim in parallel. The slices
+  // share the shape of the cursor and never touch the storage reference count.
+  // Defined in thunder/tensor/tensor-inl-iterator.hpp.
+  template < typename F >
+  const Tensor& parallelForEachSlice(dim_type dim, const F &lambda) const;
+  template < typename F >
+  Tensor& parallelForEachSlice(dim_type dim, const F &lambda);
+
   // Templated modifiers
   template < typename T >
   Tensor& resizeAs(const T &y);
@@ -224,6 +260,7 @@ class Tensor {
   Tensor& contiguous();
   Tensor& squeeze();
   Tensor& unique();
+  Tensor& unshare();
 
   // Static modifiers are delegated
   static Tensor& set(Tensor *x, const Tensor &y);
@@ -242,6 +279,7 @@ class Tensor {
   static Tensor& contiguous(Tensor *x);
   static Tensor& squeeze(Tensor *x);
   static Tensor& unique(Tensor *x);
+  static Tensor& unshare(Tensor *x);
 
   // Templated subtensor extractors. Specialization because of type collision.
   template < typename T >
@@ -314,6 +352,7 @@ class Tensor {
   Tensor transpose(dim_type dim0 = 0, dim_type dim1 = 1) const;
   Tensor unfold(dim_type dim, size_type size, size_type step) const;
   Tensor clone() const;
+  Tensor lazyClone() const;
   Tensor cat(const Tensor &y, dim_type dim = 0) const;
   Tensor reshape(size_type sz0) const;
   Tensor reshape(size_type sz0, size_type sz1) const;
@@ -321,6 +360,7 @@ class Tensor {
   Tensor reshape(size_type sz0, size_type sz1, size_type sz2,
                          size_type sz3) const;
   Tensor reshape(size_storage sz) const;
+  Tensor reshape(size_storage sz, bool *copied) const;
   real_tensor viewReal() const;
   real_tensor viewImag() const;
 
@@ -342,6 +382,7 @@ class Tensor {
   static Tensor unfold(const Tensor &x, dim_type dim, size_type size,
                        size_type step);
   static Tensor clone(const Tensor& t);
+  static Tensor lazyClone(const Tensor& t);
   static Tensor cat(const Tensor &x, const Tensor &y, dim_type dim = 0);
   static Tensor reshape(const Tensor &x, size_type sz0);
   static Tensor reshape(const Tensor &x, size_type sz0, size_type sz1);
@@ -350,6 +391,7 @@ class Tensor {
   static Tensor reshape(const Tensor &x, size_type sz0, size_type sz1,
                         size_type sz2, size_type sz3);
   static Tensor reshape(const Tensor &x, size_storage sz);
+  static Tensor reshape(const Tensor &x, size_storage sz, bool *copied);
   static real_tensor viewReal(const Tensor &x);
   static real_tensor viewImag(const Tensor &x);
 
@@ -626,6 +668,20 @@ class Tensor {
   template < typename T >
   Tensor& copy(const T& y);
 
+  // Templated masked operations. Rows of leading dimensions selected by y.
+  template < typename T >
+  const Tensor& maskedFill(const T &y, const_reference value) const;
+  template < typename T >
+  const Tensor& maskedAssign(const T &y, const Tensor &z) const;
+  template < typename T >
+  Tensor& maskedFill(const T &y, const_reference value);
+  template < typename T >
+  Tensor& maskedAssign(const T &y, const Tensor &z);
+  template < typename T >
+  static Tensor maskedFill(const Tensor &x, const T &y, const_reference value);
+  template < typename T >
+  static Tensor maskedAssign(const Tensor &x, const T &y, const Tensor &z);
+
   // Element-wise operations with another tensor
   const Tensor& add(const Tensor &y) const;
   const Tensor& sub(const Tensor &y) const;
@@ -907,8 +963,17 @@ class Tensor {
   Tensor operator<=(const Tensor &y) const;
 
  protected:
-  size_storage size_;
-  stride_storage stride_;
+  // Constructor for views that does not allocate for small dimensions
+  Tensor(const storage_pointer &s, size_type os, const small_size_storage &sz,
+         const small_stride_storage &st);
+  // Attach the size to the memory statistics of a newly allocated storage
+  void annotateMemory() const;
+  // Contiguous tensor for temporaries, drawn from the current workspace of
+  // the thread if there is one
+  static Tensor scratch(size_storage sz, allocator_type alloc);
+
+  small_size_storage size_;
+  small_stride_storage stride_;
   storage_pointer storage_;
   size_type offset_;
 };
@@ -968,7 +1033,66 @@ class Tensor< S >::reference_iterator {
 
  protected:
   const Tensor *tensor_;
-  size_storage position_;
+  small_size_storage position_;
+};
+
+// A non-owning view of a subtensor as a raw pointer plus borrowed size and
+// stride arrays. It is valid as long as both its tensor and its cursor live.
+template < typename S >
+class Tensor< S >::slice {
+ public:
+  slice(pointer data, dim_type dim, const size_type *sz,
+        const difference_type *st);
+
+  pointer data() const;
+  dim_type dimension() const;
+  size_type size(dim_type dim) const;
+  difference_type stride(dim_type dim) const;
+  size_type length() const;
+  bool isContiguous() const;
+
+  // Element at pos along the first dimension. A 0-dim slice has only pos 0.
+  reference operator[](size_type pos) const;
+  // Subslice at pos along the first dimension, sharing the shape arrays
+  slice select(size_type pos) const;
+
+ protected:
+  pointer data_;
+  dim_type dimension_;
+  const size_type *size_;
+  const difference_type *stride_;
+};
+
+template < typename S >
+class Tensor< S >::slice_iterator {
+ public:
+  typedef ::std::input_iterator_tag iterator_category;
+
+  slice_iterator(const Tensor &x, dim_type dim, size_type pos = 0);
+  slice_iterator(const slice_iterator& it);
+  ~slice_iterator();
+
+  slice_iterator& operator=(const slice_iterator &it);
+
+  bool operator==(const slice_iterator& it) const;
+  bool operator!=(const slice_iterator& it) const;
+
+  slice_iterator& operator++();
+  slice_iterator operator++(int);
+
+  const slice& operator*() const;
+  const slice* operator->() const;
+
+  size_type position() const;
+
+ protected:
+  const Tensor *tensor_;
+  dim_type dimension_;
+  size_type position_;
+  difference_type step_;
+  small_size_storage size_;
+  small_stride_storage stride_;
+  slice current_;
 };
 
 }  // namespace tensor
@@ -983,6 +1107,13 @@ void save(C *s, const ::thunder::tensor::Tensor< S > &t);
 template < typename C, typename S >
 void load(C *s, ::thunder::tensor::Tensor< S > *t);
 
+// Save a tensor as its sizes and its elements in contiguous order, so that
+// a small view of a large storage writes only the view. It loads with load()
+// as a fresh contiguous tensor, not sharing storage with other views. save()
+// instead writes the whole storage once per serializer record.
+template < typename C, typename S >
+void saveCompact(C *s, const ::thunder::tensor::Tensor< S > &t);
+
 }  // namespace serializer
 }  // namespace thunder
 
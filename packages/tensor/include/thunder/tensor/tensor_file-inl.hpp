@@ -0,0 +1,102 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_TENSOR_FILE_INL_HPP_
+#define THUNDER_TENSOR_TENSOR_FILE_INL_HPP_
+
+#include "thunder/tensor/tensor_file.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+
+namespace thunder {
+namespace tensor {
+
+template < typename T >
+void TensorFileWriter::add(const ::std::string &name, const T &x) {
+  typedef typename T::value_type value_type;
+  T y = x.isContiguous() ? x.lazyClone() : x;
+  y.contiguous();
+
+  TensorFileEntry entry;
+  entry.name = name;
+  entry.type = DataTypeOf< value_type >::value;
+  for (typename T::dim_type i = 0; i < y.dimension(); ++i) {
+    entry.size.push_back(y.size(i));
+    entry.stride.push_back(y.stride(i));
+  }
+  entry.offset = 0;
+  entry.bytes = y.length() * sizeof(value_type);
+
+  // Aliasing the storage keeps the snapshot alive until it is written
+  add(::std::move(entry), ::std::shared_ptr< const char >(
+      y.storage(), reinterpret_cast< const char* >(y.data())));
+}
+
+template < typename T >
+T TensorFile::get(const ::std::string &name) const {
+  typedef typename T::storage_type storage_type;
+  typedef typename T::value_type value_type;
+  typedef typename storage_type::pointer pointer;
+  typedef typename storage_type::shared_pointer shared_pointer;
+  typedef typename storage_type::allocator_type allocator_type;
+
+  const TensorFileEntry &e = entry(name, DataTypeOf< value_type >::value);
+  typename T::size_storage size(e.size.size());
+  typename T::stride_storage stride(e.stride.size());
+  for (::std::size_t i = 0; i < e.size.size(); ++i) {
+    size[i] = e.size[i];
+    stride[i] = e.stride[i];
+  }
+  pointer data = reinterpret_cast< pointer >(mapping_.get() + e.offset);
+  return T(size, stride, ::std::make_shared< storage_type >(
+      shared_pointer(mapping_, data), e.bytes / sizeof(value_type),
+      allocator_type()));
+}
+
+template < typename T >
+T TensorFile::read(const ::std::string &name, ::std::size_t dim,
+                   ::std::size_t pos, ::std::size_t size) const {
+  typedef typename T::value_type value_type;
+  const TensorFileEntry &e = entry(name, DataTypeOf< value_type >::value);
+  if (dim >= e.size.size()) {
+    throw out_of_range("Dimension exceeds limit.");
+  }
+  if (size == 0 || pos >= e.size[dim] || size > e.size[dim] - pos) {
+    throw out_of_range("Slice exceeds size limit.");
+  }
+
+  typename T::size_storage sz(e.size.size());
+  for (::std::size_t i = 0; i < e.size.size(); ++i) {
+    sz[i] = e.size[i];
+  }
+  sz[dim] = size;
+  T x(sz);
+  read(e, dim, pos, size, reinterpret_cast< char* >(x.data()));
+  return x;
+}
+
+}  // namespace tensor
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_TENSOR_FILE_INL_HPP_
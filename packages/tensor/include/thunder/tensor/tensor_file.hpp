@@ -0,0 +1,181 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TENSOR_TENSOR_FILE_HPP_
+#define THUNDER_TENSOR_TENSOR_FILE_HPP_
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "thunder/storage.hpp"
+
+namespace thunder {
+namespace tensor {
+
+// Native tensor file format. A 64-byte header is followed by a table of
+// named tensors and by their raw data, each section aligned to 64 bytes:
+//
+//   header: magic "THUNDERT", version, byte order, count, table offset and
+//           bytes, file bytes
+//   table:  per tensor its name, data type, dimension, sizes, strides, data
+//           offset and data bytes
+//   data:   contiguous elements in the byte order of the writer
+//
+// Files are read by mapping them, so that tensors alias the mapping and pages
+// are read on first access.
+
+// Element types of tensors in a file
+enum class DataType { kFloat = 1, kDouble, kFloatComplex, kDoubleComplex,
+                      kSize };
+
+template < typename D >
+struct DataTypeOf;
+template <>
+struct DataTypeOf< float > {
+  static constexpr DataType value = DataType::kFloat;
+};
+template <>
+struct DataTypeOf< double > {
+  static constexpr DataType value = DataType::kDouble;
+};
+template <>
+struct DataTypeOf< ::std::complex< float > > {
+  static constexpr DataType value = DataType::kFloatComplex;
+};
+template <>
+struct DataTypeOf< ::std::complex< double > > {
+  static constexpr DataType value = DataType::kDoubleComplex;
+};
+template <>
+struct DataTypeOf< ::std::size_t > {
+  static constexpr DataType value = DataType::kSize;
+};
+
+// Bytes per element of a data type
+::std::size_t dataTypeSize(DataType type);
+
+// Description of a tensor in a file
+struct TensorFileEntry {
+  ::std::string name;
+  DataType type;
+  ::std::vector< ::std::size_t > size;
+  ::std::vector< ::std::ptrdiff_t > stride;
+  ::std::uint64_t offset;
+  ::std::uint64_t bytes;
+};
+
+// Handle of a save running in a background thread
+class TensorFileSave {
+ public:
+  TensorFileSave();
+
+  // Wait for the save to finish, throwing any error it met
+  void wait() const;
+  bool done() const;
+  // Stop the save at the next chunk. The file is left as it was and wait()
+  // throws io_error.
+  void cancel();
+
+ private:
+  friend class TensorFileWriter;
+
+  ::std::shared_ptr< ::std::atomic< bool > > cancelled_;
+  ::std::shared_future< void > future_;
+};
+
+// Collects named tensors and writes them in one file. Adding a tensor takes
+// a snapshot of it: contiguous tensors share their storage copy-on-write, so
+// that later changes through non-const tensor operations copy the storage
+// instead of reaching the file, and other tensors are copied.
+class TensorFileWriter {
+ public:
+  TensorFileWriter();
+
+  template < typename T >
+  void add(const ::std::string &name, const T &x);
+  // Drop all snapshots, for example between checkpoints
+  void clear();
+  // Write all tensors added so far to path
+  void save(const ::std::string &path) const;
+  // Write in a background thread and return at once. The data go through
+  // two staging buffers of half of staging_bytes each, so that copying one
+  // chunk overlaps writing the other, and snapshots are released as soon as
+  // they are staged. The file is synced with fdatasync and then renamed over
+  // path, so readers never see a partial file.
+  TensorFileSave saveAsync(const ::std::string &path,
+                           ::std::size_t staging_bytes = 67108864) const;
+
+ private:
+  void add(TensorFileEntry entry, ::std::shared_ptr< const char > data);
+
+  ::std::vector< TensorFileEntry > entries_;
+  ::std::vector< ::std::shared_ptr< const char > > data_;
+};
+
+// A mapped tensor file. Loading reads only the header and table. The default
+// copy-on-write mapping lets tensors be changed without touching the file.
+// Tensors of a kReadOnly mapping must only be read, since the pages are
+// mapped without write access and writing to them faults.
+class TensorFile {
+ public:
+  explicit TensorFile(const ::std::string &path,
+                      MapMode mode = MapMode::kCopyOnWrite);
+
+  // Entries in the order they were written
+  const ::std::vector< TensorFileEntry >& entries() const;
+  bool contains(const ::std::string &name) const;
+  const TensorFileEntry& entry(const ::std::string &name) const;
+
+  // Tensor whose storage aliases the mapping. It keeps the mapping alive.
+  template < typename T >
+  T get(const ::std::string &name) const;
+  // Read narrow(dim, pos, size) of a tensor into a fresh contiguous tensor.
+  // Only the byte ranges of the slice are read from the file, with adjacent
+  // ranges coalesced into single reads. Use select(dim, 0) on a slice of size
+  // 1 to drop the dimension.
+  template < typename T >
+  T read(const ::std::string &name, ::std::size_t dim, ::std::size_t pos,
+         ::std::size_t size) const;
+
+ private:
+  const TensorFileEntry& entry(const ::std::string &name, DataType type) const;
+  void read(const TensorFileEntry &e, ::std::size_t dim, ::std::size_t pos,
+            ::std::size_t size, char *data) const;
+
+  ::std::string path_;
+  // Reads go through the descriptor the file was mapped from, so that they
+  // see the same file after another one is renamed over path_
+  ::std::shared_ptr< const int > fd_;
+  ::std::shared_ptr< char > mapping_;
+  ::std::size_t bytes_;
+  ::std::vector< TensorFileEntry > entries_;
+  ::std::unordered_map< ::std::string, ::std::size_t > index_;
+};
+
+}  // namespace tensor
+}  // namespace thunder
+
+#endif  // THUNDER_TENSOR_TENSOR_FILE_HPP_
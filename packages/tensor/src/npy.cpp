@@ -0,0 +1,659 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/tensor/npy.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+#include "thunder/tensor.hpp"
+#include "thunder/tensor/npy-inl.hpp"
+#include "thunder/tensor/tensor_file.hpp"
+
+namespace thunder {
+namespace tensor {
+
+namespace {
+
+const char kNpyMagic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+const ::std::size_t kAlignment = 64;
+const ::std::size_t kChunkBytes = 16777216;
+
+// Zip records
+const ::std::uint32_t kLocalSignature = 0x04034b50;
+const ::std::uint32_t kCentralSignature = 0x02014b50;
+const ::std::uint32_t kEndSignature = 0x06054b50;
+const ::std::uint32_t kEnd64Signature = 0x06064b50;
+const ::std::uint32_t kLocator64Signature = 0x07064b50;
+const ::std::size_t kLocalBytes = 30;
+const ::std::size_t kCentralBytes = 46;
+const ::std::size_t kEndBytes = 22;
+const ::std::size_t kEnd64Bytes = 56;
+const ::std::size_t kLocator64Bytes = 20;
+const ::std::uint16_t kZip64Extra = 0x0001;
+// Version 2.0, or 4.5 for zip64 records
+const ::std::uint16_t kZipVersion = 20;
+const ::std::uint16_t kZip64Version = 45;
+// 1980-01-01, the earliest date of the format
+const ::std::uint16_t kZipDate = 0x21;
+
+bool littleEndian() {
+  ::std::uint32_t one = 1;
+  unsigned char first;
+  ::std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+// Little endian fields of zip records and .npy headers
+template < typename V >
+void putField(::std::string *s, V value) {
+  for (::std::size_t i = 0; i < sizeof(V); ++i) {
+    s->push_back(static_cast< char >(
+        static_cast< ::std::uint64_t >(value) >> (8 * i) & 0xFF));
+  }
+}
+
+template < typename V >
+V getField(const char *p) {
+  ::std::uint64_t value = 0;
+  for (::std::size_t i = 0; i < sizeof(V); ++i) {
+    value |= static_cast< ::std::uint64_t >(static_cast< unsigned char >(
+        p[i])) << (8 * i);
+  }
+  return static_cast< V >(value);
+}
+
+// CRC-32 of zip archives, continuing from crc
+::std::uint32_t crc32(const char *data, ::std::size_t n,
+                      ::std::uint32_t crc = 0) {
+  static const struct Table {
+    ::std::uint32_t t[4][256];
+    Table() {
+      for (::std::uint32_t i = 0; i < 256; ++i) {
+        ::std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+          c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+        }
+        t[0][i] = c;
+      }
+      for (int k = 1; k < 4; ++k) {
+        for (int i = 0; i < 256; ++i) {
+          t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+      }
+    }
+  } table;
+  const ::std::uint32_t (*t)[256] = table.t;
+  const unsigned char *p = reinterpret_cast< const unsigned char* >(data);
+  crc = ~crc;
+  for (; n >= 4; n -= 4, p += 4) {
+    crc ^= static_cast< ::std::uint32_t >(p[0]) |
+        static_cast< ::std::uint32_t >(p[1]) << 8 |
+        static_cast< ::std::uint32_t >(p[2]) << 16 |
+        static_cast< ::std::uint32_t >(p[3]) << 24;
+    crc = t[3][crc & 0xFF] ^ t[2][(crc >> 8) & 0xFF] ^
+        t[1][(crc >> 16) & 0xFF] ^ t[0][crc >> 24];
+  }
+  for (; n > 0; --n, ++p) {
+    crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+::std::string descr(DataType type) {
+  ::std::string order = littleEndian() ? "<" : ">";
+  switch (type) {
+    case DataType::kFloat:
+      return order + "f4";
+    case DataType::kDouble:
+      return order + "f8";
+    case DataType::kFloatComplex:
+      return order + "c8";
+    case DataType::kDoubleComplex:
+      return order + "c16";
+    case DataType::kSize:
+      return order + "u" + ::std::to_string(sizeof(::std::size_t));
+  }
+  throw invalid_argument("Unknown data type.");
+}
+
+// Whether e has column-major strides that differ from row-major ones
+bool fortranOrder(const TensorFileEntry &e) {
+  ::std::ptrdiff_t stride = 1;
+  bool row_major = true;
+  for (::std::size_t i = e.size.size(); i > 0; --i) {
+    row_major = row_major && (e.size[i - 1] == 1 || e.stride[i - 1] == stride);
+    stride *= static_cast< ::std::ptrdiff_t >(e.size[i - 1]);
+  }
+  return !row_major;
+}
+
+// Header of a .npy file starting at start bytes into its file, padded so
+// that the data that follow are aligned in the file
+::std::string npyHeader(const TensorFileEntry &e, ::std::uint64_t start) {
+  ::std::string dict = "{'descr': '" + descr(e.type) + "', 'fortran_order': " +
+      (fortranOrder(e) ? "True" : "False") + ", 'shape': (";
+  for (::std::size_t i = 0; i < e.size.size(); ++i) {
+    dict += ::std::to_string(e.size[i]) + (e.size.size() == 1 ? "," : "");
+    dict += i + 1 < e.size.size() ? ", " : "";
+  }
+  dict += "), }";
+
+  // Version 1.0 has a 2-byte header length and version 2.0 a 4-byte one
+  for (unsigned char version = 1; version <= 2; ++version) {
+    ::std::size_t prefix = sizeof(kNpyMagic) + 2 + (version == 1 ? 2 : 4);
+    ::std::size_t end = start + prefix + dict.size() + 1;
+    ::std::size_t length = dict.size() + 1 +
+        (kAlignment - end % kAlignment) % kAlignment;
+    if (version == 1 && length > 65535) {
+      continue;
+    }
+    ::std::string header(kNpyMagic, sizeof(kNpyMagic));
+    header.push_back(static_cast< char >(version));
+    header.push_back(0);
+    if (version == 1) {
+      putField(&header, static_cast< ::std::uint16_t >(length));
+    } else {
+      putField(&header, static_cast< ::std::uint32_t >(length));
+    }
+    header += dict;
+    header.resize(prefix + length - 1, ' ');
+    header.push_back('\n');
+    return header;
+  }
+  throw invalid_argument("Array " + e.name + " has too many dimensions.");
+}
+
+// Position after the value of key in a header dictionary
+::std::size_t findKey(const ::std::string &dict, const ::std::string &key,
+                      const ::std::string &what) {
+  ::std::size_t pos = dict.find("'" + key + "'");
+  if (pos == ::std::string::npos) {
+    pos = dict.find("\"" + key + "\"");
+  }
+  if (pos != ::std::string::npos) {
+    pos = dict.find(':', pos + key.size() + 2);
+  }
+  if (pos == ::std::string::npos) {
+    throw io_error(what + " has no " + key + ".");
+  }
+  return dict.find_first_not_of(" \t", pos + 1);
+}
+
+DataType parseDescr(const ::std::string &d, const ::std::string &what) {
+  if (d.size() < 3) {
+    throw io_error(what + " has an unsupported type " + d + ".");
+  }
+  char order = d[0];
+  if ((order == '<' && !littleEndian()) || (order == '>' && littleEndian())) {
+    throw io_error(what + " was written with a different byte order.");
+  }
+  if (order != '<' && order != '>' && order != '=' && order != '|') {
+    throw io_error(what + " has an unsupported type " + d + ".");
+  }
+  ::std::string code = d.substr(1);
+  if (code == "f4") {
+    return DataType::kFloat;
+  }
+  if (code == "f8") {
+    return DataType::kDouble;
+  }
+  if (code == "c8") {
+    return DataType::kFloatComplex;
+  }
+  if (code == "c16") {
+    return DataType::kDoubleComplex;
+  }
+  if (code == "u" + ::std::to_string(sizeof(::std::size_t))) {
+    return DataType::kSize;
+  }
+  throw io_error(what + " has an unsupported type " + d + ".");
+}
+
+// Parse the .npy file of n bytes at p, which starts at base in its file
+TensorFileEntry parseNpy(const char *p, ::std::uint64_t n,
+                         ::std::uint64_t base, const ::std::string &name,
+                         const ::std::string &what) {
+  if (n < sizeof(kNpyMagic) + 4 ||
+      ::std::memcmp(p, kNpyMagic, sizeof(kNpyMagic)) != 0) {
+    throw io_error(what + " is not a .npy file.");
+  }
+  unsigned char version = static_cast< unsigned char >(p[6]);
+  ::std::uint64_t prefix = version == 1 ? 10 : 12;
+  if (version < 1 || version > 3 || n < prefix) {
+    throw io_error(what + " has an unsupported .npy version.");
+  }
+  ::std::uint64_t length = version == 1 ? getField< ::std::uint16_t >(p + 8) :
+      getField< ::std::uint32_t >(p + 8);
+  if (length > n - prefix) {
+    throw io_error(what + " is truncated.");
+  }
+  ::std::string dict(p + prefix, length);
+
+  TensorFileEntry e;
+  e.name = name;
+  ::std::size_t pos = findKey(dict, "descr", what);
+  ::std::size_t end = pos == ::std::string::npos ? pos :
+      dict.find(dict[pos], pos + 1);
+  if (end == ::std::string::npos || (dict[pos] != '\'' && dict[pos] != '"')) {
+    throw io_error(what + " has an unsupported type.");
+  }
+  e.type = parseDescr(dict.substr(pos + 1, end - pos - 1), what);
+
+  pos = findKey(dict, "fortran_order", what);
+  bool fortran = dict.compare(pos, 4, "True") == 0;
+  if (!fortran && dict.compare(pos, 5, "False") != 0) {
+    throw io_error(what + " has an invalid fortran_order.");
+  }
+
+  pos = findKey(dict, "shape", what);
+  if (pos == ::std::string::npos || dict[pos] != '(') {
+    throw io_error(what + " has an invalid shape.");
+  }
+  // Sizes and their products have to fit in strides
+  const ::std::uint64_t limit = static_cast< ::std::uint64_t >(
+      ::std::numeric_limits< ::std::ptrdiff_t >::max());
+  for (++pos; pos < dict.size() && dict[pos] != ')';) {
+    if (dict[pos] == ' ' || dict[pos] == ',' || dict[pos] == 'L') {
+      ++pos;
+      continue;
+    }
+    if (dict[pos] < '0' || dict[pos] > '9') {
+      throw io_error(what + " has an invalid shape.");
+    }
+    ::std::uint64_t size = 0;
+    for (; pos < dict.size() && dict[pos] >= '0' && dict[pos] <= '9'; ++pos) {
+      ::std::uint64_t digit = static_cast< ::std::uint64_t >(dict[pos] - '0');
+      if (size > (limit - digit) / 10) {
+        throw io_error(what + " has an invalid shape.");
+      }
+      size = size * 10 + digit;
+    }
+    e.size.push_back(size);
+  }
+  if (pos >= dict.size()) {
+    throw io_error(what + " has an invalid shape.");
+  }
+  // Tensors have at least one dimension
+  if (e.size.empty()) {
+    e.size.push_back(1);
+  }
+
+  e.stride.resize(e.size.size());
+  ::std::ptrdiff_t stride = 1;
+  ::std::uint64_t count = 1;
+  for (::std::size_t k = 0; k < e.size.size(); ++k) {
+    ::std::size_t i = fortran ? k : e.size.size() - k - 1;
+    if (e.size[i] != 0 && count > limit / e.size[i]) {
+      throw io_error(what + " has an invalid shape.");
+    }
+    e.stride[i] = stride;
+    stride *= static_cast< ::std::ptrdiff_t >(e.size[i]);
+    count *= e.size[i];
+  }
+  e.offset = base + prefix + length;
+  // Dividing keeps the byte count from overflowing
+  if (count > (n - prefix - length) / dataTypeSize(e.type)) {
+    throw io_error(what + " is truncated.");
+  }
+  e.bytes = count * dataTypeSize(e.type);
+  return e;
+}
+
+void writeData(::std::ofstream *stream, const char *data,
+               ::std::uint64_t bytes) {
+  for (::std::uint64_t done = 0; done < bytes; done += kChunkBytes) {
+    stream->write(data + done, ::std::min< ::std::uint64_t >(
+        kChunkBytes, bytes - done));
+  }
+}
+
+// Zip64 extra field holding the fields that do not fit their record
+::std::string zip64Extra(const ::std::vector< ::std::uint64_t > &fields) {
+  ::std::string extra;
+  putField(&extra, kZip64Extra);
+  putField(&extra, static_cast< ::std::uint16_t >(8 * fields.size()));
+  for (::std::uint64_t field : fields) {
+    putField(&extra, field);
+  }
+  return extra;
+}
+
+// Value of a 32-bit zip field, taken from the zip64 extra field if it is
+// saturated
+::std::uint64_t zipField(::std::uint32_t value, const char *extra,
+                         ::std::size_t *used, ::std::size_t n,
+                         const ::std::string &what) {
+  if (value != 0xFFFFFFFFu) {
+    return value;
+  }
+  for (::std::size_t i = 0; i + 4 <= n;) {
+    ::std::uint16_t id = getField< ::std::uint16_t >(extra + i);
+    ::std::uint16_t size = getField< ::std::uint16_t >(extra + i + 2);
+    if (id == kZip64Extra && *used + 8 <= size && i + 4 + size <= n) {
+      ::std::uint64_t field = getField< ::std::uint64_t >(
+          extra + i + 4 + *used);
+      *used += 8;
+      return field;
+    }
+    i += 4 + size;
+  }
+  throw io_error(what + " has a corrupt zip64 record.");
+}
+
+}  // namespace
+
+void saveNpy(const ::std::string &path, const TensorFileEntry &e,
+             const char *data) {
+  ::std::string header = npyHeader(e, 0);
+  ::std::ofstream stream(path, ::std::ios::binary | ::std::ios::trunc);
+  if (!stream) {
+    throw io_error("Cannot open " + path + " for writing.");
+  }
+  stream.write(header.data(), header.size());
+  writeData(&stream, data, e.bytes);
+  if (!stream.flush()) {
+    throw io_error("Cannot write " + path + ".");
+  }
+}
+
+NpyFile::NpyFile(const ::std::string &path, MapMode mode) : bytes_(0) {
+  mapping_ = storage::mapFile(path, mode, 0, &bytes_);
+  entry_ = parseNpy(mapping_.get(), bytes_, 0, "", path);
+}
+
+const TensorFileEntry& NpyFile::entry() const {
+  return entry_;
+}
+
+NpzWriter::NpzWriter() {}
+
+void NpzWriter::add(TensorFileEntry entry,
+                    ::std::shared_ptr< const char > data) {
+  for (const TensorFileEntry &e : entries_) {
+    if (e.name == entry.name) {
+      throw invalid_argument("Array " + entry.name + " is already added.");
+    }
+  }
+  entries_.push_back(::std::move(entry));
+  data_.push_back(::std::move(data));
+}
+
+void NpzWriter::clear() {
+  entries_.clear();
+  data_.clear();
+}
+
+void NpzWriter::save(const ::std::string &path) const {
+  ::std::ofstream stream(path, ::std::ios::binary | ::std::ios::trunc);
+  if (!stream) {
+    throw io_error("Cannot open " + path + " for writing.");
+  }
+
+  ::std::string central;
+  ::std::uint64_t offset = 0;
+  for (::std::size_t i = 0; i < entries_.size(); ++i) {
+    const TensorFileEntry &e = entries_[i];
+    ::std::string name = e.name + ".npy";
+
+    // Members of 4 GiB or more need zip64 sizes, which change where the
+    // .npy header starts and so its padding
+    ::std::string header;
+    ::std::uint64_t size = 0;
+    bool large = false;
+    for (int pass = 0; pass < 2; ++pass) {
+      ::std::uint64_t start = offset + kLocalBytes + name.size() +
+          (large ? 20 : 0);
+      header = npyHeader(e, start);
+      size = header.size() + e.bytes;
+      if (large == (size >= 0xFFFFFFFFu)) {
+        break;
+      }
+      large = !large;
+    }
+    ::std::uint32_t crc = crc32(data_[i].get(), e.bytes,
+                                crc32(header.data(), header.size()));
+    ::std::uint32_t size32 = large ? 0xFFFFFFFFu :
+        static_cast< ::std::uint32_t >(size);
+
+    ::std::string local;
+    putField(&local, kLocalSignature);
+    putField(&local, large ? kZip64Version : kZipVersion);
+    putField(&local, static_cast< ::std::uint16_t >(0));
+    putField(&local, static_cast< ::std::uint16_t >(0));
+    putField(&local, static_cast< ::std::uint16_t >(0));
+    putField(&local, kZipDate);
+    putField(&local, crc);
+    putField(&local, size32);
+    putField(&local, size32);
+    putField(&local, static_cast< ::std::uint16_t >(name.size()));
+    putField(&local, static_cast< ::std::uint16_t >(large ? 20 : 0));
+    local += name;
+    if (large) {
+      local += zip64Extra({size, size});
+    }
+    stream.write(local.data(), local.size());
+    stream.write(header.data(), header.size());
+    writeData(&stream, data_[i].get(), e.bytes);
+
+    ::std::vector< ::std::uint64_t > fields;
+    if (large) {
+      fields.push_back(size);
+      fields.push_back(size);
+    }
+    if (offset >= 0xFFFFFFFFu) {
+      fields.push_back(offset);
+    }
+    ::std::string extra = fields.empty() ? "" : zip64Extra(fields);
+    ::std::uint16_t version = fields.empty() ? kZipVersion : kZip64Version;
+    putField(&central, kCentralSignature);
+    putField(&central, version);
+    putField(&central, version);
+    putField(&central, static_cast< ::std::uint16_t >(0));
+    putField(&central, static_cast< ::std::uint16_t >(0));
+    putField(&central, static_cast< ::std::uint16_t >(0));
+    putField(&central, kZipDate);
+    putField(&central, crc);
+    putField(&central, size32);
+    putField(&central, size32);
+    putField(&central, static_cast< ::std::uint16_t >(name.size()));
+    putField(&central, static_cast< ::std::uint16_t >(extra.size()));
+    putField(&central, static_cast< ::std::uint16_t >(0));
+    putField(&central, static_cast< ::std::uint16_t >(0));
+    putField(&central, static_cast< ::std::uint16_t >(0));
+    putField(&central, static_cast< ::std::uint32_t >(0));
+    putField(&central, static_cast< ::std::uint32_t >(
+        ::std::min< ::std::uint64_t >(offset, 0xFFFFFFFFu)));
+    central += name;
+    central += extra;
+    offset += local.size() + size;
+  }
+
+  ::std::string end;
+  ::std::uint64_t count = entries_.size();
+  if (count >= 0xFFFF || offset >= 0xFFFFFFFFu ||
+      central.size() >= 0xFFFFFFFFu) {
+    putField(&end, kEnd64Signature);
+    putField(&end, static_cast< ::std::uint64_t >(kEnd64Bytes - 12));
+    putField(&end, kZip64Version);
+    putField(&end, kZip64Version);
+    putField(&end, static_cast< ::std::uint32_t >(0));
+    putField(&end, static_cast< ::std::uint32_t >(0));
+    putField(&end, count);
+    putField(&end, count);
+    putField(&end, static_cast< ::std::uint64_t >(central.size()));
+    putField(&end, offset);
+    putField(&end, kLocator64Signature);
+    putField(&end, static_cast< ::std::uint32_t >(0));
+    putField(&end, offset + central.size());
+    putField(&end, static_cast< ::std::uint32_t >(1));
+  }
+  putField(&end, kEndSignature);
+  putField(&end, static_cast< ::std::uint16_t >(0));
+  putField(&end, static_cast< ::std::uint16_t >(0));
+  putField(&end, static_cast< ::std::uint16_t >(
+      ::std::min< ::std::uint64_t >(count, 0xFFFF)));
+  putField(&end, static_cast< ::std::uint16_t >(
+      ::std::min< ::std::uint64_t >(count, 0xFFFF)));
+  putField(&end, static_cast< ::std::uint32_t >(
+      ::std::min< ::std::uint64_t >(central.size(), 0xFFFFFFFFu)));
+  putField(&end, static_cast< ::std::uint32_t >(
+      ::std::min< ::std::uint64_t >(offset, 0xFFFFFFFFu)));
+  putField(&end, static_cast< ::std::uint16_t >(0));
+  stream.write(central.data(), central.size());
+  stream.write(end.data(), end.size());
+  if (!stream.flush()) {
+    throw io_error("Cannot write " + path + ".");
+  }
+}
+
+NpzFile::NpzFile(const ::std::string &path, MapMode mode) : bytes_(0) {
+  mapping_ = storage::mapFile(path, mode, 0, &bytes_);
+  const char *zip = mapping_.get();
+
+  // The end record is followed only by a comment of up to 65535 bytes
+  ::std::size_t end = bytes_;
+  for (::std::size_t i = bytes_ >= kEndBytes ? bytes_ - kEndBytes + 1 : 0;
+       i > 0 && bytes_ - i < kEndBytes + 65536; --i) {
+    if (getField< ::std::uint32_t >(zip + i - 1) == kEndSignature) {
+      end = i - 1;
+      break;
+    }
+  }
+  if (end == bytes_) {
+    throw io_error(path + " is not a .npz file.");
+  }
+  ::std::uint64_t count = getField< ::std::uint16_t >(zip + end + 10);
+  ::std::uint64_t central_bytes = getField< ::std::uint32_t >(zip + end + 12);
+  ::std::uint64_t central = getField< ::std::uint32_t >(zip + end + 16);
+  if (end >= kLocator64Bytes && getField< ::std::uint32_t >(
+          zip + end - kLocator64Bytes) == kLocator64Signature) {
+    ::std::uint64_t end64 = getField< ::std::uint64_t >(
+        zip + end - kLocator64Bytes + 8);
+    if (end64 > bytes_ - kEnd64Bytes ||
+        getField< ::std::uint32_t >(zip + end64) != kEnd64Signature) {
+      throw io_error(path + " has a corrupt zip64 record.");
+    }
+    count = getField< ::std::uint64_t >(zip + end64 + 32);
+    central_bytes = getField< ::std::uint64_t >(zip + end64 + 40);
+    central = getField< ::std::uint64_t >(zip + end64 + 48);
+  }
+  if (central > bytes_ || central_bytes > bytes_ - central) {
+    throw io_error(path + " is truncated.");
+  }
+
+  const char *p = zip + central;
+  const char *limit = p + central_bytes;
+  for (::std::uint64_t i = 0; i < count; ++i) {
+    if (static_cast< ::std::size_t >(limit - p) < kCentralBytes ||
+        getField< ::std::uint32_t >(p) != kCentralSignature) {
+      throw io_error(path + " has a corrupt central directory.");
+    }
+    ::std::uint16_t flags = getField< ::std::uint16_t >(p + 8);
+    ::std::uint16_t method = getField< ::std::uint16_t >(p + 10);
+    ::std::size_t name_bytes = getField< ::std::uint16_t >(p + 28);
+    ::std::size_t extra_bytes = getField< ::std::uint16_t >(p + 30);
+    ::std::size_t comment_bytes = getField< ::std::uint16_t >(p + 32);
+    if (static_cast< ::std::size_t >(limit - p) <
+        kCentralBytes + name_bytes + extra_bytes + comment_bytes) {
+      throw io_error(path + " has a corrupt central directory.");
+    }
+    ::std::string name(p + kCentralBytes, name_bytes);
+    const char *extra = p + kCentralBytes + name_bytes;
+    ::std::size_t used = 0;
+    ::std::uint64_t size = zipField(getField< ::std::uint32_t >(p + 24), extra,
+                                    &used, extra_bytes, path);
+    ::std::uint64_t compressed = zipField(getField< ::std::uint32_t >(p + 20),
+                                          extra, &used, extra_bytes, path);
+    ::std::uint64_t local = zipField(getField< ::std::uint32_t >(p + 42), extra,
+                                     &used, extra_bytes, path);
+    p += kCentralBytes + name_bytes + extra_bytes + comment_bytes;
+
+    const ::std::string suffix = ".npy";
+    if (name.size() <= suffix.size() ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) !=
+        0) {
+      continue;
+    }
+    name.resize(name.size() - suffix.size());
+    if (method != 0 || (flags & 1) != 0 || compressed != size) {
+      throw io_error("Array " + name + " in " + path + " is compressed.");
+    }
+    if (local > bytes_ - kLocalBytes ||
+        getField< ::std::uint32_t >(zip + local) != kLocalSignature) {
+      throw io_error("Array " + name + " in " + path + " is corrupt.");
+    }
+    ::std::uint64_t data = local + kLocalBytes +
+        getField< ::std::uint16_t >(zip + local + 26) +
+        getField< ::std::uint16_t >(zip + local + 28);
+    if (data > bytes_ || size > bytes_ - data) {
+      throw io_error(path + " is truncated.");
+    }
+    TensorFileEntry e = parseNpy(zip + data, size, data, name,
+                                 "Array " + name + " in " + path);
+    if (!index_.emplace(e.name, entries_.size()).second) {
+      throw io_error("Array " + e.name + " in " + path + " is duplicated.");
+    }
+    entries_.push_back(::std::move(e));
+  }
+}
+
+const ::std::vector< TensorFileEntry >& NpzFile::entries() const {
+  return entries_;
+}
+
+bool NpzFile::contains(const ::std::string &name) const {
+  return index_.find(name) != index_.end();
+}
+
+const TensorFileEntry& NpzFile::entry(const ::std::string &name) const {
+  auto found = index_.find(name);
+  if (found == index_.end()) {
+    throw out_of_range("Array " + name + " is not in the archive.");
+  }
+  return entries_[found->second];
+}
+
+#define THUNDER_TENSOR_INSTANTIATE_NPY(S)                               \
+  template void saveNpy(const ::std::string &path, const Tensor< S > &x); \
+  template Tensor< S > NpyFile::get() const;                            \
+  template void NpzWriter::add(const ::std::string &name,               \
+                               const Tensor< S > &x);                   \
+  template Tensor< S > NpzFile::get(const ::std::string &name) const;
+
+THUNDER_TENSOR_INSTANTIATE_NPY(DoubleStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(FloatStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(DoubleComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(FloatComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_NPY(SizeStorage);
+
+#undef THUNDER_TENSOR_INSTANTIATE_NPY
+
+}  // namespace tensor
+}  // namespace thunder
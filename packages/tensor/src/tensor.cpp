@@ -19,23 +19,28 @@
 
 #include "thunder/tensor/tensor.hpp"
 
+#include <atomic>
 #include <complex>
 #include <utility>
 
+#include "thunder/parallel.hpp"
 #include "thunder/serializer.hpp"
 #include "thunder/serializer/binary_protocol.hpp"
 #include "thunder/serializer/serializer.hpp"
 #include "thunder/serializer/static.hpp"
 #include "thunder/serializer/text_protocol.hpp"
 #include "thunder/storage.hpp"
+#include "thunder/tensor/builder.hpp"
 #include "thunder/tensor/index_iterator.hpp"
 #include "thunder/tensor/math.hpp"
 #include "thunder/tensor/complex.hpp"
 
+#include "thunder/parallel/parallel-inl.hpp"
 #include "thunder/serializer/binary_protocol-inl.hpp"
 #include "thunder/serializer/serializer-inl.hpp"
 #include "thunder/serializer/static-inl.hpp"
 #include "thunder/serializer/text_protocol-inl.hpp"
+#include "thunder/tensor/builder-inl.hpp"
 #include "thunder/tensor/index_iterator-inl.hpp"
 #include "thunder/tensor/math-inl.hpp"
 #include "thunder/tensor/complex-inl.hpp"
@@ -44,6 +49,20 @@
 namespace thunder {
 namespace tensor {
 
+namespace {
+
+::std::atomic< bool > copy_on_write_(false);
+
+}  // namespace
+
+bool copyOnWrite() {
+  return copy_on_write_.load();
+}
+
+void setCopyOnWrite(bool enable) {
+  copy_on_write_.store(enable);
+}
+
 // Index iterator instantiation
 template class IndexIterator< SizeStorage >;
 
@@ -54,6 +73,13 @@ template class Tensor< DoubleComplexStorage >;
 template class Tensor< FloatComplexStorage >;
 template class Tensor< SizeStorage >;
 
+// Tensor builder instantiation
+template class TensorBuilder< Tensor< DoubleStorage > >;
+template class TensorBuilder< Tensor< FloatStorage > >;
+template class TensorBuilder< Tensor< DoubleComplexStorage > >;
+template class TensorBuilder< Tensor< FloatComplexStorage > >;
+template class TensorBuilder< Tensor< SizeStorage > >;
+
 #define THUNDER_TENSOR_INSTANTIATE_UNARY(S)                             \
   template Tensor< S > operator+(                                       \
       typename Tensor< S >::const_reference value, const Tensor< S > &x); \
@@ -207,6 +233,21 @@ THUNDER_TENSOR_EXPAND_BINARY_INCOMPATIBLE(
   template const Tensor< S1 >& Tensor< S1 >::copy(                      \
       const Tensor< S2 > &x) const;                                     \
   template Tensor< S1 >& Tensor< S1 >::copy(const Tensor< S2 > &x);     \
+  template const Tensor< S1 >& Tensor< S1 >::maskedFill(                \
+      const Tensor< S2 > &y,                                            \
+      typename Tensor< S1 >::const_reference value) const;              \
+  template const Tensor< S1 >& Tensor< S1 >::maskedAssign(              \
+      const Tensor< S2 > &y, const Tensor< S1 > &z) const;              \
+  template Tensor< S1 >& Tensor< S1 >::maskedFill(                      \
+      const Tensor< S2 > &y,                                            \
+      typename Tensor< S1 >::const_reference value);                    \
+  template Tensor< S1 >& Tensor< S1 >::maskedAssign(                    \
+      const Tensor< S2 > &y, const Tensor< S1 > &z);                    \
+  template Tensor< S1 > Tensor< S1 >::maskedFill(                       \
+      const Tensor< S1 > &x, const Tensor< S2 > &y,                     \
+      typename Tensor< S1 >::const_reference value);                    \
+  template Tensor< S1 > Tensor< S1 >::maskedAssign(                     \
+      const Tensor< S1 > &x, const Tensor< S2 > &y, const Tensor< S1 > &z);\
   template Tensor< S1 > Tensor< S1 >::polars(                           \
       typename Tensor< S2 >::const_reference r,                         \
       const Tensor< S2 > &theta,                                        \
@@ -262,6 +303,9 @@ namespace serializer {
   template void save(                                   \
       StringBinarySerializer *s,                        \
       const ::thunder::tensor::Tensor< D > &t);         \
+  template void saveCompact(                            \
+      StringBinarySerializer *s,                        \
+      const ::thunder::tensor::Tensor< D > &t);         \
   template void StringBinarySerializer::save(           \
       const ::thunder::tensor::Tensor< D > &t);         \
   template void load(                                   \
@@ -272,6 +316,9 @@ namespace serializer {
   template void save(                                   \
       FileBinarySerializer *s,                          \
       const ::thunder::tensor::Tensor< D > &t);         \
+  template void saveCompact(                            \
+      FileBinarySerializer *s,                          \
+      const ::thunder::tensor::Tensor< D > &t);         \
   template void FileBinarySerializer::save(             \
       const ::thunder::tensor::Tensor< D > &t);         \
   template void load(                                   \
@@ -282,6 +329,9 @@ namespace serializer {
   template void save(                                   \
       StringTextSerializer *s,                          \
       const ::thunder::tensor::Tensor< D > &t);         \
+  template void saveCompact(                            \
+      StringTextSerializer *s,                          \
+      const ::thunder::tensor::Tensor< D > &t);         \
   template void StringTextSerializer::save(             \
       const ::thunder::tensor::Tensor< D > &t);         \
   template void load(                                   \
@@ -292,6 +342,9 @@ namespace serializer {
   template void save(                                   \
       FileTextSerializer *s,                            \
       const ::thunder::tensor::Tensor< D > &t);         \
+  template void saveCompact(                            \
+      FileTextSerializer *s,                            \
+      const ::thunder::tensor::Tensor< D > &t);         \
   template void FileTextSerializer::save(               \
       const ::thunder::tensor::Tensor< D > &t);         \
   template void load(                                   \
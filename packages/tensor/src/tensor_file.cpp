@@ -0,0 +1,600 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/tensor/tensor_file.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+#include "thunder/tensor.hpp"
+#include "thunder/tensor/tensor_file-inl.hpp"
+
+namespace thunder {
+namespace tensor {
+
+constexpr DataType DataTypeOf< float >::value;
+constexpr DataType DataTypeOf< double >::value;
+constexpr DataType DataTypeOf< ::std::complex< float > >::value;
+constexpr DataType DataTypeOf< ::std::complex< double > >::value;
+constexpr DataType DataTypeOf< ::std::size_t >::value;
+
+namespace {
+
+const char kMagic[8] = {'T', 'H', 'U', 'N', 'D', 'E', 'R', 'T'};
+const ::std::uint32_t kVersion = 1;
+const ::std::size_t kAlignment = 64;
+const ::std::size_t kHeaderBytes = 64;
+const ::std::size_t kChunkBytes = 16777216;
+
+struct Header {
+  char magic[8];
+  ::std::uint32_t version;
+  ::std::uint32_t order;
+  ::std::uint64_t count;
+  ::std::uint64_t table_offset;
+  ::std::uint64_t table_bytes;
+  ::std::uint64_t file_bytes;
+  ::std::uint64_t reserved[2];
+};
+static_assert(sizeof(Header) == kHeaderBytes, "Header must be 64 bytes.");
+
+::std::uint32_t byteOrder() {
+  ::std::uint32_t one = 1;
+  unsigned char first;
+  ::std::memcpy(&first, &one, 1);
+  return first == 1 ? 1 : 2;
+}
+
+::std::uint64_t align(::std::uint64_t n) {
+  return (n + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+template < typename V >
+void put(::std::string *table, V value) {
+  table->append(reinterpret_cast< const char* >(&value), sizeof(V));
+}
+
+// Reads table fields, checking every read against the end of the table
+class Cursor {
+ public:
+  Cursor(const char *begin, const char *end) : p_(begin), end_(end) {}
+
+  template < typename V >
+  V get() {
+    V value;
+    ::std::memcpy(&value, take(sizeof(V)), sizeof(V));
+    return value;
+  }
+
+  ::std::string getString() {
+    ::std::uint64_t n = get< ::std::uint64_t >();
+    const char *s = take(n);
+    return ::std::string(s, n);
+  }
+
+ private:
+  const char* take(::std::uint64_t n) {
+    if (n > static_cast< ::std::uint64_t >(end_ - p_)) {
+      throw io_error("Tensor file table is truncated.");
+    }
+    const char *s = p_;
+    p_ += n;
+    return s;
+  }
+
+  const char *p_;
+  const char *end_;
+};
+
+::std::string systemError(const ::std::string &what) {
+  return what + ": " + ::std::strerror(errno);
+}
+
+bool validDataType(DataType type) {
+  return type >= DataType::kFloat && type <= DataType::kSize;
+}
+
+// Multiply *a by b, returning false if the product overflows
+bool multiply(::std::uint64_t *a, ::std::uint64_t b) {
+  if (b != 0 && *a > ::std::numeric_limits< ::std::uint64_t >::max() / b) {
+    return false;
+  }
+  *a *= b;
+  return true;
+}
+
+// Read bytes at offset
+void readFully(int fd, char *data, ::std::size_t bytes,
+               ::std::ptrdiff_t offset, const ::std::string &path) {
+  while (bytes > 0) {
+    ::ssize_t done = pread(fd, data, ::std::min(bytes, kChunkBytes),
+                           static_cast< off_t >(offset));
+    if (done <= 0) {
+      if (done < 0 && errno == EINTR) {
+        continue;
+      }
+      ::std::string message = done < 0 ? systemError("Cannot read " + path) :
+          path + " is truncated.";
+      throw io_error(message);
+    }
+    data += done;
+    bytes -= static_cast< ::std::size_t >(done);
+    offset += done;
+  }
+}
+
+// Lay out the data sections after the table, which has to be built first
+// to know where the data begins. Offsets do not change the table size.
+::std::string layout(::std::vector< TensorFileEntry > *entries,
+                     Header *header) {
+  ::std::string table;
+  for (int pass = 0; pass < 2; ++pass) {
+    ::std::uint64_t offset = align(kHeaderBytes + table.size());
+    table.clear();
+    for (TensorFileEntry &e : *entries) {
+      e.offset = offset;
+      offset = align(offset + e.bytes);
+      put< ::std::uint64_t >(&table, e.name.size());
+      table.append(e.name);
+      put< ::std::uint32_t >(&table, static_cast< ::std::uint32_t >(e.type));
+      put< ::std::uint32_t >(&table, e.size.size());
+      for (::std::size_t s : e.size) {
+        put< ::std::uint64_t >(&table, s);
+      }
+      for (::std::ptrdiff_t s : e.stride) {
+        put< ::std::int64_t >(&table, s);
+      }
+      put< ::std::uint64_t >(&table, e.offset);
+      put< ::std::uint64_t >(&table, e.bytes);
+    }
+  }
+
+  ::std::memset(header, 0, sizeof(*header));
+  ::std::memcpy(header->magic, kMagic, sizeof(kMagic));
+  header->version = kVersion;
+  header->order = byteOrder();
+  header->count = entries->size();
+  header->table_offset = kHeaderBytes;
+  header->table_bytes = table.size();
+  header->file_bytes = entries->empty() ? kHeaderBytes + table.size() :
+      align(entries->back().offset + entries->back().bytes);
+  return table;
+}
+
+void writeFully(int fd, const char *data, ::std::size_t bytes,
+                const ::std::string &path) {
+  while (bytes > 0) {
+    ::ssize_t done = write(fd, data, ::std::min(bytes, kChunkBytes));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw io_error(systemError("Cannot write " + path));
+    }
+    data += done;
+    bytes -= static_cast< ::std::size_t >(done);
+  }
+}
+
+// Double buffer between the saving thread, which fills one buffer, and a
+// writing thread, which drains the other
+class Stager {
+ public:
+  Stager(int fd, const ::std::string &path, ::std::size_t staging_bytes,
+         const ::std::atomic< bool > *cancelled)
+      : fd_(fd), path_(path), capacity_(::std::max< ::std::size_t >(
+            staging_bytes / 2, kAlignment)), current_(0), filled_(0),
+        cancelled_(cancelled) {
+    buffers_[0].resize(capacity_);
+    buffers_[1].resize(capacity_);
+  }
+
+  // The writing thread must not outlive the buffers
+  ~Stager() {
+    if (pending_.valid()) {
+      pending_.wait();
+    }
+  }
+
+  // Stage bytes of data, or zeros if data is null
+  void put(const char *data, ::std::size_t bytes) {
+    while (bytes > 0) {
+      ::std::size_t n = ::std::min(bytes, capacity_ - filled_);
+      char *target = buffers_[current_].data() + filled_;
+      if (data != nullptr) {
+        ::std::memcpy(target, data, n);
+        data += n;
+      } else {
+        ::std::memset(target, 0, n);
+      }
+      filled_ += n;
+      bytes -= n;
+      if (filled_ == capacity_) {
+        flush();
+      }
+    }
+  }
+
+  void finish() {
+    if (filled_ > 0) {
+      flush();
+    }
+    if (pending_.valid()) {
+      pending_.get();
+    }
+  }
+
+ private:
+  void flush() {
+    if (cancelled_->load()) {
+      throw io_error("Save of " + path_ + " is cancelled.");
+    }
+    if (pending_.valid()) {
+      pending_.get();
+    }
+    int fd = fd_;
+    const char *data = buffers_[current_].data();
+    ::std::size_t bytes = filled_;
+    const ::std::string &path = path_;
+    pending_ = ::std::async(::std::launch::async, [fd, data, bytes, &path]() {
+      writeFully(fd, data, bytes, path);
+    });
+    current_ = 1 - current_;
+    filled_ = 0;
+  }
+
+  int fd_;
+  const ::std::string &path_;
+  ::std::size_t capacity_;
+  ::std::vector< char > buffers_[2];
+  int current_;
+  ::std::size_t filled_;
+  const ::std::atomic< bool > *cancelled_;
+  ::std::future< void > pending_;
+};
+
+// Body of a background save. It owns the snapshots and drops each one once
+// staged.
+void writeStaged(::std::string path, ::std::vector< TensorFileEntry > entries,
+                 ::std::vector< ::std::shared_ptr< const char > > data,
+                 ::std::size_t staging_bytes,
+                 ::std::shared_ptr< ::std::atomic< bool > > cancelled) {
+  Header header;
+  ::std::string table = layout(&entries, &header);
+  ::std::string temporary = path + ".tmp";
+  int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw io_error(systemError("Cannot open " + temporary));
+  }
+
+  try {
+    Stager stager(fd, temporary, staging_bytes, cancelled.get());
+    stager.put(reinterpret_cast< const char* >(&header), sizeof(header));
+    stager.put(table.data(), table.size());
+    ::std::uint64_t position = kHeaderBytes + table.size();
+    for (::std::size_t i = 0; i < entries.size(); ++i) {
+      stager.put(nullptr, entries[i].offset - position);
+      stager.put(data[i].get(), entries[i].bytes);
+      data[i].reset();
+      position = entries[i].offset + entries[i].bytes;
+    }
+    stager.put(nullptr, header.file_bytes - position);
+    stager.finish();
+    if (fdatasync(fd) != 0) {
+      throw io_error(systemError("Cannot sync " + temporary));
+    }
+  } catch (...) {
+    close(fd);
+    unlink(temporary.c_str());
+    throw;
+  }
+  close(fd);
+  if (rename(temporary.c_str(), path.c_str()) != 0) {
+    unlink(temporary.c_str());
+    throw io_error(systemError("Cannot rename " + temporary));
+  }
+}
+
+}  // namespace
+
+::std::size_t dataTypeSize(DataType type) {
+  switch (type) {
+    case DataType::kFloat:
+      return sizeof(float);
+    case DataType::kDouble:
+      return sizeof(double);
+    case DataType::kFloatComplex:
+      return sizeof(::std::complex< float >);
+    case DataType::kDoubleComplex:
+      return sizeof(::std::complex< double >);
+    case DataType::kSize:
+      return sizeof(::std::size_t);
+    default:
+      throw invalid_argument("Unknown tensor data type.");
+  }
+}
+
+TensorFileWriter::TensorFileWriter() {}
+
+void TensorFileWriter::add(TensorFileEntry entry,
+                           ::std::shared_ptr< const char > data) {
+  for (const TensorFileEntry &e : entries_) {
+    if (e.name == entry.name) {
+      throw invalid_argument("Tensor " + entry.name + " is already added.");
+    }
+  }
+  entries_.push_back(::std::move(entry));
+  data_.push_back(::std::move(data));
+}
+
+void TensorFileWriter::clear() {
+  entries_.clear();
+  data_.clear();
+}
+
+void TensorFileWriter::save(const ::std::string &path) const {
+  ::std::vector< TensorFileEntry > entries(entries_);
+  Header header;
+  ::std::string table = layout(&entries, &header);
+
+  ::std::ofstream stream(path, ::std::ios::binary | ::std::ios::trunc);
+  if (!stream) {
+    throw io_error("Cannot open " + path + " for writing.");
+  }
+  stream.write(reinterpret_cast< const char* >(&header), sizeof(header));
+  stream.write(table.data(), table.size());
+  ::std::uint64_t position = kHeaderBytes + table.size();
+  const char zeros[kAlignment] = {};
+  for (::std::size_t i = 0; i < entries.size(); ++i) {
+    stream.write(zeros, entries[i].offset - position);
+    const char *data = data_[i].get();
+    for (::std::uint64_t done = 0; done < entries[i].bytes;
+         done += kChunkBytes) {
+      stream.write(data + done, ::std::min< ::std::uint64_t >(
+          kChunkBytes, entries[i].bytes - done));
+    }
+    position = entries[i].offset + entries[i].bytes;
+  }
+  stream.write(zeros, header.file_bytes - position);
+  if (!stream.flush()) {
+    throw io_error("Cannot write " + path + ".");
+  }
+}
+
+TensorFileSave TensorFileWriter::saveAsync(const ::std::string &path,
+                                           ::std::size_t staging_bytes) const {
+  TensorFileSave save;
+  save.cancelled_ = ::std::make_shared< ::std::atomic< bool > >(false);
+  save.future_ = ::std::async(::std::launch::async, writeStaged, path,
+                              entries_, data_, staging_bytes,
+                              save.cancelled_).share();
+  return save;
+}
+
+TensorFileSave::TensorFileSave() {}
+
+void TensorFileSave::wait() const {
+  if (future_.valid()) {
+    future_.get();
+  }
+}
+
+bool TensorFileSave::done() const {
+  return !future_.valid() || future_.wait_for(::std::chrono::seconds(0)) ==
+      ::std::future_status::ready;
+}
+
+void TensorFileSave::cancel() {
+  if (cancelled_ != nullptr) {
+    cancelled_->store(true);
+  }
+}
+
+TensorFile::TensorFile(const ::std::string &path, MapMode mode)
+    : path_(path), bytes_(0) {
+  int fd = open(path.c_str(), mode == MapMode::kReadWrite ? O_RDWR :
+                O_RDONLY);
+  if (fd < 0) {
+    throw io_error(systemError("Cannot open " + path));
+  }
+  fd_ = ::std::shared_ptr< const int >(new int(fd), [](const int *p) {
+      close(*p);
+      delete p;
+    });
+  mapping_ = storage::mapFile(fd, mode, 0, &bytes_);
+
+  Header header;
+  if (bytes_ < kHeaderBytes) {
+    throw io_error(path + " is not a tensor file.");
+  }
+  ::std::memcpy(&header, mapping_.get(), sizeof(header));
+  if (::std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw io_error(path + " is not a tensor file.");
+  }
+  if (header.version != kVersion) {
+    throw io_error("Unsupported tensor file version in " + path + ".");
+  }
+  if (header.order != byteOrder()) {
+    throw io_error(path + " was written with a different byte order.");
+  }
+  if (header.file_bytes != bytes_ || header.table_offset > bytes_ ||
+      header.table_bytes > bytes_ - header.table_offset) {
+    throw io_error(path + " is truncated.");
+  }
+
+  const char *table = mapping_.get() + header.table_offset;
+  Cursor cursor(table, table + header.table_bytes);
+  for (::std::uint64_t i = 0; i < header.count; ++i) {
+    TensorFileEntry e;
+    e.name = cursor.getString();
+    e.type = static_cast< DataType >(cursor.get< ::std::uint32_t >());
+    ::std::uint32_t dimension = cursor.get< ::std::uint32_t >();
+    e.size.resize(dimension);
+    e.stride.resize(dimension);
+    // Products of sizes and strides are checked for overflow, so that a
+    // corrupt table cannot make tensors reach past their data
+    bool corrupt = dimension == 0 || !validDataType(e.type);
+    ::std::uint64_t length = 1;
+    for (::std::uint32_t d = 0; d < dimension; ++d) {
+      e.size[d] = cursor.get< ::std::uint64_t >();
+      corrupt = corrupt || !multiply(&length, e.size[d]);
+    }
+    ::std::uint64_t span = 0;
+    for (::std::uint32_t d = 0; d < dimension; ++d) {
+      e.stride[d] = cursor.get< ::std::int64_t >();
+      ::std::uint64_t reach = e.size[d] == 0 ? 0 : e.size[d] - 1;
+      corrupt = corrupt || e.stride[d] < 0 ||
+          !multiply(&reach, static_cast< ::std::uint64_t >(e.stride[d])) ||
+          reach > ::std::numeric_limits< ::std::uint64_t >::max() - span;
+      span += reach;
+    }
+    e.offset = cursor.get< ::std::uint64_t >();
+    e.bytes = cursor.get< ::std::uint64_t >();
+    ::std::uint64_t element = corrupt ? 0 : dataTypeSize(e.type);
+    ::std::uint64_t data_bytes = length;
+    corrupt = corrupt || !multiply(&data_bytes, element) ||
+        (length != 0 && span >= e.bytes / element);
+    if (corrupt || e.offset % kAlignment != 0 || e.offset > bytes_ ||
+        e.bytes > bytes_ - e.offset || e.bytes != data_bytes) {
+      throw io_error("Tensor " + e.name + " in " + path + " is corrupt.");
+    }
+    if (!index_.emplace(e.name, entries_.size()).second) {
+      throw io_error("Tensor " + e.name + " in " + path + " is duplicated.");
+    }
+    entries_.push_back(::std::move(e));
+  }
+}
+
+const ::std::vector< TensorFileEntry >& TensorFile::entries() const {
+  return entries_;
+}
+
+bool TensorFile::contains(const ::std::string &name) const {
+  return index_.find(name) != index_.end();
+}
+
+const TensorFileEntry& TensorFile::entry(const ::std::string &name) const {
+  auto found = index_.find(name);
+  if (found == index_.end()) {
+    throw out_of_range("Tensor " + name + " is not in the file.");
+  }
+  return entries_[found->second];
+}
+
+const TensorFileEntry& TensorFile::entry(const ::std::string &name,
+                                         DataType type) const {
+  const TensorFileEntry &e = entry(name);
+  if (e.type != type) {
+    throw invalid_argument("Tensor " + name + " has a different data type.");
+  }
+  return e;
+}
+
+void TensorFile::read(const TensorFileEntry &e, ::std::size_t dim,
+                      ::std::size_t pos, ::std::size_t size,
+                      char *data) const {
+  ::std::vector< ::std::size_t > sz(e.size);
+  sz[dim] = size;
+  ::std::ptrdiff_t element = static_cast< ::std::ptrdiff_t >(
+      dataTypeSize(e.type));
+
+  // Trailing dimensions that are contiguous in the file form one run
+  ::std::size_t outer = sz.size();
+  ::std::size_t run = 1;
+  while (outer > 0 &&
+         e.stride[outer - 1] == static_cast< ::std::ptrdiff_t >(run)) {
+    --outer;
+    run *= sz[outer];
+  }
+  ::std::size_t runs = 1;
+  for (::std::size_t i = 0; i < outer; ++i) {
+    runs *= sz[i];
+  }
+
+  int fd = *fd_;
+  ::std::ptrdiff_t base = static_cast< ::std::ptrdiff_t >(e.offset) +
+      static_cast< ::std::ptrdiff_t >(pos) * e.stride[dim] * element;
+  ::std::size_t run_bytes = run * static_cast< ::std::size_t >(element);
+  ::std::vector< ::std::size_t > index(outer, 0);
+  ::std::ptrdiff_t begin = base;
+  ::std::size_t bytes = 0;
+  for (::std::size_t r = 0; r < runs; ++r) {
+    ::std::ptrdiff_t position = base;
+    for (::std::size_t i = 0; i < outer; ++i) {
+      position += static_cast< ::std::ptrdiff_t >(index[i]) * e.stride[i] *
+          element;
+    }
+    // Runs adjacent in the file are coalesced, as they are in the output
+    if (bytes > 0 && position != begin +
+        static_cast< ::std::ptrdiff_t >(bytes)) {
+      readFully(fd, data, bytes, begin, path_);
+      data += bytes;
+      bytes = 0;
+    }
+    if (bytes == 0) {
+      begin = position;
+    }
+    bytes += run_bytes;
+    for (::std::size_t i = outer; i > 0; --i) {
+      if (++index[i - 1] < sz[i - 1]) {
+        break;
+      }
+      index[i - 1] = 0;
+    }
+  }
+  readFully(fd, data, bytes, begin, path_);
+}
+
+#define THUNDER_TENSOR_INSTANTIATE_FILE(S)                              \
+  template void TensorFileWriter::add(const ::std::string &name,        \
+                                      const Tensor< S > &x);            \
+  template Tensor< S > TensorFile::get(const ::std::string &name) const; \
+  template Tensor< S > TensorFile::read(                                \
+      const ::std::string &name, ::std::size_t dim, ::std::size_t pos,  \
+      ::std::size_t size) const;
+
+THUNDER_TENSOR_INSTANTIATE_FILE(DoubleStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(FloatStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(DoubleComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(FloatComplexStorage);
+THUNDER_TENSOR_INSTANTIATE_FILE(SizeStorage);
+
+#undef THUNDER_TENSOR_INSTANTIATE_FILE
+
+}  // namespace tensor
+}  // namespace thunder
@@ -0,0 +1,203 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/tensor.hpp"
+#include "thunder/tensor/fixed_tensor.hpp"
+
+#include <array>
+#include <complex>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/serializer.hpp"
+#include "thunder/storage.hpp"
+
+#include "thunder/serializer/binary_protocol-inl.hpp"
+#include "thunder/serializer/serializer-inl.hpp"
+#include "thunder/serializer/static-inl.hpp"
+#include "thunder/serializer/text_protocol-inl.hpp"
+#include "thunder/tensor/fixed_tensor-inl.hpp"
+
+namespace thunder {
+namespace {
+
+template < typename S >
+void fixedConstructorTest() {
+  typedef FixedTensor< S, 2, 3, 4 > T;
+  static_assert(T::dimension() == 3, "Dimension is computed at compile time");
+  static_assert(T::length() == 24, "Length is computed at compile time");
+  static_assert(T::stride(0) == 12, "Stride is computed at compile time");
+
+  T t1;
+  EXPECT_EQ(24, t1.storage()->size());
+  for (typename T::size_type i = 0; i < 2; ++i) {
+    for (typename T::size_type j = 0; j < 3; ++j) {
+      for (typename T::size_type k = 0; k < 4; ++k) {
+        t1(i, j, k) = static_cast< typename T::value_type >(i * 12 + j * 4 + k);
+      }
+    }
+  }
+  for (typename T::size_type i = 0; i < T::length(); ++i) {
+    EXPECT_EQ(static_cast< typename T::value_type >(i), t1[i]);
+  }
+
+  // Views from and to dynamic tensors share storage
+  Tensor< S > x = t1.tensor();
+  EXPECT_EQ(t1.storage(), x.storage());
+  EXPECT_EQ(3, x.dimension());
+  EXPECT_EQ(4, x.size(2));
+  EXPECT_EQ(t1(1, 2, 3), x(1, 2, 3));
+  Tensor< S > y(5, 24);
+  T t2(y.storage(), y[3].offset());
+  EXPECT_EQ(y.storage(), t2.storage());
+  t2.fill(7);
+  EXPECT_EQ(static_cast< typename T::value_type >(7), y(3, 5));
+  EXPECT_EQ(static_cast< typename T::value_type >(7), y(3, 23));
+
+  // Views follow the storage when it reallocates
+  y.storage()->grow(1024);
+  EXPECT_EQ(y.storage()->data() + t2.offset(), t2.data());
+  EXPECT_EQ(static_cast< typename T::value_type >(7), t2[23]);
+
+  // Shape and contiguity are checked
+  EXPECT_THROW(T(Tensor< S >(2, 3, 5)), out_of_range);
+  EXPECT_THROW(T(Tensor< S >(4, 3, 2).transpose(0, 2)), contiguity_error);
+
+  // Clone makes a deep copy
+  T t3 = t1.clone();
+  EXPECT_NE(t1.storage(), t3.storage());
+  t3.add(1);
+  EXPECT_EQ(t1(1, 1, 1) + static_cast< typename T::value_type >(1),
+            t3(1, 1, 1));
+}
+
+TEST(FixedTensorTest, constructorTest) {
+  fixedConstructorTest< DoubleStorage >();
+  fixedConstructorTest< FloatStorage >();
+  fixedConstructorTest< DoubleComplexStorage >();
+  fixedConstructorTest< FloatComplexStorage >();
+}
+
+template < typename S >
+void fixedArithmeticTest() {
+  typedef typename S::value_type D;
+  FixedTensor< S, 3, 3 > a;
+  FixedTensor< S, 3 > v;
+  for (typename S::size_type i = 0; i < 3; ++i) {
+    v[i] = static_cast< D >(i + 1);
+    for (typename S::size_type j = 0; j < 3; ++j) {
+      a(i, j) = static_cast< D >(i * 3 + j);
+    }
+  }
+  FixedTensor< S, 3 > r = tensor::mv(a, v);
+  EXPECT_EQ(static_cast< D >(8), r[0]);
+  EXPECT_EQ(static_cast< D >(26), r[1]);
+  EXPECT_EQ(static_cast< D >(44), r[2]);
+
+  FixedTensor< S, 3, 3 > b = tensor::mm(a, a);
+  for (typename S::size_type i = 0; i < 3; ++i) {
+    for (typename S::size_type j = 0; j < 3; ++j) {
+      D expected = 0;
+      for (typename S::size_type k = 0; k < 3; ++k) {
+        expected += a(i, k) * a(k, j);
+      }
+      EXPECT_EQ(expected, b(i, j));
+    }
+  }
+
+  EXPECT_EQ(static_cast< D >(36), a.sum());
+  EXPECT_EQ(static_cast< D >(14), v.dot(v));
+  FixedTensor< S, 3 > w = v.clone();
+  w.mul(v).sub(1).div(v);
+  EXPECT_EQ(static_cast< D >(0), w[0]);
+  EXPECT_EQ(static_cast< D >(1.5), w[1]);
+
+  // Large shapes fall back to loops instead of unrolling
+  FixedTensor< S, 100, 100 > c;
+  c.fill(1);
+  EXPECT_EQ(static_cast< D >(10000), c.sum());
+}
+
+TEST(FixedTensorTest, arithmeticTest) {
+  fixedArithmeticTest< DoubleStorage >();
+  fixedArithmeticTest< FloatStorage >();
+  fixedArithmeticTest< DoubleComplexStorage >();
+  fixedArithmeticTest< FloatComplexStorage >();
+}
+
+template < typename S >
+void tensorNTest() {
+  typedef TensorN< S, 3 > T;
+  T t1(typename T::size_array{{4, 5, 6}});
+  EXPECT_EQ(120, t1.length());
+  EXPECT_TRUE(t1.isContiguous());
+  t1.fill(2);
+  t1(3, 4, 5) = 9;
+  Tensor< S > x = t1.tensor();
+  EXPECT_EQ(t1.storage(), x.storage());
+  EXPECT_EQ(static_cast< typename T::value_type >(9), x(3, 4, 5));
+
+  // Strided views are kept as they are
+  T t2(x.transpose(0, 2));
+  EXPECT_FALSE(t2.isContiguous());
+  EXPECT_EQ(6, t2.size(0));
+  EXPECT_EQ(static_cast< typename T::value_type >(9), t2(5, 4, 3));
+  t2.fill(1);
+  EXPECT_EQ(static_cast< typename T::value_type >(1), t1(3, 4, 5));
+  EXPECT_THROW(T(Tensor< S >(2, 3)), out_of_range);
+}
+
+TEST(FixedTensorTest, tensorNTest) {
+  tensorNTest< DoubleStorage >();
+  tensorNTest< FloatStorage >();
+  tensorNTest< DoubleComplexStorage >();
+  tensorNTest< FloatComplexStorage >();
+}
+
+TEST(FixedTensorTest, serializeTest) {
+  FixedTensor< DoubleStorage, 2, 2 > t1;
+  t1(0, 0) = 1;
+  t1(0, 1) = 2;
+  t1(1, 0) = 3;
+  t1(1, 1) = 4;
+  TensorN< DoubleStorage, 2 > t2(t1.tensor());
+
+  StringBinarySerializer s1;
+  s1.save(t1);
+  s1.save(t2);
+  FixedTensor< DoubleStorage, 2, 2 > t3;
+  TensorN< DoubleStorage, 2 > t4(
+      TensorN< DoubleStorage, 2 >::size_array{{1, 1}});
+  s1.load(&t3);
+  s1.load(&t4);
+  EXPECT_EQ(t3.storage(), t4.storage());
+  EXPECT_EQ(3, t3(1, 0));
+  EXPECT_EQ(4, t4(1, 1));
+
+  // Fixed tensors are saved in the format of dynamic tensors
+  StringTextSerializer s2;
+  s2.save(t1);
+  DoubleTensor t5;
+  s2.load(&t5);
+  EXPECT_EQ(2, t5.dimension());
+  EXPECT_EQ(2, t5(0, 1));
+}
+
+}  // namespace
+}  // namespace thunder
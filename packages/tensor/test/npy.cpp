@@ -0,0 +1,208 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/tensor.hpp"
+#include "thunder/tensor/npy.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+#include "thunder/test/temporary_file.hpp"
+
+namespace thunder {
+namespace {
+
+using test::temporaryFile;
+
+::std::string readFile(const ::std::string &path) {
+  ::std::ifstream stream(path, ::std::ios::binary);
+  return ::std::string(::std::istreambuf_iterator< char >(stream),
+                       ::std::istreambuf_iterator< char >());
+}
+
+template < typename T >
+T sequence(typename T::size_type n, typename T::size_type m) {
+  typedef typename T::value_type value_type;
+  T x(n, m);
+  value_type value = static_cast< value_type >(1);
+  for (typename T::reference_iterator begin = x.reference_begin(),
+           end = x.reference_end(); begin != end; ++begin) {
+    *begin = value;
+    value = value + static_cast< value_type >(1);
+  }
+  return x;
+}
+
+template < typename T >
+void expectEqual(const T &x, const T &y) {
+  ASSERT_EQ(x.dimension(), y.dimension());
+  for (typename T::dim_type i = 0; i < x.dimension(); ++i) {
+    EXPECT_EQ(x.size(i), y.size(i));
+  }
+  for (typename T::reference_iterator xb = x.reference_begin(),
+           yb = y.reference_begin(), xe = x.reference_end();
+       xb != xe; ++xb, ++yb) {
+    EXPECT_EQ(*xb, *yb);
+  }
+}
+
+TEST(NpyTest, roundTripTest) {
+  ::std::string path = temporaryFile();
+  DoubleTensor a = sequence< DoubleTensor >(3, 4);
+  saveNpy(path, a);
+  ::std::string bytes = readFile(path);
+  EXPECT_EQ(0, bytes.compare(0, 6, "\x93NUMPY"));
+  EXPECT_NE(::std::string::npos, bytes.find(
+      "{'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }"));
+  EXPECT_EQ(128 + 12 * sizeof(double), bytes.size());
+
+  NpyFile file(path);
+  EXPECT_EQ(128, file.entry().offset);
+  DoubleTensor b = file.get< DoubleTensor >();
+  EXPECT_TRUE(b.isContiguous());
+  expectEqual(a, b);
+  EXPECT_THROW(file.get< FloatTensor >(), invalid_argument);
+
+  FloatComplexTensor c = sequence< FloatComplexTensor >(5, 1);
+  saveNpy(path, c);
+  expectEqual(c, NpyFile(path).get< FloatComplexTensor >());
+  SizeTensor d = sequence< SizeTensor >(2, 7);
+  saveNpy(path, d);
+  expectEqual(d, NpyFile(path).get< SizeTensor >());
+  ::std::remove(path.c_str());
+}
+
+TEST(NpyTest, orderTest) {
+  ::std::string path = temporaryFile();
+  // The transpose is column-major and is written in Fortran order as it is
+  DoubleTensor t = sequence< DoubleTensor >(4, 3).transpose();
+  saveNpy(path, t);
+  EXPECT_NE(::std::string::npos, readFile(path).find(
+      "{'descr': '<f8', 'fortran_order': True, 'shape': (3, 4), }"));
+  DoubleTensor x = NpyFile(path).get< DoubleTensor >();
+  EXPECT_EQ(1, x.stride(0));
+  EXPECT_EQ(3, x.stride(1));
+  expectEqual(t, x);
+
+  // Other views are copied to C order
+  DoubleTensor v = sequence< DoubleTensor >(6, 5).narrow(1, 1, 3);
+  saveNpy(path, v);
+  DoubleTensor y = NpyFile(path).get< DoubleTensor >();
+  EXPECT_TRUE(y.isContiguous());
+  expectEqual(v, y);
+  ::std::remove(path.c_str());
+}
+
+TEST(NpyTest, numpyTest) {
+  ::std::string path = temporaryFile();
+  // Header as written by numpy, padded so that the data are not aligned for
+  // float and have to be copied
+  ::std::string header =
+      "{'descr': '<f4', 'fortran_order': True, 'shape': (2, 3), }";
+  header.resize(69 - 10, ' ');
+  header.push_back('\n');
+  ::std::string bytes = ::std::string("\x93NUMPY\x01\x00", 8);
+  bytes.push_back(static_cast< char >(header.size()));
+  bytes.push_back(0);
+  bytes += header;
+  float data[6] = {1, 4, 2, 5, 3, 6};
+  bytes.append(reinterpret_cast< const char* >(data), sizeof(data));
+  ::std::ofstream(path, ::std::ios::binary) << bytes;
+
+  NpyFile file(path);
+  EXPECT_EQ(70, file.entry().offset);
+  FloatTensor x = file.get< FloatTensor >();
+  ASSERT_EQ(2, x.dimension());
+  EXPECT_EQ(2, x.size(0));
+  EXPECT_EQ(3, x.size(1));
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(i * 3 + j + 1, x(i, j));
+    }
+  }
+
+  ::std::ofstream(path, ::std::ios::binary) << bytes.substr(0, 90);
+  EXPECT_THROW(NpyFile file(path), io_error);
+
+  // Sizes or products of sizes that overflow are rejected, not wrapped
+  for (const char *shape : {"(99999999999999999999999,)",
+                            "(4294967296, 4294967296)"}) {
+    ::std::string overflow = ::std::string(
+        "{'descr': '<f4', 'fortran_order': True, 'shape': ") + shape + ", }";
+    overflow.resize(header.size() - 1, ' ');
+    overflow.push_back('\n');
+    ::std::ofstream(path, ::std::ios::binary) <<
+        bytes.substr(0, 10) + overflow + bytes.substr(10 + header.size());
+    EXPECT_THROW(NpyFile file(path), io_error);
+  }
+  ::std::ofstream(path, ::std::ios::binary) << "not numpy";
+  EXPECT_THROW(NpyFile file(path), io_error);
+  ::std::remove(path.c_str());
+}
+
+TEST(NpyTest, npzTest) {
+  ::std::string path = temporaryFile();
+  DoubleTensor a = sequence< DoubleTensor >(7, 9);
+  FloatTensor b = sequence< FloatTensor >(3, 5);
+  DoubleComplexTensor c = sequence< DoubleComplexTensor >(4, 4);
+  DoubleTensor t = a.transpose();
+
+  NpzWriter writer;
+  writer.add("a", a);
+  writer.add("b", b);
+  writer.add("c", c);
+  writer.add("transposed", t);
+  EXPECT_THROW(writer.add("a", b), invalid_argument);
+  writer.save(path);
+  EXPECT_EQ(0, readFile(path).compare(0, 4, "PK\x03\x04"));
+
+  NpzFile file(path);
+  ASSERT_EQ(4, file.entries().size());
+  EXPECT_EQ("a", file.entries()[0].name);
+  EXPECT_TRUE(file.contains("transposed"));
+  EXPECT_FALSE(file.contains("a.npy"));
+  EXPECT_EQ(tensor::DataType::kFloat, file.entry("b").type);
+  expectEqual(a, file.get< DoubleTensor >("a"));
+  expectEqual(b, file.get< FloatTensor >("b"));
+  expectEqual(c, file.get< DoubleComplexTensor >("c"));
+  DoubleTensor x = file.get< DoubleTensor >("transposed");
+  EXPECT_EQ(1, x.stride(0));
+  expectEqual(t, x);
+
+  // Members are padded so that their data can be mapped in place
+  for (const tensor::TensorFileEntry &entry : file.entries()) {
+    EXPECT_EQ(0, entry.offset % 64);
+  }
+  EXPECT_THROW(file.get< DoubleTensor >("d"), out_of_range);
+
+  writer.clear();
+  writer.save(path);
+  EXPECT_EQ(0, NpzFile(path).entries().size());
+  ::std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace thunder
@@ -19,10 +19,14 @@
 
 #include "thunder/tensor.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "thunder/exception.hpp"
 #include "thunder/storage.hpp"
+#include "thunder/tensor/tensor-inl-iterator.hpp"
 
 namespace thunder {
 namespace {
@@ -371,5 +375,92 @@ TEST(TensorTest, iteratorTest) {
   iteratorTest< FloatComplexTensor >();
 }
 
+template < typename T >
+void sliceTest() {
+  T x(3, 5, 4);
+  for (typename T::size_type i = 0; i < x.length(); ++i) {
+    x.data()[i] = static_cast< typename T::value_type >(i);
+  }
+
+  // Slices along the first dimension match subtensors
+  int i = 0;
+  for (auto begin = x.slice_begin(), end = x.slice_end(); begin != end;
+       ++begin) {
+    EXPECT_EQ(2, begin->dimension());
+    EXPECT_EQ(5, begin->size(0));
+    EXPECT_EQ(4, begin->size(1));
+    EXPECT_EQ(4, begin->stride(0));
+    EXPECT_EQ(1, begin->stride(1));
+    EXPECT_EQ(20, begin->length());
+    EXPECT_EQ(x[i].data(), begin->data());
+    EXPECT_TRUE(begin->isContiguous());
+    EXPECT_EQ(x[i][2][3](), begin->select(2)[3]);
+    ++i;
+  }
+  EXPECT_EQ(3, i);
+
+  // Slices along a middle dimension are strided views
+  i = 0;
+  for (auto begin = T::slice_begin(x, 1), end = T::slice_end(x, 1);
+       begin != end; begin++) {
+    EXPECT_EQ(2, begin->dimension());
+    EXPECT_EQ(3, begin->size(0));
+    EXPECT_EQ(4, begin->size(1));
+    EXPECT_EQ(20, begin->stride(0));
+    EXPECT_EQ(1, begin->stride(1));
+    EXPECT_FALSE(begin->isContiguous());
+    EXPECT_EQ(x(2, i, 1), begin->select(2)[1]);
+    ++i;
+  }
+  EXPECT_EQ(5, i);
+
+  // Slices of a 1-D tensor are single elements
+  T y = x.view({60});
+  auto it = y.slice_begin();
+  EXPECT_EQ(0, it->dimension());
+  EXPECT_EQ(1, it->length());
+  EXPECT_EQ(y.data(), it->data());
+  ++it;
+  EXPECT_EQ(&y(1), &(*it)[0]);
+
+  // Parallel slices along the last dimension write disjoint columns
+  T z(300, 7);
+  z.parallelForEachSlice(1, [](const typename T::slice &s,
+                               typename T::size_type pos) {
+      for (typename T::size_type j = 0; j < s.size(0); ++j) {
+        s[j] = static_cast< typename T::value_type >(pos);
+      }
+    });
+  for (typename T::size_type j = 0; j < z.size(0); ++j) {
+    for (typename T::size_type k = 0; k < z.size(1); ++k) {
+      EXPECT_EQ(static_cast< typename T::value_type >(k), z(j, k));
+    }
+  }
+  EXPECT_THROW(z.slice_begin(2), out_of_range);
+}
+
+TEST(TensorTest, sliceTest) {
+  sliceTest< DoubleTensor >();
+  sliceTest< FloatTensor >();
+  sliceTest< DoubleComplexTensor >();
+  sliceTest< FloatComplexTensor >();
+}
+
+TEST(TensorTest, memoryTest) {
+  // Large tensors are listed in memory snapshots with their sizes
+  ::std::size_t threshold = storage::memoryTrackThreshold();
+  storage::setMemoryTrackThreshold(1024);
+  DoubleTensor t1(30, 40, 50);
+  t1.resize(50, 60, 70);
+  ::std::vector< storage::MemoryBlock > blocks = storage::memorySnapshot(1);
+  ASSERT_EQ(1, blocks.size());
+  EXPECT_EQ(t1.data(), blocks[0].data);
+  ASSERT_EQ(3, blocks[0].shape.size());
+  EXPECT_EQ(50, blocks[0].shape[0]);
+  EXPECT_EQ(60, blocks[0].shape[1]);
+  EXPECT_EQ(70, blocks[0].shape[2]);
+  storage::setMemoryTrackThreshold(threshold);
+}
+
 }  // namespace
 }  // namespace thunder
@@ -0,0 +1,124 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/tensor.hpp"
+
+#include <complex>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+
+namespace thunder {
+namespace {
+
+template < typename T >
+void appendTest() {
+  typedef typename T::value_type value_type;
+  TensorBuilder< T > builder({3, 2});
+  EXPECT_EQ(0, builder.rows());
+
+  // Append single rows and keep a view of the first ones
+  T row(3, 2);
+  for (int i = 0; i < 5; ++i) {
+    row.fill(static_cast< value_type >(i));
+    builder.append(row);
+  }
+  EXPECT_EQ(5, builder.rows());
+  T prefix = builder.tensor();
+  EXPECT_EQ(3, prefix.dimension());
+  EXPECT_EQ(5, prefix.size(0));
+  EXPECT_EQ(3, prefix.size(1));
+  EXPECT_EQ(2, prefix.size(2));
+
+  // Append many rows at once, growing the storage past the prefix
+  T rows(100, 3, 2);
+  for (typename T::reference_iterator begin = rows.reference_begin(),
+           end = rows.reference_end(); begin != end; ++begin) {
+    *begin = static_cast< value_type >(begin.position()[0] + 5);
+  }
+  builder.appendRows(rows);
+  EXPECT_EQ(105, builder.rows());
+  EXPECT_LE(105, builder.capacity());
+
+  // Earlier views remain valid and share the grown storage
+  T result = builder.tensor();
+  EXPECT_EQ(105, result.size(0));
+  EXPECT_EQ(result.data(), prefix.data());
+  for (typename T::reference_iterator begin = result.reference_begin(),
+           end = result.reference_end(); begin != end; ++begin) {
+    EXPECT_EQ(static_cast< value_type >(begin.position()[0]), *begin);
+  }
+  for (typename T::reference_iterator begin = prefix.reference_begin(),
+           end = prefix.reference_end(); begin != end; ++begin) {
+    EXPECT_EQ(static_cast< value_type >(begin.position()[0]), *begin);
+  }
+
+  // Rows of the wrong size are rejected
+  EXPECT_THROW(builder.append(T(2, 3)), invalid_argument);
+  EXPECT_THROW(builder.appendRows(T(4, 2, 2)), invalid_argument);
+  EXPECT_THROW(builder.append(static_cast< value_type >(0)),
+               invalid_argument);
+
+  builder.clear();
+  EXPECT_EQ(0, builder.rows());
+  EXPECT_THROW(builder.tensor(), invalid_argument);
+}
+
+TEST(TensorBuilderTest, appendTest) {
+  appendTest< DoubleTensor >();
+  appendTest< FloatTensor >();
+  appendTest< DoubleComplexTensor >();
+  appendTest< FloatComplexTensor >();
+}
+
+template < typename T >
+void appendScalarTest() {
+  typedef typename T::value_type value_type;
+  TensorBuilder< T > builder;
+  builder.reserve(16);
+  EXPECT_EQ(16, builder.capacity());
+  typename T::pointer data = builder.storage()->data();
+  for (int i = 0; i < 16; ++i) {
+    builder.append(static_cast< value_type >(i));
+  }
+  EXPECT_EQ(data, builder.storage()->data());
+  builder.append(static_cast< value_type >(16));
+  EXPECT_EQ(32, builder.capacity());
+  builder.shrinkToFit();
+  EXPECT_EQ(17, builder.capacity());
+
+  T result = builder.tensor();
+  EXPECT_EQ(1, result.dimension());
+  EXPECT_EQ(17, result.size(0));
+  for (int i = 0; i < 17; ++i) {
+    EXPECT_EQ(static_cast< value_type >(i), result(i));
+  }
+}
+
+TEST(TensorBuilderTest, appendScalarTest) {
+  appendScalarTest< DoubleTensor >();
+  appendScalarTest< FloatTensor >();
+  appendScalarTest< DoubleComplexTensor >();
+  appendScalarTest< FloatComplexTensor >();
+  appendScalarTest< SizeTensor >();
+}
+
+}  // namespace
+}  // namespace thunder
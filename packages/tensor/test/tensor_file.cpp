@@ -0,0 +1,290 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#include "thunder/tensor.hpp"
+#include "thunder/tensor/tensor_file.hpp"
+
+#include <unistd.h>
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "thunder/exception.hpp"
+#include "thunder/storage.hpp"
+#include "thunder/test/temporary_file.hpp"
+
+namespace thunder {
+namespace {
+
+using test::temporaryFile;
+
+template < typename T >
+T sequence(typename T::size_type n, typename T::size_type m) {
+  typedef typename T::value_type value_type;
+  T x(n, m);
+  value_type value = static_cast< value_type >(1);
+  for (typename T::reference_iterator begin = x.reference_begin(),
+           end = x.reference_end(); begin != end; ++begin) {
+    *begin = value;
+    value = value + static_cast< value_type >(1);
+  }
+  return x;
+}
+
+template < typename T >
+void expectEqual(const T &x, const T &y) {
+  ASSERT_EQ(x.dimension(), y.dimension());
+  for (typename T::dim_type i = 0; i < x.dimension(); ++i) {
+    EXPECT_EQ(x.size(i), y.size(i));
+  }
+  for (typename T::reference_iterator xb = x.reference_begin(),
+           yb = y.reference_begin(), xe = x.reference_end();
+       xb != xe; ++xb, ++yb) {
+    EXPECT_EQ(*xb, *yb);
+  }
+}
+
+TEST(TensorFileTest, roundTripTest) {
+  ::std::string path = temporaryFile();
+  DoubleTensor a = sequence< DoubleTensor >(7, 9);
+  FloatTensor b = sequence< FloatTensor >(3, 5);
+  DoubleComplexTensor c = sequence< DoubleComplexTensor >(4, 4);
+  FloatComplexTensor d = sequence< FloatComplexTensor >(2, 3);
+  SizeTensor e = sequence< SizeTensor >(5, 1);
+  DoubleTensor t = a.transpose();
+
+  TensorFileWriter writer;
+  writer.add("a", a);
+  writer.add("b", b);
+  writer.add("c", c);
+  writer.add("d", d);
+  writer.add("e", e);
+  writer.add("transposed", t);
+  EXPECT_THROW(writer.add("a", b), invalid_argument);
+  writer.save(path);
+
+  TensorFile file(path);
+  EXPECT_EQ(6, file.entries().size());
+  EXPECT_EQ("a", file.entries()[0].name);
+  EXPECT_TRUE(file.contains("transposed"));
+  EXPECT_FALSE(file.contains("f"));
+  EXPECT_EQ(tensor::DataType::kFloat, file.entry("b").type);
+  expectEqual(a, file.get< DoubleTensor >("a"));
+  expectEqual(b, file.get< FloatTensor >("b"));
+  expectEqual(c, file.get< DoubleComplexTensor >("c"));
+  expectEqual(d, file.get< FloatComplexTensor >("d"));
+  expectEqual(e, file.get< SizeTensor >("e"));
+  expectEqual(t, file.get< DoubleTensor >("transposed"));
+
+  // Data sections are aligned for vectorized access
+  for (const tensor::TensorFileEntry &entry : file.entries()) {
+    EXPECT_EQ(0, entry.offset % 64);
+  }
+  EXPECT_THROW(file.get< FloatTensor >("a"), invalid_argument);
+  EXPECT_THROW(file.get< DoubleTensor >("f"), out_of_range);
+  ::std::remove(path.c_str());
+}
+
+TEST(TensorFileTest, zeroCopyTest) {
+  ::std::string path = temporaryFile();
+  TensorFileWriter writer;
+  writer.add("x", sequence< DoubleTensor >(100, 10));
+  writer.add("y", sequence< DoubleTensor >(10, 100));
+  writer.save(path);
+
+  DoubleTensor x, y;
+  {
+    TensorFile file(path);
+    x = file.get< DoubleTensor >("x");
+    y = file.get< DoubleTensor >("y");
+    EXPECT_EQ(x.data(), file.get< DoubleTensor >("x").data());
+  }
+
+  // Tensors alias the mapping, which outlives the file object
+  EXPECT_EQ(0, reinterpret_cast< ::std::size_t >(x.data()) % 64);
+  EXPECT_EQ(0, reinterpret_cast< ::std::size_t >(y.data()) % 64);
+  EXPECT_EQ(1.0, x(0, 0));
+  EXPECT_EQ(1000.0, y(9, 99));
+
+  // Copy-on-write mappings, the default, can be changed without touching
+  // the file
+  {
+    TensorFile file(path, MapMode::kCopyOnWrite);
+    DoubleTensor z = file.get< DoubleTensor >("x");
+    z.fill(0.0);
+    TensorFile(path).get< DoubleTensor >("y").fill(0.0);
+  }
+  expectEqual(sequence< DoubleTensor >(10, 100),
+              TensorFile(path).get< DoubleTensor >("y"));
+  expectEqual(sequence< DoubleTensor >(100, 10),
+              TensorFile(path).get< DoubleTensor >("x"));
+  ::std::remove(path.c_str());
+}
+
+TEST(TensorFileTest, readTest) {
+  ::std::string path = temporaryFile();
+  DoubleTensor x(20, 30, 40);
+  double value = 0.0;
+  for (DoubleTensor::reference_iterator begin = x.reference_begin(),
+           end = x.reference_end(); begin != end; ++begin) {
+    *begin = value++;
+  }
+  TensorFileWriter writer;
+  writer.add("x", x);
+  writer.add("s", sequence< SizeTensor >(10, 10));
+  writer.save(path);
+
+  // Slices along every dimension read only their own elements
+  TensorFile file(path);
+  for (::std::size_t dim = 0; dim < 3; ++dim) {
+    DoubleTensor y = file.read< DoubleTensor >("x", dim, 3, 5);
+    EXPECT_TRUE(y.isContiguous());
+    expectEqual(x.narrow(dim, 3, 5), y);
+  }
+  expectEqual(x.narrow(0, 19, 1), file.read< DoubleTensor >("x", 0, 19, 1));
+  expectEqual(x, file.read< DoubleTensor >("x", 1, 0, 30));
+  expectEqual(sequence< SizeTensor >(10, 10).narrow(1, 9, 1),
+              file.read< SizeTensor >("s", 1, 9, 1));
+
+  EXPECT_THROW(file.read< DoubleTensor >("x", 3, 0, 1), out_of_range);
+  EXPECT_THROW(file.read< DoubleTensor >("x", 0, 15, 6), out_of_range);
+  EXPECT_THROW(file.read< DoubleTensor >("x", 0, 0, 0), out_of_range);
+  EXPECT_THROW(file.read< FloatTensor >("x", 0, 0, 1), invalid_argument);
+
+  // Reads stay on the opened file when a new one is renamed over it
+  TensorFileWriter other;
+  other.add("x", sequence< DoubleTensor >(2, 2));
+  other.saveAsync(path).wait();
+  expectEqual(x.narrow(0, 3, 5), file.read< DoubleTensor >("x", 0, 3, 5));
+  ::std::remove(path.c_str());
+}
+
+TEST(TensorFileTest, saveAsyncTest) {
+  ::std::string path = temporaryFile();
+  DoubleTensor x = sequence< DoubleTensor >(300, 200);
+  FloatComplexTensor y = sequence< FloatComplexTensor >(50, 70);
+  DoubleTensor t = x.transpose();
+  TensorFileWriter writer;
+  writer.add("x", x);
+  writer.add("y", y);
+  writer.add("t", t);
+
+  // Small staging buffers take many rounds of double buffering
+  TensorFileSave save = writer.saveAsync(path, 4096);
+  writer.clear();
+
+  // Snapshots do not see changes made while the save is running
+  x.fill(0.0);
+  y.fill(0.0f);
+  save.wait();
+  EXPECT_TRUE(save.done());
+  EXPECT_EQ(0.0, x(10, 10));
+  TensorFile file(path);
+  expectEqual(sequence< DoubleTensor >(300, 200),
+              file.get< DoubleTensor >("x"));
+  expectEqual(sequence< FloatComplexTensor >(50, 70),
+              file.get< FloatComplexTensor >("y"));
+  expectEqual(sequence< DoubleTensor >(300, 200).transpose(),
+              file.get< DoubleTensor >("t"));
+
+  // Files written in the background are the same as the ones written
+  // in the foreground
+  ::std::string other = temporaryFile();
+  TensorFileWriter same;
+  same.add("x", sequence< DoubleTensor >(300, 200));
+  same.save(other);
+  TensorFileSave same_save = same.saveAsync(path);
+  same_save.wait();
+  ::std::ifstream a(path, ::std::ios::binary), b(other, ::std::ios::binary);
+  ::std::string a_bytes((::std::istreambuf_iterator< char >(a)),
+                        ::std::istreambuf_iterator< char >());
+  ::std::string b_bytes((::std::istreambuf_iterator< char >(b)),
+                        ::std::istreambuf_iterator< char >());
+  EXPECT_EQ(b_bytes, a_bytes);
+  ::std::remove(path.c_str());
+  ::std::remove(other.c_str());
+}
+
+TEST(TensorFileTest, cancelTest) {
+  ::std::string path = temporaryFile();
+  ::std::remove(path.c_str());
+  TensorFileWriter writer;
+  writer.add("x", DoubleTensor(1024, 1024).fill(1.0));
+  TensorFileSave save = writer.saveAsync(path, 4096);
+  save.cancel();
+
+  // The save either stopped and left nothing behind, or had already finished
+  bool cancelled = false;
+  try {
+    save.wait();
+  } catch (const io_error &) {
+    cancelled = true;
+  }
+  EXPECT_TRUE(save.done());
+  EXPECT_NE(cancelled, ::std::ifstream(path).good());
+  EXPECT_FALSE(::std::ifstream(path + ".tmp").good());
+  ::std::remove(path.c_str());
+
+  // Empty handles are done
+  TensorFileSave empty;
+  empty.wait();
+  EXPECT_TRUE(empty.done());
+}
+
+TEST(TensorFileTest, corruptTest) {
+  ::std::string path = temporaryFile();
+  {
+    ::std::ofstream file(path, ::std::ios::binary);
+    file << "not a tensor file";
+  }
+  EXPECT_THROW(TensorFile file(path), io_error);
+
+  TensorFileWriter writer;
+  writer.add("x", sequence< DoubleTensor >(10, 10));
+  writer.save(path);
+
+  // Strides reaching past the data of the tensor are rejected
+  {
+    ::std::fstream file(path, ::std::ios::binary | ::std::ios::in |
+                        ::std::ios::out);
+    ::std::uint64_t table_offset = 0;
+    file.seekg(24);
+    file.read(reinterpret_cast< char* >(&table_offset), 8);
+    // Name length and name, data type, dimension and two sizes come first
+    ::std::int64_t stride = 1000;
+    file.seekp(static_cast< ::std::streamoff >(table_offset + 33));
+    file.write(reinterpret_cast< const char* >(&stride), 8);
+  }
+  EXPECT_THROW(TensorFile file(path), io_error);
+
+  writer.save(path);
+  truncate(path.c_str(), 256);
+  EXPECT_THROW(TensorFile file(path), io_error);
+  EXPECT_THROW(TensorFile file(path + ".missing"), io_error);
+  ::std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace thunder
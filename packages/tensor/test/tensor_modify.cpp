@@ -24,6 +24,7 @@
 
 #include "gtest/gtest.h"
 #include "thunder/exception.hpp"
+#include "thunder/parallel.hpp"
 #include "thunder/storage.hpp"
 
 namespace thunder {
@@ -102,6 +103,25 @@ void modifyTest() {
   // 2 because storage() call create a temporary
   EXPECT_EQ(2, tensor3.storage().use_count());
   EXPECT_EQ(2, tensor6.storage().use_count());
+
+  // Contiguous copies come from the current workspace and outlive its scope
+  Workspace workspace;
+  T tensor7(1);
+  tensor1.fill(static_cast< typename T::value_type >(7));
+  {
+    WorkspaceScope scope(&workspace);
+    tensor7 = tensor1.transpose(0, 2);
+    tensor7.contiguous();
+    EXPECT_EQ(tensor1.length() * sizeof(typename T::value_type),
+              workspace.used());
+  }
+  {
+    WorkspaceScope scope(&workspace);
+    T tensor8 = tensor1.transpose(1, 2);
+    tensor8.contiguous();
+    tensor8.fill(0);
+  }
+  EXPECT_EQ(static_cast< typename T::value_type >(7), tensor7(9, 7, 4));
 }
 
 TEST(TensorTest, modifyTest) {
@@ -193,6 +213,77 @@ TEST(TensorTest, extractTest) {
   extractTest< FloatComplexTensor >();
 }
 
+template < typename T >
+void maskedTest() {
+  // Large enough for the mask to be split into several parallel blocks
+  thunder::parallel::setThreads(4);
+  T t1(300, 400, 3);
+  int t1_val = 0;
+  for (typename T::reference_iterator begin = t1.reference_begin(),
+           end = t1.reference_end(); begin != end; ++begin) {
+    *begin = static_cast< typename T::value_type >(t1_val++ % 1000);
+  }
+  // A transposed view exercises the strided path
+  T t1_transposed = T::transpose(t1, 0, 1);
+
+  FloatTensor t2(400, 300);
+  int count = 0;
+  for (FloatTensor::size_type i = 0; i < 400; ++i) {
+    for (FloatTensor::size_type j = 0; j < 300; ++j) {
+      t2(i, j) = (i * 7 + j * 3) % 5 == 0 ? 1 : 0;
+      count += (i * 7 + j * 3) % 5 == 0 ? 1 : 0;
+    }
+  }
+  T t1_extracted = T::extract(t1_transposed, t2);
+  EXPECT_EQ(2, t1_extracted.dimension());
+  EXPECT_EQ(count, t1_extracted.size(0));
+  EXPECT_EQ(3, t1_extracted.size(1));
+  typename T::size_type pos = 0;
+  for (FloatTensor::size_type i = 0; i < 400; ++i) {
+    for (FloatTensor::size_type j = 0; j < 300; ++j) {
+      if (t2(i, j) == 1) {
+        for (typename T::size_type k = 0; k < 3; ++k) {
+          EXPECT_EQ(t1(j, i, k), t1_extracted(pos, k));
+        }
+        ++pos;
+      }
+    }
+  }
+
+  // Assigning back the extracted rows after filling restores the tensor
+  T t3 = T::maskedFill(t1_transposed, t2, 7);
+  T t4 = T::maskedAssign(t3, t2, t1_extracted);
+  for (FloatTensor::size_type i = 0; i < 400; ++i) {
+    for (FloatTensor::size_type j = 0; j < 300; ++j) {
+      for (typename T::size_type k = 0; k < 3; ++k) {
+        if (t2(i, j) == 1) {
+          EXPECT_EQ(static_cast< typename T::value_type >(7), t3(i, j, k));
+        } else {
+          EXPECT_EQ(t1(j, i, k), t3(i, j, k));
+        }
+        EXPECT_EQ(t1(j, i, k), t4(i, j, k));
+      }
+    }
+  }
+
+  // In-place fill of a strided view
+  T t5 = T::transpose(t1.clone(), 0, 1);
+  t5.maskedFill(t2, 0);
+  EXPECT_EQ(t5.sum(), T::maskedFill(t1_transposed, t2, 0).sum());
+
+  // Mismatched assignment sizes throw
+  T t6(count + 1, 3);
+  EXPECT_THROW(t5.maskedAssign(t2, t6), thunder::out_of_range);
+  thunder::parallel::setThreads(0);
+}
+
+TEST(TensorTest, maskedTest) {
+  maskedTest< DoubleTensor >();
+  maskedTest< FloatTensor >();
+  maskedTest< DoubleComplexTensor >();
+  maskedTest< FloatComplexTensor >();
+}
+
 template < typename T >
 void shuffleTest() {
   T t1(10, 20, 7);
@@ -406,6 +497,45 @@ void reshapeTest() {
   EXPECT_EQ(7, t1_reshaped_5.size(3));
   EXPECT_EQ(2, t1_reshaped_5.size(4));
   EXPECT_EQ(t1.storage(), t1_reshaped_5.storage());
+
+  // Splitting and merging dimensions of a transposed tensor needs no copy
+  T t2 = T::transpose(t1, 0, 2);
+  bool copied = true;
+  T t2_reshaped_1 = T::reshape(t2, {7, 2, 10, 10}, &copied);
+  EXPECT_FALSE(copied);
+  EXPECT_EQ(t1.storage(), t2_reshaped_1.storage());
+  for (typename T::size_type i = 0; i < 7; ++i) {
+    for (typename T::size_type j = 0; j < 2; ++j) {
+      for (typename T::size_type k = 0; k < 10; ++k) {
+        for (typename T::size_type l = 0; l < 10; ++l) {
+          EXPECT_EQ(t2(i, j * 10 + k, l), t2_reshaped_1(i, j, k, l));
+        }
+      }
+    }
+  }
+  T t3 = T::narrow(T::transpose(t1, 0, 1), 2, 0, 6);
+  T t3_reshaped_1 = T::reshape(t3, {20, 1, 10, 3, 2, 1});
+  EXPECT_EQ(t1.storage(), t3_reshaped_1.storage());
+  for (typename T::size_type i = 0; i < 20; ++i) {
+    for (typename T::size_type j = 0; j < 10; ++j) {
+      for (typename T::size_type k = 0; k < 6; ++k) {
+        EXPECT_EQ(t3(i, j, k), t3_reshaped_1({i, 0, j, k / 2, k % 2, 0}));
+      }
+    }
+  }
+
+  // Merging dimensions across the transposition requires a copy
+  EXPECT_THROW(T::reshape(t2, 1400), thunder::contiguity_error);
+  EXPECT_THROW(T::reshape(t2, 1401), thunder::out_of_range);
+  EXPECT_FALSE(t2.isReshapable({1400}));
+  T t2_reshaped_2 = T::reshape(t2, {1400}, &copied);
+  EXPECT_TRUE(copied);
+  EXPECT_NE(t1.storage(), t2_reshaped_2.storage());
+  typename T::size_type pos = 0;
+  for (typename T::reference_iterator begin = t2.reference_begin(),
+           end = t2.reference_end(); begin != end; ++begin) {
+    EXPECT_EQ(*begin, t2_reshaped_2(pos++));
+  }
 }
 
 TEST(TensorTest, reshapeTest) {
@@ -534,6 +664,57 @@ TEST(TensorTest, transformTest) {
   transformTest< FloatComplexTensor >();
 }
 
+template < typename T >
+void lazyCloneTest() {
+  T t1(3, 4, 5);
+  t1.fill(static_cast< typename T::value_type >(1));
+  T t1_view = t1.select(0, 1);
+
+  // Lazy clone shares the data until the first non-const operation
+  T t2 = t1.lazyClone();
+  EXPECT_EQ(t1.data(), t2.data());
+  EXPECT_NE(t1.storage(), t2.storage());
+  EXPECT_TRUE(t1.isShared());
+  EXPECT_TRUE(t2.isShared());
+  t2.add(static_cast< typename T::value_type >(2));
+  EXPECT_NE(t1.data(), t2.data());
+  EXPECT_FALSE(t2.isShared());
+  EXPECT_FALSE(t1.isShared());
+  for (typename T::reference_iterator begin = t1.reference_begin(),
+           end = t1.reference_end(); begin != end; ++begin) {
+    EXPECT_EQ(static_cast< typename T::value_type >(1), *begin);
+    EXPECT_EQ(static_cast< typename T::value_type >(3),
+              t2(begin.position()));
+  }
+
+  // Writing to the original through a view keeps the clone intact
+  T t3 = t1.lazyClone();
+  t1_view.fill(static_cast< typename T::value_type >(5));
+  EXPECT_NE(t1.data(), t3.data());
+  EXPECT_EQ(static_cast< typename T::value_type >(5), t1(1, 2, 3));
+  EXPECT_EQ(static_cast< typename T::value_type >(1), t3(1, 2, 3));
+
+  // Copy-on-write mode makes clone() lazy for tensors spanning the storage
+  tensor::setCopyOnWrite(true);
+  T t4 = t1.clone();
+  T t5 = t1_view.clone();
+  tensor::setCopyOnWrite(false);
+  EXPECT_EQ(t1.data(), t4.data());
+  EXPECT_TRUE(t4.isShared());
+  EXPECT_NE(t1_view.data(), t5.data());
+  EXPECT_FALSE(t5.isShared());
+  t4.unshare();
+  EXPECT_NE(t1.data(), t4.data());
+  EXPECT_EQ(t1(2, 3, 4), t4(2, 3, 4));
+}
+
+TEST(TensorTest, lazyCloneTest) {
+  lazyCloneTest< DoubleTensor >();
+  lazyCloneTest< FloatTensor >();
+  lazyCloneTest< DoubleComplexTensor >();
+  lazyCloneTest< FloatComplexTensor >();
+}
+
 template < typename T >
 void viewRealTest() {
   typedef typename T::real_tensor R;
@@ -20,10 +20,13 @@
 #include "thunder/tensor.hpp"
 
 #include <memory>
+#include <string>
 #include <typeinfo>
 
 #include "gtest/gtest.h"
 #include "thunder/serializer.hpp"
+#include "thunder/serializer/binary_protocol-inl.hpp"
+#include "thunder/serializer/serializer-inl.hpp"
 #include "thunder/storage.hpp"
 
 namespace thunder {
@@ -79,5 +82,91 @@ TEST(TensorTest, serializeTest) {
   serializeTest< FloatComplexTensor >();
 }
 
+template < typename T >
+void namedTest() {
+  typedef typename T::value_type value_type;
+  StringBinarySerializer s1;
+  for (int i = 0; i < 10; ++i) {
+    T t(3, 4);
+    t.fill(static_cast< value_type >(i));
+    s1.saveNamed("layer" + ::std::to_string(i), t);
+  }
+  s1.saveIndex();
+
+  // Records are read without loading the ones saved before them
+  StringBinarySerializer s2(s1.protocol().stream().str());
+  EXPECT_EQ(10, s2.names().size());
+  T t = s2.loadNamed< T >("layer7");
+  EXPECT_EQ(3, t.size(0));
+  EXPECT_EQ(4, t.size(1));
+  for (typename T::reference_iterator begin = t.reference_begin(),
+           end = t.reference_end(); begin != end; ++begin) {
+    EXPECT_EQ(static_cast< value_type >(7), *begin);
+  }
+  t = s2.loadNamed< T >("layer2");
+  EXPECT_EQ(static_cast< value_type >(2), t(1, 1));
+}
+
+TEST(TensorTest, namedTest) {
+  namedTest< DoubleTensor >();
+  namedTest< FloatComplexTensor >();
+}
+
+template < typename T >
+void compactTest() {
+  typedef typename T::value_type value_type;
+  T x(1000, 10);
+  int x_val = 0;
+  for (typename T::reference_iterator begin = x.reference_begin(),
+           end = x.reference_end(); begin != end; ++begin) {
+    *begin = static_cast< value_type >(x_val++);
+  }
+  T narrowed = x.narrow(0, 100, 10);
+  T transposed = narrowed.transpose();
+
+  StringBinarySerializer s1;
+  s1.save(narrowed);
+  StringBinarySerializer s2;
+  serializer::saveCompact(&s2, narrowed);
+  serializer::saveCompact(&s2, transposed);
+
+  // Only the elements of the views are written, and load as fresh tensors
+  EXPECT_GT(s1.protocol().stream().str().size(),
+            10 * s2.protocol().stream().str().size());
+  T y, z;
+  s2.load(&y);
+  s2.load(&z);
+  EXPECT_TRUE(y.isContiguous());
+  EXPECT_TRUE(z.isContiguous());
+  EXPECT_EQ(0, y.offset());
+  EXPECT_EQ(100, y.storage()->size());
+  EXPECT_NE(y.storage(), z.storage());
+  EXPECT_EQ(10, z.size(0));
+  EXPECT_EQ(10, z.size(1));
+  for (typename T::reference_iterator begin = narrowed.reference_begin(),
+           end = narrowed.reference_end(), y_begin = y.reference_begin();
+       begin != end; ++begin, ++y_begin) {
+    EXPECT_EQ(*begin, *y_begin);
+  }
+  for (typename T::reference_iterator begin = transposed.reference_begin(),
+           end = transposed.reference_end(), z_begin = z.reference_begin();
+       begin != end; ++begin, ++z_begin) {
+    EXPECT_EQ(*begin, *z_begin);
+  }
+
+  // Both kinds of records load with the same call
+  T w;
+  s1.load(&w);
+  EXPECT_EQ(x.storage()->size(), w.storage()->size());
+  EXPECT_EQ(narrowed.offset(), w.offset());
+}
+
+TEST(TensorTest, compactTest) {
+  compactTest< DoubleTensor >();
+  compactTest< FloatTensor >();
+  compactTest< DoubleComplexTensor >();
+  compactTest< SizeTensor >();
+}
+
 }  // namespace
 }  // namespace thunder
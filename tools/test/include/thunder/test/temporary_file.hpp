@@ -0,0 +1,45 @@
+/*
+ * \copyright Copyright 2014 Xiang Zhang All Rights Reserved.
+ * \license @{
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @}
+ */
+
+#ifndef THUNDER_TEST_TEMPORARY_FILE_HPP_
+#define THUNDER_TEST_TEMPORARY_FILE_HPP_
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+
+namespace thunder {
+namespace test {
+
+// Create an empty file with a unique name in /tmp and return its path. The
+// test removes it when done.
+inline ::std::string temporaryFile() {
+  char name[] = "/tmp/thunder_test_XXXXXX";
+  int fd = mkstemp(name);
+  if (fd >= 0) {
+    close(fd);
+  }
+  return name;
+}
+
+}  // namespace test
+}  // namespace thunder
+
+#endif  // THUNDER_TEST_TEMPORARY_FILE_HPP_